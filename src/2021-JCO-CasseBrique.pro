@@ -18,30 +18,71 @@ RC_ICONS = icon.ico
 #DEFINES += DEPLOY # Pour une compilation dans un but de déploiement
 
 SOURCES += main.cpp\
+    assetbundle.cpp \
+    assetloader.cpp \
+    autoplayer.cpp \
     ball.cpp \
+    brick.cpp \
+    camera.cpp \
+    endlessfield.cpp \
+    frameprofiler.cpp \
         mainfrm.cpp \
     gamescene.cpp \
     plate.cpp \
     sprite.cpp \
+    staticsprite.cpp \
     gamecore.cpp \
+    gameoptions.cpp \
+    levelgenerator.cpp \
+    levelreader.cpp \
+    loopscheduler.cpp \
+    memorymonitor.cpp \
+    profileroverlayitem.cpp \
     resources.cpp \
     gameview.cpp \
+    inputlatencymonitor.cpp \
+    inputlog.cpp \
     utilities.cpp \
     gamecanvas.cpp \
     spritetickhandler.cpp \
+    randomgenerator.cpp \
+    tickpipeline.cpp \
+    tickregistry.cpp \
+    tracewriter.cpp \
     bouncingspritehandler.cpp
 
 HEADERS  += mainfrm.h \
+    assetbundle.h \
+    assetloader.h \
+    autoplayer.h \
     ball.h \
+    brick.h \
+    camera.h \
+    endlessfield.h \
+    frameprofiler.h \
     gamescene.h \
     plate.h \
     sprite.h \
+    spritehandle.h \
+    staticsprite.h \
     gamecore.h \
+    gameoptions.h \
+    levelgenerator.h \
+    levelreader.h \
+    loopscheduler.h \
+    memorymonitor.h \
+    profileroverlayitem.h \
     resources.h \
     gameview.h \
+    inputlatencymonitor.h \
+    inputlog.h \
     utilities.h \
     gamecanvas.h \
     spritetickhandler.h \
+    randomgenerator.h \
+    tickpipeline.h \
+    tickregistry.h \
+    tracewriter.h \
     bouncingspritehandler.h
 
 FORMS    += mainfrm.ui
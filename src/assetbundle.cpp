@@ -0,0 +1,226 @@
+/**
+  \file
+  \brief    Définition de la classe AssetBundle.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "assetbundle.h"
+
+#include <cstring>
+
+#include <QDebug>
+#include <QDir>
+#include <QDirIterator>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QVector>
+
+//! Signature placée au début d'un paquet.
+const char BUNDLE_MAGIC[4] = { 'B', 'B', 'A', 'B' };
+//! Version du format de paquet.
+const quint32 BUNDLE_VERSION = 1;
+//! Marque permettant de vérifier que le paquet a été produit avec le même boutisme.
+const quint32 BUNDLE_BYTE_ORDER_MARK = 0x01020304;
+//! Alignement, en octets, des pixels de chaque image.
+const qint64 BUNDLE_DATA_ALIGNMENT = 16;
+//! Longueur maximale (en octets UTF-8, zéro final compris) du nom d'une image.
+const int BUNDLE_NAME_SIZE = 96;
+
+//! En-tête d'un paquet.
+struct BundleHeader
+{
+    char magic[4];
+    quint32 version;
+    quint32 byteOrderMark;
+    quint32 entryCount;
+};
+
+//! Entrée de l'index d'un paquet, qui décrit une image.
+struct AssetBundle::BundleEntry
+{
+    char name[BUNDLE_NAME_SIZE];
+    quint32 width;
+    quint32 height;
+    quint32 bytesPerLine;
+    quint32 reserved;
+    quint64 dataOffset;
+};
+
+//! \return la valeur donnée, arrondie au multiple d'alignement supérieur.
+static qint64 alignedOffset(qint64 offset) {
+    return (offset + BUNDLE_DATA_ALIGNMENT - 1) / BUNDLE_DATA_ALIGNMENT * BUNDLE_DATA_ALIGNMENT;
+}
+
+//! Construit un paquet fermé.
+AssetBundle::AssetBundle() {
+    m_pData = nullptr;
+    m_dataSize = 0;
+}
+
+//! Destructeur : ferme le paquet.
+AssetBundle::~AssetBundle() {
+    close();
+}
+
+//! Décode toutes les images du répertoire donné (et de ses sous-répertoires) et
+//! les écrit dans un paquet.
+//! \param rImagesPath      Répertoire des images.
+//! \param rBundleFileName  Chemin du paquet à écrire.
+//! \return vrai si le paquet a pu être écrit.
+bool AssetBundle::pack(const QString& rImagesPath, const QString& rBundleFileName) {
+    QDir imagesDir(rImagesPath);
+    QList<QByteArray> names;
+    QList<QImage> images;
+
+    QDirIterator it(imagesDir.absolutePath(), QStringList() << "*.png" << "*.jpg" << "*.jpeg",
+                    QDir::Files, QDirIterator::Subdirectories);
+    while (it.hasNext()) {
+        QString fileName = it.next();
+        QByteArray name = imagesDir.relativeFilePath(fileName).toUtf8();
+        if (name.size() >= BUNDLE_NAME_SIZE) {
+            qWarning() << "Nom d'image trop long pour le paquet :" << name;
+            return false;
+        }
+
+        QImageReader reader(fileName);
+        QImage image = reader.read();
+        if (image.isNull()) {
+            qWarning() << "Impossible de charger l'image" << fileName << ":" << reader.errorString();
+            return false;
+        }
+
+        names.append(name);
+        images.append(image.convertToFormat(QImage::Format_ARGB32_Premultiplied));
+    }
+
+    BundleHeader header;
+    std::memcpy(header.magic, BUNDLE_MAGIC, sizeof(header.magic));
+    header.version = BUNDLE_VERSION;
+    header.byteOrderMark = BUNDLE_BYTE_ORDER_MARK;
+    header.entryCount = quint32(images.count());
+
+    // Construction de l'index : les pixels de chaque image suivent l'index.
+    QVector<BundleEntry> entries(images.count());
+    qint64 offset = alignedOffset(sizeof(BundleHeader) + qint64(sizeof(BundleEntry)) * entries.count());
+    for (int i = 0; i < images.count(); ++i) {
+        BundleEntry& rEntry = entries[i];
+        std::memset(&rEntry, 0, sizeof(rEntry));
+        std::memcpy(rEntry.name, names[i].constData(), size_t(names[i].size()));
+        rEntry.width = quint32(images[i].width());
+        rEntry.height = quint32(images[i].height());
+        rEntry.bytesPerLine = quint32(images[i].bytesPerLine());
+        rEntry.dataOffset = quint64(offset);
+        offset = alignedOffset(offset + qint64(images[i].bytesPerLine()) * images[i].height());
+    }
+
+    QSaveFile file(rBundleFileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "Impossible d'écrire le paquet" << rBundleFileName << ":" << file.errorString();
+        return false;
+    }
+
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(entries.constData()), qint64(sizeof(BundleEntry)) * entries.count());
+    for (int i = 0; i < images.count(); ++i) {
+        file.write(QByteArray(int(qint64(entries[i].dataOffset) - file.pos()), '\0'));
+        file.write(reinterpret_cast<const char*>(images[i].constBits()), qint64(images[i].bytesPerLine()) * images[i].height());
+    }
+
+    if (!file.commit()) {
+        qWarning() << "Impossible d'écrire le paquet" << rBundleFileName << ":" << file.errorString();
+        return false;
+    }
+
+    qDebug() << images.count() << "images écrites dans le paquet" << rBundleFileName;
+    return true;
+}
+
+//! Ouvre le paquet donné et le projette en mémoire.
+//! \param rBundleFileName  Chemin du paquet.
+//! \return vrai si le paquet a pu être ouvert et que son contenu est valide.
+bool AssetBundle::open(const QString& rBundleFileName) {
+    close();
+
+    m_file.setFileName(rBundleFileName);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return false;
+
+    m_dataSize = m_file.size();
+    m_pData = m_file.map(0, m_dataSize);
+    if (m_pData == nullptr || m_dataSize < qint64(sizeof(BundleHeader))) {
+        qWarning() << "Impossible de projeter le paquet" << rBundleFileName << "en mémoire";
+        close();
+        return false;
+    }
+
+    const BundleHeader* pHeader = reinterpret_cast<const BundleHeader*>(m_pData);
+    if (std::memcmp(pHeader->magic, BUNDLE_MAGIC, sizeof(BUNDLE_MAGIC)) != 0
+            || pHeader->version != BUNDLE_VERSION
+            || pHeader->byteOrderMark != BUNDLE_BYTE_ORDER_MARK
+            || m_dataSize < qint64(sizeof(BundleHeader) + sizeof(BundleEntry) * pHeader->entryCount)) {
+        qWarning() << "Paquet invalide ou incompatible :" << rBundleFileName;
+        close();
+        return false;
+    }
+
+    const BundleEntry* pEntries = reinterpret_cast<const BundleEntry*>(m_pData + sizeof(BundleHeader));
+    for (quint32 i = 0; i < pHeader->entryCount; ++i) {
+        const BundleEntry* pEntry = &pEntries[i];
+        quint64 entrySize = quint64(pEntry->bytesPerLine) * pEntry->height;
+        if (pEntry->name[BUNDLE_NAME_SIZE - 1] != '\0'
+                || pEntry->bytesPerLine < pEntry->width * 4
+                || pEntry->dataOffset % BUNDLE_DATA_ALIGNMENT != 0
+                || pEntry->dataOffset + entrySize > quint64(m_dataSize)) {
+            qWarning() << "Paquet invalide ou incompatible :" << rBundleFileName;
+            close();
+            return false;
+        }
+        m_entries.insert(QString::fromUtf8(pEntry->name), pEntry);
+    }
+
+    return true;
+}
+
+//! Ferme le paquet. Les images retournées par image() ne doivent plus être utilisées.
+void AssetBundle::close() {
+    m_entries.clear();
+    if (m_pData != nullptr)
+        m_file.unmap(const_cast<uchar*>(m_pData));
+    m_pData = nullptr;
+    m_dataSize = 0;
+    m_file.close();
+}
+
+//! \return vrai si le paquet est ouvert.
+bool AssetBundle::isOpen() const {
+    return m_pData != nullptr;
+}
+
+//! \return vrai si le paquet contient l'image donnée.
+//! \param rImageName  Chemin de l'image, relatif au répertoire des images.
+bool AssetBundle::contains(const QString& rImageName) const {
+    return m_entries.contains(rImageName);
+}
+
+//! Construit une image qui utilise directement les pixels du paquet, sans copie.
+//! L'image est en lecture seule : la modifier en provoque une copie.
+//! \param rImageName  Chemin de l'image, relatif au répertoire des images.
+//! \return l'image, ou une image nulle si le paquet ne la contient pas.
+QImage AssetBundle::image(const QString& rImageName) const {
+    const BundleEntry* pEntry = m_entries.value(rImageName, nullptr);
+    if (pEntry == nullptr)
+        return QImage();
+
+    return QImage(m_pData + pEntry->dataOffset, int(pEntry->width), int(pEntry->height),
+                  int(pEntry->bytesPerLine), QImage::Format_ARGB32_Premultiplied);
+}
+
+//! \return les noms des images contenues dans le paquet.
+QStringList AssetBundle::imageNames() const {
+    return m_entries.keys();
+}
+
+//! \return la taille du fichier projeté en mémoire, en octets (0 si le paquet est fermé).
+qint64 AssetBundle::mappedSize() const {
+    return isOpen() ? m_dataSize : 0;
+}
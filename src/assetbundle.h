@@ -0,0 +1,65 @@
+/**
+  \file
+  \brief    Déclaration de la classe AssetBundle.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef ASSETBUNDLE_H
+#define ASSETBUNDLE_H
+
+#include <QFile>
+#include <QHash>
+#include <QImage>
+#include <QString>
+#include <QStringList>
+
+//! \brief Classe qui donne accès à un paquet d'images pré-décodées.
+//!
+//! Un paquet (fichier `images.bundle` du répertoire `res`) contient toutes les images
+//! du répertoire des images, déjà décodées au format ARGB32 prémultiplié. Il est
+//! produit hors ligne avec pack(), par exemple avec la commande :
+//!
+//!     2021-JCO-CasseBrique --pack-assets
+//!
+//! Le fichier est composé d'un en-tête, d'un index (une entrée par image) et des
+//! pixels de chaque image, alignés sur 16 octets :
+//! \verbatim
+//! +--------------+---------------------+----------+----------+-----
+//! | BundleHeader | BundleEntry x count | pixels 0 | pixels 1 | ...
+//! +--------------+---------------------+----------+----------+-----
+//! \endverbatim
+//!
+//! A l'exécution, open() projette le fichier en mémoire (QFile::map()). Les images
+//! retournées par image() utilisent directement la mémoire projetée : elles ne sont
+//! ni copiées, ni décodées. Le paquet doit donc rester ouvert tant que ces images
+//! sont utilisées.
+//!
+//! Les pixels sont stockés dans l'ordre des octets de la machine qui a produit le
+//! paquet. Un paquet produit sur une machine d'un autre boutisme est refusé.
+class AssetBundle
+{
+public:
+    AssetBundle();
+    ~AssetBundle();
+
+    static bool pack(const QString& rImagesPath, const QString& rBundleFileName);
+
+    bool open(const QString& rBundleFileName);
+    void close();
+    bool isOpen() const;
+
+    bool contains(const QString& rImageName) const;
+    QImage image(const QString& rImageName) const;
+    QStringList imageNames() const;
+    qint64 mappedSize() const;
+
+private:
+    struct BundleEntry;
+
+    QFile m_file;
+    const uchar* m_pData;
+    qint64 m_dataSize;
+    QHash<QString, const BundleEntry*> m_entries;
+};
+
+#endif // ASSETBUNDLE_H
@@ -0,0 +1,229 @@
+/**
+  \file
+  \brief    Définition de la classe AssetLoader.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "assetloader.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMetaObject>
+#include <QRunnable>
+
+#include "frameprofiler.h"
+#include "resources.h"
+#include "tracewriter.h"
+
+AssetLoader* AssetLoader::s_pInstance = nullptr;
+
+//! \brief Tâche de décodage d'une image, exécutée sur un thread du QThreadPool.
+//!
+//! Une fois l'image décodée, elle est transmise à AssetLoader::onImageDecoded(), qui
+//! est exécutée sur le thread de l'AssetLoader (connexion en file d'attente).
+class ImageDecodeTask : public QRunnable
+{
+public:
+    ImageDecodeTask(AssetLoader* pLoader, const QString& rImageName)
+        : m_pLoader(pLoader), m_imageName(rImageName), m_imagePath(BrickBreaker::imagePath(rImageName)) { }
+
+    void run() {
+        QImage image = AssetLoader::decodeImage(m_imagePath);
+        QMetaObject::invokeMethod(m_pLoader, "onImageDecoded", Qt::QueuedConnection,
+                                  Q_ARG(QString, m_imageName), Q_ARG(QImage, image));
+    }
+
+private:
+    AssetLoader* m_pLoader;
+    QString m_imageName;
+    QString m_imagePath; // Construit sur le thread principal, seul à accéder au localisateur de ressources.
+};
+
+//! Construit le chargeur d'images.
+//! La première instance construite devient l'instance retournée par instance().
+//! \param pParent  Objet parent.
+AssetLoader::AssetLoader(QObject* pParent) : QObject(pParent) {
+    m_loadedCount = 0;
+    m_totalCount = 0;
+
+    if (s_pInstance == nullptr)
+        s_pInstance = this;
+
+    if (m_bundle.open(bundleFileName()))
+        qDebug() << "Paquet d'images ouvert :" << m_bundle.imageNames().count() << "images";
+}
+
+//! Destructeur : attend la fin des décodages en cours.
+AssetLoader::~AssetLoader() {
+    m_threadPool.waitForDone();
+
+    if (s_pInstance == this)
+        s_pInstance = nullptr;
+}
+
+//! \return l'instance du chargeur d'images. Si aucune instance n'existe, elle est créée
+//! et appartient à l'application.
+AssetLoader* AssetLoader::instance() {
+    if (s_pInstance == nullptr)
+        new AssetLoader(qApp);
+
+    return s_pInstance;
+}
+
+//! Démarre le chargement en arrière-plan des images données.
+//! Les images déjà présentes dans le cache ne sont pas rechargées.
+//! Les images introuvables sont signalées une seule fois, ici, puis remplacées
+//! par une image vide.
+//! \param rImageNames  Chemins des images, relatifs au répertoire des images.
+void AssetLoader::load(const QStringList& rImageNames) {
+    if (isFinished())
+        m_loadingTimer.start();
+
+    for (const QString& rImageName : rImageNames) {
+        m_totalCount++;
+        if (m_pixmaps.contains(rImageName)) {
+            m_loadedCount++;
+            continue;
+        }
+
+        // Les images du paquet sont déjà décodées : inutile de passer par un thread.
+        if (m_bundle.contains(rImageName)) {
+            m_pixmaps.insert(rImageName, QPixmap::fromImage(m_bundle.image(rImageName)));
+            m_loadedCount++;
+            continue;
+        }
+
+        if (!QFileInfo::exists(BrickBreaker::imagePath(rImageName))) {
+            qWarning() << "Image introuvable :" << BrickBreaker::imagePath(rImageName);
+            m_pixmaps.insert(rImageName, QPixmap());
+            m_loadedCount++;
+            continue;
+        }
+
+        m_threadPool.start(new ImageDecodeTask(this, rImageName));
+    }
+
+    emit progressChanged(m_loadedCount, m_totalCount);
+    if (isFinished())
+        emit finished();
+}
+
+//! Bloque jusqu'à ce que toutes les images demandées soient chargées.
+//! Utile lorsqu'aucune boucle d'événements ne tourne.
+void AssetLoader::waitForFinished() {
+    m_threadPool.waitForDone();
+    QCoreApplication::sendPostedEvents(this, QEvent::MetaCall);
+}
+
+//! \return vrai si toutes les images demandées ont été chargées.
+bool AssetLoader::isFinished() const {
+    return m_loadedCount == m_totalCount;
+}
+
+//! \return le nombre d'images déjà chargées.
+int AssetLoader::loadedCount() const {
+    return m_loadedCount;
+}
+
+//! \return le nombre d'images demandées.
+int AssetLoader::totalCount() const {
+    return m_totalCount;
+}
+
+//! \return l'image demandée, sous forme de QPixmap. Si elle n'est pas dans le cache, elle
+//! est chargée immédiatement.
+//! \param rImageName  Chemin de l'image, relatif au répertoire des images.
+QPixmap AssetLoader::pixmap(const QString& rImageName) {
+    auto it = m_pixmaps.constFind(rImageName);
+    if (it != m_pixmaps.constEnd())
+        return it.value();
+
+    QPixmap pixmap = QPixmap::fromImage(m_bundle.contains(rImageName) ? m_bundle.image(rImageName)
+                                                                      : decodeImage(BrickBreaker::imagePath(rImageName)));
+    m_pixmaps.insert(rImageName, pixmap);
+    return pixmap;
+}
+
+//! \return l'image demandée, sous forme de QImage. Si elle fait partie du paquet,
+//! l'image retournée utilise directement la mémoire du paquet, sans copie. Sinon, elle
+//! est conservée dans le cache des QImage : une image déjà chargée en QPixmap n'est
+//! convertie qu'une fois, une image absente des caches est décodée directement.
+//! \param rImageName  Chemin de l'image, relatif au répertoire des images.
+QImage AssetLoader::image(const QString& rImageName) {
+    if (m_bundle.contains(rImageName))
+        return m_bundle.image(rImageName);
+
+    auto it = m_images.constFind(rImageName);
+    if (it != m_images.constEnd())
+        return it.value();
+
+    auto pixmapIt = m_pixmaps.constFind(rImageName);
+    QImage image = pixmapIt != m_pixmaps.constEnd() ? pixmapIt.value().toImage()
+                                                    : decodeImage(BrickBreaker::imagePath(rImageName));
+    m_images.insert(rImageName, image);
+    return image;
+}
+
+//! \return la taille des pixels de chaque image des caches, en octets, par nom d'image.
+//! Une image présente dans les deux caches compte pour la somme de ses deux tailles.
+QMap<QString, qint64> AssetLoader::pixmapSizes() const {
+    QMap<QString, qint64> sizes;
+    for (auto it = m_pixmaps.constBegin(); it != m_pixmaps.constEnd(); ++it)
+        sizes.insert(it.key(), qint64(it.value().width()) * it.value().height() * it.value().depth() / 8);
+    for (auto it = m_images.constBegin(); it != m_images.constEnd(); ++it)
+        sizes[it.key()] += it.value().sizeInBytes();
+    return sizes;
+}
+
+//! \return la taille du paquet d'images projeté en mémoire, en octets (0 sans paquet).
+qint64 AssetLoader::bundleSize() const {
+    return m_bundle.mappedSize();
+}
+
+//! Décode l'image donnée dans un format prêt à être affiché (ARGB32 prémultiplié
+//! ou RGB32 si l'image est opaque).
+//! Cette fonction peut être appelée depuis n'importe quel thread.
+//! \param rImagePath  Chemin absolu de l'image.
+//! \return l'image décodée, ou une image nulle si elle n'a pas pu être lue.
+QImage AssetLoader::decodeImage(const QString& rImagePath) {
+    TraceWriter* pTraceWriter = TraceWriter::instance();
+    const qint64 decodeStart = pTraceWriter ? FrameProfiler::instance().now() : 0;
+
+    QImageReader reader(rImagePath);
+    QImage image = reader.read();
+    if (image.isNull()) {
+        qWarning() << "Impossible de charger l'image" << rImagePath << ":" << reader.errorString();
+        return image;
+    }
+
+    image = image.convertToFormat(image.hasAlphaChannel() ? QImage::Format_ARGB32_Premultiplied : QImage::Format_RGB32);
+
+    if (pTraceWriter)
+        pTraceWriter->addCompleteEvent("AssetLoader::decodeImage", "asset", decodeStart,
+                                       FrameProfiler::instance().now() - decodeStart, QFileInfo(rImagePath).fileName());
+    return image;
+}
+
+//! \return le chemin du paquet d'images pré-décodées.
+QString AssetLoader::bundleFileName() {
+    return BrickBreaker::resourcesPath() + "images.bundle";
+}
+
+//! Une image a été décodée : elle est convertie en QPixmap et placée dans le cache.
+//! \param rImageName  Chemin de l'image, relatif au répertoire des images.
+//! \param rImage      Image décodée.
+void AssetLoader::onImageDecoded(const QString& rImageName, const QImage& rImage) {
+    // L'image a pu entre-temps être chargée de façon synchrone par pixmap().
+    if (!m_pixmaps.contains(rImageName))
+        m_pixmaps.insert(rImageName, QPixmap::fromImage(rImage));
+
+    m_loadedCount++;
+    emit progressChanged(m_loadedCount, m_totalCount);
+
+    if (isFinished()) {
+        qDebug() << "Images chargées en" << m_loadingTimer.elapsed() << "ms";
+        emit finished();
+    }
+}
@@ -0,0 +1,90 @@
+/**
+  \file
+  \brief    Déclaration de la classe AssetLoader.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef ASSETLOADER_H
+#define ASSETLOADER_H
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QImage>
+#include <QMap>
+#include <QObject>
+#include <QPixmap>
+#include <QStringList>
+#include <QThreadPool>
+
+#include "assetbundle.h"
+
+//! \brief Classe qui charge les images du jeu en arrière-plan et les conserve en cache.
+//!
+//! La méthode load() décode les images demandées en parallèle, sur les threads d'un
+//! QThreadPool. Chaque image décodée (QImage) est ensuite convertie en QPixmap sur le
+//! thread de l'interface graphique, seul autorisé à manipuler des QPixmap, puis placée
+//! dans le cache.
+//!
+//! Les images sont désignées par leur chemin relatif au répertoire des images
+//! (par exemple "ball.png" ou "GameUI/start.png").
+//!
+//! Le signal progressChanged() est émis après chaque image chargée, le signal
+//! finished() une fois toutes les images chargées.
+//!
+//! La méthode pixmap() retourne l'image du cache. Si elle n'a pas (encore) été chargée,
+//! elle est décodée immédiatement, de façon synchrone. La méthode image() fait de même
+//! avec un cache de QImage : une image absente des deux caches est décodée directement
+//! en QImage, sans passer par un QPixmap.
+//!
+//! Si le paquet d'images pré-décodées (voir AssetBundle) est présent dans le répertoire
+//! `res`, les images qu'il contient sont lues directement depuis ce paquet, sans
+//! décodage ni thread. Les autres images sont décodées normalement.
+//!
+//! Une instance unique est accessible avec instance().
+class AssetLoader : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AssetLoader(QObject* pParent = nullptr);
+    ~AssetLoader();
+
+    static AssetLoader* instance();
+
+    void load(const QStringList& rImageNames);
+    void waitForFinished();
+
+    bool isFinished() const;
+    int loadedCount() const;
+    int totalCount() const;
+
+    QPixmap pixmap(const QString& rImageName);
+    QImage image(const QString& rImageName);
+
+    QMap<QString, qint64> pixmapSizes() const;
+    qint64 bundleSize() const;
+
+    static QImage decodeImage(const QString& rImagePath);
+    static QString bundleFileName();
+
+signals:
+    void progressChanged(int loadedCount, int totalCount);
+    void finished();
+
+private slots:
+    void onImageDecoded(const QString& rImageName, const QImage& rImage);
+
+private:
+    static AssetLoader* s_pInstance;
+
+    AssetBundle m_bundle;
+    QThreadPool m_threadPool;
+    QHash<QString, QPixmap> m_pixmaps;
+    QHash<QString, QImage> m_images;
+    QElapsedTimer m_loadingTimer;
+
+    int m_loadedCount;
+    int m_totalCount;
+};
+
+#endif // ASSETLOADER_H
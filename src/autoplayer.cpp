@@ -0,0 +1,144 @@
+/**
+  \file
+  \brief    Définition de la classe AutoPlayer.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "autoplayer.h"
+
+#include <cmath>
+
+#include "ball.h"
+#include "gamescene.h"
+#include "staticsprite.h"
+
+// Initialisation des constantes.
+const qreal MAX_AIM_OFFSET = 0.6;   // Décalage maximal visé, en fraction de la demi-largeur du plateau.
+
+//! Construit un joueur automatique.
+//! \param seed  Graine des décalages visés.
+AutoPlayer::AutoPlayer(quint64 seed) : m_random(seed) {
+    m_aimOffset = 0;
+    m_wasDescending = false;
+    m_gameTime = 0;
+    m_totalGameTime = 0;
+    m_winCount = 0;
+    m_lossCount = 0;
+    m_abandonedCount = 0;
+}
+
+//! Calcule la position de souris qui place le plateau sous la balle suivie.
+//! \param pScene  Scène de jeu.
+//! \param pPlate  Plateau de la scène.
+//! \return la position à transmettre comme déplacement de la souris.
+QPointF AutoPlayer::mousePosition(GameScene* pScene, const StaticSprite* pPlate) {
+    const qreal plateCenterX = pPlate->left() + pPlate->width() / 2.0;
+
+    // Balle suivie : la première à atteindre le plateau ou, si aucune ne descend, la plus basse.
+    Ball* pTrackedBall = nullptr;
+    qreal trackedBallTime = 0;
+    bool isDescending = false;
+    for (StaticSprite* pSprite : pScene->sprites(StaticSprite::CategoryBall)) {
+        Ball* pBall = static_cast<Ball*>(pSprite);
+        const qreal velocityY = pBall->getSpriteVelocity().y();
+
+        if (velocityY > 0 && pBall->bottom() <= pPlate->top()) {
+            const qreal time = (pPlate->top() - pBall->bottom()) / velocityY;
+            if (!isDescending || time < trackedBallTime) {
+                pTrackedBall = pBall;
+                trackedBallTime = time;
+                isDescending = true;
+            }
+        } else if (!isDescending && (pTrackedBall == nullptr || pBall->bottom() > pTrackedBall->bottom())) {
+            pTrackedBall = pBall;
+        }
+    }
+
+    if (pTrackedBall == nullptr)
+        return QPointF(plateCenterX, pPlate->top());
+
+    // Nouveau décalage à chaque descente, afin de varier l'angle du rebond sur le plateau.
+    if (isDescending && !m_wasDescending)
+        m_aimOffset = (m_random.uniform() * 2 - 1) * MAX_AIM_OFFSET;
+    m_wasDescending = isDescending;
+
+    const QRectF ballRect = pTrackedBall->globalBoundingBox();
+    qreal targetX = ballRect.center().x();
+    if (isDescending)
+        targetX = landingX(ballRect, pTrackedBall->getSpriteVelocity(), pPlate->top(), 0, pScene->width());
+
+    return QPointF(targetX - m_aimOffset * pPlate->width() / 2.0, pPlate->top());
+}
+
+//! Prédit la position horizontale du centre de la balle lorsque son bas atteindra
+//! la hauteur donnée, en tenant compte des rebonds sur les bords verticaux.
+//! \param rBallRect  Rectangle de la balle, dans la scène.
+//! \param rVelocity  Vitesse de la balle, en pixels par seconde. Sa composante verticale doit être positive.
+//! \param landingY   Hauteur à atteindre.
+//! \param minX       Bord gauche de la zone de rebond.
+//! \param maxX       Bord droit de la zone de rebond.
+//! \return la position horizontale prédite.
+qreal AutoPlayer::landingX(const QRectF& rBallRect, const QPointF& rVelocity, qreal landingY, qreal minX, qreal maxX) {
+    const qreal time = (landingY - rBallRect.bottom()) / rVelocity.y();
+
+    // Le centre de la balle reste à une demi-largeur des bords.
+    const qreal low = minX + rBallRect.width() / 2.0;
+    const qreal span = (maxX - rBallRect.width() / 2.0) - low;
+    if (span <= 0)
+        return low;
+
+    // Les rebonds reviennent à replier la trajectoire dans la zone : la position est
+    // périodique, de période deux fois la largeur de la zone.
+    qreal offset = std::fmod(rBallRect.center().x() + rVelocity.x() * time - low, 2 * span);
+    if (offset < 0)
+        offset += 2 * span;
+    if (offset > span)
+        offset = 2 * span - offset;
+
+    return low + offset;
+}
+
+//! Ajoute du temps de jeu à la partie en cours.
+//! \param elapsedTimeInMilliseconds  Temps de simulation écoulé.
+void AutoPlayer::addGameTime(long long elapsedTimeInMilliseconds) {
+    m_gameTime += elapsedTimeInMilliseconds;
+}
+
+//! \return le temps de jeu de la partie en cours, en ms.
+long long AutoPlayer::gameTime() const {
+    return m_gameTime;
+}
+
+//! Comptabilise la partie en cours, terminée.
+//! \param isWon  Vrai si la partie est gagnée.
+void AutoPlayer::gameFinished(bool isWon) {
+    if (isWon)
+        m_winCount++;
+    else
+        m_lossCount++;
+
+    m_totalGameTime += m_gameTime;
+    m_gameTime = 0;
+    m_wasDescending = false;
+}
+
+//! Comptabilise la partie en cours, abandonnée parce qu'elle durait trop longtemps.
+void AutoPlayer::gameAbandoned() {
+    m_abandonedCount++;
+    m_totalGameTime += m_gameTime;
+    m_gameTime = 0;
+    m_wasDescending = false;
+}
+
+//! \return le nombre de parties terminées ou abandonnées.
+int AutoPlayer::gameCount() const {
+    return m_winCount + m_lossCount + m_abandonedCount;
+}
+
+//! \return un résumé des parties jouées.
+QString AutoPlayer::summary() const {
+    const int count = gameCount();
+    return QString("Parties jouées : %1 (gagnées %2, perdues %3, abandonnées %4), durée moyenne : %5 s")
+           .arg(count).arg(m_winCount).arg(m_lossCount).arg(m_abandonedCount)
+           .arg(count > 0 ? m_totalGameTime / 1000.0 / count : 0.0, 0, 'f', 1);
+}
@@ -0,0 +1,64 @@
+/**
+  \file
+  \brief    Déclaration de la classe AutoPlayer.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef AUTOPLAYER_H
+#define AUTOPLAYER_H
+
+#include <QPointF>
+#include <QRectF>
+#include <QString>
+
+#include "randomgenerator.h"
+
+class GameScene;
+class StaticSprite;
+
+//! \brief Classe qui joue à la place du joueur (option `--autoplay`).
+//!
+//! A chaque tick, mousePosition() calcule la position de souris qui place le plateau
+//! sous la balle : GameCore la transmet comme un déplacement de la souris (voir
+//! Plate::onMouseMoved()). La balle suivie est celle qui atteindra le plateau la
+//! première ; son point de chute est prédit depuis sa position et sa vitesse, en
+//! tenant compte des rebonds sur les bords de la scène (landingX()). Les briques qui
+//! dévient la balle ne sont pas prises en compte : la prédiction est refaite à chaque
+//! tick.
+//!
+//! Le plateau ne vise pas exactement le centre de la balle : un décalage tiré au hasard
+//! à chaque descente de la balle fait varier l'angle du rebond, afin que la balle ne
+//! reste pas bloquée sur une même trajectoire. Pour une même graine, les parties
+//! jouées sont identiques.
+//!
+//! AutoPlayer compte aussi les parties terminées (gameFinished()), afin de résumer une
+//! longue session de jeu automatique (summary()).
+class AutoPlayer
+{
+public:
+    explicit AutoPlayer(quint64 seed);
+
+    QPointF mousePosition(GameScene* pScene, const StaticSprite* pPlate);
+    static qreal landingX(const QRectF& rBallRect, const QPointF& rVelocity, qreal landingY, qreal minX, qreal maxX);
+
+    void addGameTime(long long elapsedTimeInMilliseconds);
+    long long gameTime() const;
+    void gameFinished(bool isWon);
+    void gameAbandoned();
+
+    int gameCount() const;
+    QString summary() const;
+
+private:
+    RandomGenerator m_random;
+    qreal m_aimOffset;          // Décalage visé, en fraction de la demi-largeur du plateau.
+    bool m_wasDescending;
+
+    long long m_gameTime;       // Temps de jeu de la partie en cours, en ms.
+    long long m_totalGameTime;
+    int m_winCount;
+    int m_lossCount;
+    int m_abandonedCount;
+};
+
+#endif // AUTOPLAYER_H
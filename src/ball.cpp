@@ -6,8 +6,9 @@
 */
 #include "ball.h"
 
+#include "assetloader.h"
+#include "brick.h"
 #include "gamescene.h"
-#include "resources.h"
 #include "sprite.h"
 #include "utilities.h"
 
@@ -22,8 +23,8 @@ const int INITIAL_VELOCITY_X = 0;
 const int INITIAL_VELOCITY_Y = 200;
 
 //! Constructeur
-Ball::Ball(QGraphicsItem* pParent) : Sprite(BrickBreaker::imagesPath() + "ball.png", pParent) {
-    this->setData(0, "ball");
+Ball::Ball(QGraphicsItem* pParent) : Sprite(AssetLoader::instance()->pixmap("ball.png"), pParent) {
+    this->setCategory(CategoryBall);
     this->setScale(0.05);
     setSpriteVelocity(INITIAL_VELOCITY_X, INITIAL_VELOCITY_Y);
     m_spriteVelocityX = INITIAL_VELOCITY_X;
@@ -64,7 +65,7 @@ void Ball::tick(long long elapsedTimeInMilliseconds) {
 
     if (!collidingSprites.isEmpty()) {
         // On ne considère que la première collision (au cas où il y en aurait plusieurs)
-        Sprite* pCollidingSprite = collidingSprites[0];
+        StaticSprite* pCollidingSprite = collidingSprites[0];
 
         m_spriteVelocityX = m_spriteVelocity.x();
         m_spriteVelocityY = m_spriteVelocity.y();
@@ -84,8 +85,8 @@ void Ball::tick(long long elapsedTimeInMilliseconds) {
 
         for(int i = 0; i < collidingSprites.size(); i++) {
             // Test si le sprite en collision est le plateau, si oui : la vélocité est modifiée d'après l'emplacement de la colision.
-            if (collidingSprites.at(i)->data(0).toString() == "plate") {
-                Sprite* plate = collidingSprites.at(i);
+            if (collidingSprites.at(i)->category() == CategoryPlate) {
+                StaticSprite* plate = collidingSprites.at(i);
 
                 double angle = 0;
                 double percent = ((100.0 / (plate->width() / 2)) * ((this->left() + (this->width() / 2)) - (plate->left() + (plate->width() / 2))));
@@ -98,9 +99,12 @@ void Ball::tick(long long elapsedTimeInMilliseconds) {
                 m_spriteVelocityX += ballHitLeft ? (ballHitLeft ? -angle : angle) : (ballHitLeft ? -angle : angle);
                 m_spriteVelocity.setX(m_spriteVelocityX);
 
-            // Test si le sprite en collision est une brique, si oui : elle est détruite.
-            } else if (collidingSprites.at(i)->data(0).toString() == "brick" && collidingSprites.at(i)->data(1).toString() != "unbreakable") {
-                collidingSprites.at(i)->deleteLater();
+            // Test si le sprite en collision est une brique, si oui : elle perd un point
+            // de vie et est détruite si elle n'en a plus.
+            } else if (collidingSprites.at(i)->category() == CategoryBrick) {
+                Brick* pBrick = static_cast<Brick*>(collidingSprites.at(i));
+                if (pBrick->hit())
+                    this->parentScene()->destroySpriteLater(pBrick);
                 m_spriteVelocityY *= 1.05;
             }
         }
@@ -115,17 +119,13 @@ void Ball::tick(long long elapsedTimeInMilliseconds) {
 
     // Test si la balle est à l'intérieur de la zone de jeux, si non : elle est détruite.
     if (!this->parentScene()->isInsideScene(nextSpriteRect) && collidingSprites.isEmpty()) {
-        this->deleteLater();
+        this->parentScene()->destroySpriteLater(this);
     }
 
     this->setPos(this->pos() + spriteMovement);
 }
 
-void Ball::onResumeTick() {
-    this->registerForTick();
+//! \return la taille estimée de la balle en mémoire, en octets.
+qint64 Ball::estimatedSize() const {
+    return Sprite::estimatedSize() + qint64(sizeof(Ball) - sizeof(Sprite));
 }
-
-void Ball::onPauseTick() {
-    this->unregisterFromTick();
-}
-
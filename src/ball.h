@@ -26,16 +26,13 @@ public:
     Ball(QGraphicsItem* pParent = nullptr);
 
     void tick(long long elapsedTimeInMilliseconds);
+    virtual qint64 estimatedSize() const;
 
     void setSpriteVelocity(QPointF spriteVelocity);
     void setSpriteVelocity(double xVelocity, double yVelocity);
 
     QPointF getSpriteVelocity();
 
-public slots:
-    void onResumeTick();
-    void onPauseTick();
-
 private:
     QPointF m_spriteVelocity;
     QPointF m_spriteMovement;
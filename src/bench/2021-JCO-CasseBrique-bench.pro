@@ -0,0 +1,36 @@
+#-------------------------------------------------
+#
+# Mesures de performance des chemins de collision, de cadence et de dessin
+# (voir scenebench.cpp). Projet séparé du jeu : il compile les sources du jeu,
+# sauf main.cpp et la fenêtre principale, avec son propre point d'entrée.
+#
+#-------------------------------------------------
+
+QT       += core gui svg
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+TARGET = 2021-JCO-CasseBrique-bench
+TEMPLATE = app
+CONFIG += console
+CONFIG -= app_bundle
+
+# Les mesures n'ont de sens qu'avec une compilation optimisée.
+CONFIG += release
+CONFIG -= debug
+
+INCLUDEPATH += ..
+
+GAME_SOURCES = $$files(../*.cpp)
+GAME_SOURCES -= ../main.cpp ../mainfrm.cpp ../gamecore_blank.cpp
+GAME_HEADERS = $$files(../*.h)
+GAME_HEADERS -= ../mainfrm.h ../gamecore_blank.h
+
+SOURCES += scenebench.cpp \
+    benchmark.cpp \
+    benchmarkreport.cpp \
+    $$GAME_SOURCES
+
+HEADERS += benchmark.h \
+    benchmarkreport.h \
+    $$GAME_HEADERS
@@ -0,0 +1,151 @@
+/**
+  \file
+  \brief    Définition de la classe Benchmark.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+#include <QElapsedTimer>
+#include <QVector>
+
+// Initialisation des constantes.
+const qint64 NS_PER_MS = 1000000;
+const long long MAX_BATCH_SIZE = 1LL << 30;
+
+// Nombre d'allocations faites par le processus depuis son démarrage.
+static std::atomic<long long> s_allocationCount(0);
+
+#if defined(__GLIBC__)
+// Avec la glibc, malloc() est remplacé : les allocations des conteneurs de Qt, qui
+// n'utilisent pas l'opérateur new, sont ainsi aussi comptées.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* pMemory, size_t size);
+
+void* malloc(size_t size) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* pMemory, size_t size) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    return __libc_realloc(pMemory, size);
+}
+}
+#else
+// Ailleurs, seules les allocations faites avec l'opérateur new sont comptées : les
+// tableaux des conteneurs de Qt (QList, QVector), alloués avec malloc(), ne le sont pas
+// et le nombre d'allocations par opération est sous-estimé.
+void* operator new(std::size_t size) {
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    void* pMemory = std::malloc(size ? size : 1);
+    if (pMemory == nullptr)
+        throw std::bad_alloc();
+    return pMemory;
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* pMemory) noexcept {
+    std::free(pMemory);
+}
+
+void operator delete[](void* pMemory) noexcept {
+    std::free(pMemory);
+}
+#endif
+
+//! Construit un banc de mesure.
+//! \param minTimeInMilliseconds  Durée minimale de la mesure d'une opération, tous échantillons confondus.
+//! \param sampleCount            Nombre d'échantillons dont la médiane est retenue.
+Benchmark::Benchmark(qint64 minTimeInMilliseconds, int sampleCount) {
+    m_minTime = qMax(qint64(1), minTimeInMilliseconds) * NS_PER_MS;
+    m_sampleCount = qMax(1, sampleCount);
+}
+
+//! Mesure une opération.
+//! \param rName       Nom de l'opération.
+//! \param size        Taille du problème, reportée dans le résultat.
+//! \param rOperation  Opération à mesurer.
+//! \return la durée médiane et le nombre moyen d'allocations d'une opération.
+Benchmark::Result Benchmark::run(const QString& rName, int size, const std::function<void()>& rOperation) const {
+    QElapsedTimer timer;
+
+    // Taille de lot telle qu'un échantillon dure au moins sa part du temps minimal.
+    const qint64 sampleTime = m_minTime / m_sampleCount;
+    long long batchSize = 1;
+    forever {
+        timer.start();
+        for (long long i = 0; i < batchSize; ++i)
+            rOperation();
+        if (timer.nsecsElapsed() >= sampleTime || batchSize >= MAX_BATCH_SIZE)
+            break;
+        batchSize *= 2;
+    }
+
+    // Le tableau des échantillons est alloué avant le comptage, afin que son
+    // agrandissement ne soit pas compté avec l'opération mesurée.
+    QVector<double> samples;
+    samples.reserve(m_sampleCount);
+    const long long allocationsBefore = allocationCount();
+    for (int sample = 0; sample < m_sampleCount; ++sample) {
+        timer.start();
+        for (long long i = 0; i < batchSize; ++i)
+            rOperation();
+        samples.append(double(timer.nsecsElapsed()) / batchSize);
+    }
+    const long long allocations = allocationCount() - allocationsBefore;
+
+    std::sort(samples.begin(), samples.end());
+
+    Result result;
+    result.name = rName;
+    result.size = size;
+    result.nsPerOp = samples[samples.count() / 2];
+
+    // Ecart absolu médian : médiane des écarts entre chaque échantillon et la médiane.
+    QVector<double> deviations;
+    for (double sample : samples)
+        deviations.append(std::abs(sample - result.nsPerOp));
+    std::sort(deviations.begin(), deviations.end());
+    result.madNs = deviations[deviations.count() / 2];
+
+    result.operationCount = batchSize * m_sampleCount;
+    result.allocationsPerOp = double(allocations) / result.operationCount;
+    return result;
+}
+
+//! Ecrit l'en-tête du tableau des résultats sur la sortie standard.
+void Benchmark::printHeader() {
+    std::printf("%-34s %8s %14s %10s %12s %12s\n", "benchmark", "size", "ns/op", "mad", "allocs/op", "ops");
+    std::fflush(stdout);
+}
+
+//! Ecrit un résultat sur la sortie standard.
+//! \param rResult  Résultat à écrire.
+void Benchmark::print(const Result& rResult) {
+    std::printf("%-34s %8d %14.1f %10.1f %12.2f %12lld\n", qPrintable(rResult.name), rResult.size, rResult.nsPerOp,
+                rResult.madNs, rResult.allocationsPerOp, rResult.operationCount);
+    std::fflush(stdout);
+}
+
+//! \return le nombre d'allocations faites par le processus depuis son démarrage.
+long long Benchmark::allocationCount() {
+    return s_allocationCount.load(std::memory_order_relaxed);
+}
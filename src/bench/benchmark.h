@@ -0,0 +1,54 @@
+/**
+  \file
+  \brief    Déclaration de la classe Benchmark.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include <functional>
+
+#include <QString>
+
+//! \brief Classe qui mesure la durée et le nombre d'allocations d'une opération.
+//!
+//! La méthode run() répète l'opération par lots : la taille d'un lot est d'abord
+//! doublée jusqu'à ce qu'un lot dure au moins une fraction du temps minimal, puis
+//! plusieurs lots (échantillons) sont mesurés. La durée retenue est la médiane des
+//! échantillons, moins sensible qu'une moyenne aux interruptions du système. La
+//! dispersion des échantillons est donnée par leur écart absolu médian (MAD).
+//!
+//! Les allocations sont comptées en remplaçant l'allocateur de l'exécutable (malloc
+//! sur les systèmes qui utilisent la glibc, l'opérateur new ailleurs) : voir
+//! allocationCount(). Le compte n'est complet qu'avec la glibc (Linux) : ailleurs, les
+//! allocations des conteneurs de Qt, faites avec malloc(), ne sont pas comptées.
+class Benchmark
+{
+public:
+    //! Résultat d'une mesure.
+    struct Result
+    {
+        QString name;               //!< Nom de l'opération mesurée.
+        int size = 0;               //!< Taille du problème (nombre de briques...).
+        double nsPerOp = 0;         //!< Durée médiane d'une opération, en ns.
+        double madNs = 0;           //!< Ecart absolu médian des échantillons, en ns.
+        double allocationsPerOp = 0;//!< Nombre moyen d'allocations par opération.
+        long long operationCount = 0;   //!< Nombre total d'opérations mesurées.
+    };
+
+    Benchmark(qint64 minTimeInMilliseconds, int sampleCount);
+
+    Result run(const QString& rName, int size, const std::function<void()>& rOperation) const;
+
+    static void printHeader();
+    static void print(const Result& rResult);
+
+    static long long allocationCount();
+
+private:
+    qint64 m_minTime;   // ns
+    int m_sampleCount;
+};
+
+#endif // BENCHMARK_H
@@ -0,0 +1,216 @@
+/**
+  \file
+  \brief    Définition de la classe BenchmarkReport.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "benchmarkreport.h"
+
+#include <cstdio>
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+#include <QVariant>
+
+// Initialisation des constantes.
+const double NOISE_FACTOR = 3.0;            // Nombre d'écarts absolus médians tolérés en plus de la tolérance.
+const double ALLOCATION_MARGIN = 0.05;      // Marge absolue sur le nombre d'allocations par opération.
+
+//! Ajoute un résultat au rapport.
+//! \param rResult  Résultat d'une mesure.
+void BenchmarkReport::add(const Benchmark::Result& rResult) {
+    m_results.append(rResult);
+}
+
+//! \return les résultats du rapport, dans l'ordre de leur ajout.
+const QVector<Benchmark::Result>& BenchmarkReport::results() const {
+    return m_results;
+}
+
+//! Change les paramètres de la série de mesures (nombre de balles, tailles, etc.).
+//! \param rParameters  Paramètres, sous forme de paires nom-valeur.
+void BenchmarkReport::setParameters(const QJsonObject& rParameters) {
+    m_parameters = rParameters;
+}
+
+//! \return les paramètres de la série de mesures.
+const QJsonObject& BenchmarkReport::parameters() const {
+    return m_parameters;
+}
+
+//! Enregistre le rapport au format JSON.
+//! \param rFileName  Nom du fichier.
+//! \return faux si le fichier ne peut pas être écrit (voir errorString()).
+bool BenchmarkReport::save(const QString& rFileName) {
+    QJsonArray benchmarks;
+    for (const Benchmark::Result& rResult : m_results) {
+        QJsonObject benchmark;
+        benchmark["name"] = rResult.name;
+        benchmark["size"] = rResult.size;
+        benchmark["nsPerOp"] = rResult.nsPerOp;
+        benchmark["madNs"] = rResult.madNs;
+        benchmark["allocationsPerOp"] = rResult.allocationsPerOp;
+        benchmark["operations"] = double(rResult.operationCount);
+        benchmarks.append(benchmark);
+    }
+
+    QJsonObject root;
+    root["parameters"] = m_parameters;
+    root["benchmarks"] = benchmarks;
+
+    QSaveFile file(rFileName);
+    if (!file.open(QIODevice::WriteOnly))
+        return setError(file.errorString());
+
+    file.write(QJsonDocument(root).toJson());
+    if (!file.commit())
+        return setError(file.errorString());
+
+    return true;
+}
+
+//! Lit un rapport enregistré au format JSON. Les résultats lus remplacent ceux du rapport.
+//! \param rFileName  Nom du fichier.
+//! \return faux si le fichier ne peut pas être lu ou n'est pas un rapport (voir errorString()).
+bool BenchmarkReport::load(const QString& rFileName) {
+    QFile file(rFileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return setError(file.errorString());
+
+    QJsonParseError parseError;
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (parseError.error != QJsonParseError::NoError)
+        return setError(QString("%1 : %2").arg(rFileName, parseError.errorString()));
+    if (!document.isObject() || !document.object()["benchmarks"].isArray())
+        return setError(QString("%1 n'est pas un rapport de mesures.").arg(rFileName));
+
+    m_parameters = document.object()["parameters"].toObject();
+    m_results.clear();
+    for (const QJsonValue& rValue : document.object()["benchmarks"].toArray()) {
+        const QJsonObject benchmark = rValue.toObject();
+        Benchmark::Result result;
+        result.name = benchmark["name"].toString();
+        result.size = benchmark["size"].toInt();
+        result.nsPerOp = benchmark["nsPerOp"].toDouble();
+        result.madNs = benchmark["madNs"].toDouble();
+        result.allocationsPerOp = benchmark["allocationsPerOp"].toDouble();
+        result.operationCount = (long long)benchmark["operations"].toDouble();
+        m_results.append(result);
+    }
+
+    return true;
+}
+
+//! \return la description de la dernière erreur.
+QString BenchmarkReport::errorString() const {
+    return m_errorString;
+}
+
+//! \return les paramètres qui diffèrent entre ce rapport et le rapport de référence, sous
+//! la forme « nom : valeur de référence / valeur du rapport ». Les rapports ne sont
+//! comparables que si la liste est vide.
+QStringList BenchmarkReport::parameterDifferences(const BenchmarkReport& rBaseline) const {
+    QStringList names = m_parameters.keys() + rBaseline.m_parameters.keys();
+    names.removeDuplicates();
+    names.sort();
+
+    QStringList differences;
+    for (const QString& rName : names) {
+        const QJsonValue value = m_parameters.value(rName);
+        const QJsonValue baselineValue = rBaseline.m_parameters.value(rName);
+        if (value != baselineValue)
+            differences << QString("%1 : %2 / %3").arg(rName, toText(baselineValue), toText(value));
+    }
+    return differences;
+}
+
+//! Compare les résultats du rapport à ceux d'un rapport de référence, et écrit la
+//! comparaison sur la sortie standard. Les paramètres des deux rapports doivent être
+//! identiques (voir parameterDifferences()).
+//! \param rBaseline     Rapport de référence.
+//! \param tolerance     Augmentation tolérée, en fraction de la référence (0.1 : 10 %).
+//! \param allowMissing  Vrai si une mesure de la référence absente du rapport n'est pas
+//!                      une régression.
+//! \return le nombre de mesures qui régressent.
+int BenchmarkReport::compare(const BenchmarkReport& rBaseline, double tolerance, bool allowMissing) const {
+    int regressionCount = 0;
+
+    std::printf("%-34s %8s %14s %14s %9s %12s %12s  %s\n", "benchmark", "size", "baseline ns", "ns/op", "change",
+                "base allocs", "allocs/op", "verdict");
+    for (const Benchmark::Result& rResult : m_results) {
+        const Benchmark::Result* pBaseline = rBaseline.find(rResult.name, rResult.size);
+        if (pBaseline == nullptr) {
+            std::printf("%-34s %8d %14s %14.1f %9s %12s %12.2f  nouvelle mesure\n", qPrintable(rResult.name),
+                        rResult.size, "-", rResult.nsPerOp, "-", "-", rResult.allocationsPerOp);
+            continue;
+        }
+
+        const double maxNs = pBaseline->nsPerOp * (1 + tolerance) + NOISE_FACTOR * (pBaseline->madNs + rResult.madNs);
+        const double maxAllocations = pBaseline->allocationsPerOp * (1 + tolerance) + ALLOCATION_MARGIN;
+        const bool isSlower = rResult.nsPerOp > maxNs;
+        const bool allocatesMore = rResult.allocationsPerOp > maxAllocations;
+        const double change = pBaseline->nsPerOp > 0 ? (rResult.nsPerOp / pBaseline->nsPerOp - 1) * 100 : 0;
+
+        const char* pVerdict = "ok";
+        if (isSlower && allocatesMore)
+            pVerdict = "REGRESSION (durée, allocations)";
+        else if (isSlower)
+            pVerdict = "REGRESSION (durée)";
+        else if (allocatesMore)
+            pVerdict = "REGRESSION (allocations)";
+
+        if (isSlower || allocatesMore)
+            regressionCount++;
+
+        std::printf("%-34s %8d %14.1f %14.1f %+8.1f%% %12.2f %12.2f  %s\n", qPrintable(rResult.name), rResult.size,
+                    pBaseline->nsPerOp, rResult.nsPerOp, change, pBaseline->allocationsPerOp, rResult.allocationsPerOp,
+                    pVerdict);
+    }
+
+    for (const Benchmark::Result& rBaselineResult : rBaseline.m_results) {
+        if (find(rBaselineResult.name, rBaselineResult.size) != nullptr)
+            continue;
+
+        std::printf("%-34s %8d  %s\n", qPrintable(rBaselineResult.name), rBaselineResult.size,
+                    allowMissing ? "mesure absente de ce rapport" : "REGRESSION (mesure absente)");
+        if (!allowMissing)
+            regressionCount++;
+    }
+
+    std::printf("%d régression(s), tolérance %.0f %%\n", regressionCount, tolerance * 100);
+    std::fflush(stdout);
+    return regressionCount;
+}
+
+//! \return le résultat de nom et de taille donnés, ou nullptr s'il n'est pas dans le rapport.
+const Benchmark::Result* BenchmarkReport::find(const QString& rName, int size) const {
+    for (const Benchmark::Result& rResult : m_results) {
+        if (rResult.name == rName && rResult.size == size)
+            return &rResult;
+    }
+    return nullptr;
+}
+
+//! \return la valeur JSON donnée, sous forme de texte compact ("-" si elle est absente).
+QString BenchmarkReport::toText(const QJsonValue& rValue) {
+    if (rValue.isUndefined())
+        return "-";
+    if (rValue.isString())
+        return rValue.toString();
+    if (rValue.isArray()) {
+        QStringList items;
+        for (const QJsonValue& rItem : rValue.toArray())
+            items << toText(rItem);
+        return items.join(',');
+    }
+    return rValue.toVariant().toString();
+}
+
+//! Mémorise la description d'une erreur.
+//! \return toujours faux, afin de pouvoir écrire `return setError(...)`.
+bool BenchmarkReport::setError(const QString& rErrorString) {
+    m_errorString = rErrorString;
+    return false;
+}
@@ -0,0 +1,64 @@
+/**
+  \file
+  \brief    Déclaration de la classe BenchmarkReport.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "benchmark.h"
+
+//! \brief Classe qui regroupe les résultats d'une série de mesures, afin de les comparer
+//! à une référence (baseline).
+//!
+//! Les résultats sont enregistrés au format JSON (save()) :
+//!
+//!     { "parameters": { "balls": 10, "samples": 5, ... },
+//!       "benchmarks": [ { "name": "Ball::tick", "size": 1000, "nsPerOp": 812.4,
+//!                         "madNs": 6.1, "allocationsPerOp": 0.0, "operations": 655360 }, ... ] }
+//!
+//! Les paramètres de la série de mesures (setParameters()) sont enregistrés avec les
+//! résultats : deux rapports ne sont comparables que s'ils ont les mêmes paramètres
+//! (voir parameterDifferences()).
+//!
+//! La méthode compare() compare chaque mesure à la mesure de même nom et de même taille
+//! d'un rapport de référence, lu avec load(). Une mesure régresse si :
+//! - sa durée dépasse celle de la référence de plus de la tolérance donnée, augmentée du
+//!   bruit des deux mesures (NOISE_FACTOR fois la somme de leurs écarts absolus médians) ;
+//! - ou si son nombre d'allocations par opération dépasse celui de la référence de plus
+//!   de la tolérance (avec une marge absolue, les petites valeurs étant des moyennes).
+//! Une mesure absente de la référence est signalée, sans être une régression. Une mesure
+//! de la référence absente du rapport est une régression, sauf si elle est explicitement
+//! permise.
+class BenchmarkReport
+{
+public:
+    void add(const Benchmark::Result& rResult);
+    const QVector<Benchmark::Result>& results() const;
+    void setParameters(const QJsonObject& rParameters);
+    const QJsonObject& parameters() const;
+
+    bool save(const QString& rFileName);
+    bool load(const QString& rFileName);
+    QString errorString() const;
+
+    QStringList parameterDifferences(const BenchmarkReport& rBaseline) const;
+    int compare(const BenchmarkReport& rBaseline, double tolerance, bool allowMissing) const;
+
+private:
+    const Benchmark::Result* find(const QString& rName, int size) const;
+    static QString toText(const QJsonValue& rValue);
+    bool setError(const QString& rErrorString);
+
+    QVector<Benchmark::Result> m_results;
+    QJsonObject m_parameters;
+    QString m_errorString;
+};
+
+#endif // BENCHMARKREPORT_H
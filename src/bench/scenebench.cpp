@@ -0,0 +1,353 @@
+/**
+  \file
+  \brief    Mesures de performance des chemins de collision, de cadence et de dessin.
+  \author   CHENGAE
+  \date     Décembre 2021
+
+  Programme indépendant du jeu (voir 2021-JCO-CasseBrique-bench.pro), qui construit des
+  scènes synthétiques de N briques et M balles et mesure, pour chaque valeur de N :
+  - GameScene::collidingSprites() avec un rectangle et avec une forme ;
+  - Ball::tick() et Plate::tick() ;
+  - GameScene::tick(), qui cadence toutes les balles ;
+  - GameScene::sprites() ;
+  - le dessin d'une image de la taille de l'écran de référence, hors écran.
+
+  Chaque mesure donne la durée médiane d'une opération (ns/op) et le nombre moyen
+  d'allocations par opération (voir Benchmark ; ce nombre n'est complet que sous Linux). Exemple :
+
+      2021-JCO-CasseBrique-bench --sizes 100,1000,10000 --balls 20
+
+  Les briques sont incassables, afin que la scène ne change pas durant la mesure.
+  Les images sont générées : les mesures ne dépendent pas du répertoire `res`.
+
+  Contrôle des régressions (voir BenchmarkReport) : `--json <fichier>` enregistre les
+  résultats au format JSON, `--baseline <fichier>` les compare à des résultats de
+  référence enregistrés de la même façon. Le programme se termine alors avec le code 1
+  si une mesure régresse au-delà de la tolérance (`--tolerance`, en %), ou si une mesure
+  de la référence n'a pas été faite (sauf avec `--allow-missing`). Les paramètres des
+  mesures (tailles, balles, durée, échantillons, filtre) sont enregistrés avec les
+  résultats : la comparaison est refusée (code 2) s'ils diffèrent de ceux de la
+  référence. Avec `--compare <fichier>`, des résultats déjà enregistrés sont comparés à
+  la référence, sans rien mesurer :
+
+      2021-JCO-CasseBrique-bench --json baseline.json
+      2021-JCO-CasseBrique-bench --baseline baseline.json --tolerance 15
+      2021-JCO-CasseBrique-bench --compare current.json --baseline baseline.json
+*/
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDebug>
+#include <QImage>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPixmap>
+#include <QStringList>
+#include <QVector>
+
+#include <cstdio>
+
+#include "../ball.h"
+#include "../brick.h"
+#include "../gamecanvas.h"
+#include "../gamescene.h"
+#include "../gameview.h"
+#include "../plate.h"
+#include "../randomgenerator.h"
+#include "benchmark.h"
+#include "benchmarkreport.h"
+
+// Initialisation des constantes.
+const int BRICK_COLUMNS = 40;
+const int BRICK_WIDTH = 60;
+const int BRICK_HEIGHT = 20;
+const int BRICK_SPACING = 5;
+const int BRICKS_TOP = 100;
+const int PLAY_AREA_HEIGHT = 500;
+const int WALL_SIZE = 20;
+const int BALL_PIXMAP_SIZE = 400;   // Ball réduit son image à 5 % : la balle mesure 20 pixels.
+const int PLATE_WIDTH = 100;
+const int PLATE_HEIGHT = 15;
+const int QUERY_SIZE = 20;          // Taille des rectangles et formes recherchés.
+const int QUERY_COUNT = 1024;       // Nombre de positions de recherche précalculées.
+const int TICK_ELAPSED = 10;        // Temps transmis aux cadences, en ms.
+const QSize FRAME_SIZE(1280, 720);
+
+//! \return une image unie de la taille donnée.
+static QPixmap filledPixmap(int width, int height, const QColor& rColor) {
+    QPixmap pixmap(width, height);
+    pixmap.fill(rColor);
+    return pixmap;
+}
+
+//! \brief Scène synthétique : des briques incassables en haut, des balles et un plateau en
+//! bas, le tout entouré de murs.
+struct BenchScene
+{
+    GameScene* pScene = nullptr;
+    QVector<Ball*> balls;
+    Plate* pPlate = nullptr;
+    QVector<QRectF> queryRects;
+    QVector<QPainterPath> queryShapes;
+};
+
+//! Construit une scène synthétique.
+//! \param pCanvas     Canvas qui crée la scène.
+//! \param brickCount  Nombre de briques.
+//! \param ballCount   Nombre de balles.
+//! \return la scène construite.
+static BenchScene createBenchScene(GameCanvas* pCanvas, int brickCount, int ballCount) {
+    const int rowCount = (brickCount + BRICK_COLUMNS - 1) / BRICK_COLUMNS;
+    const int width = BRICK_COLUMNS * (BRICK_WIDTH + BRICK_SPACING) + 2 * WALL_SIZE;
+    const int height = BRICKS_TOP + rowCount * BRICK_HEIGHT + PLAY_AREA_HEIGHT;
+
+    BenchScene benchScene;
+    benchScene.pScene = pCanvas->createScene(0, 0, width, height);
+    GameScene* pScene = benchScene.pScene;
+
+    StaticSprite* pWalls[] = {
+        new StaticSprite(filledPixmap(width, WALL_SIZE, Qt::gray)),
+        new StaticSprite(filledPixmap(width, WALL_SIZE, Qt::gray)),
+        new StaticSprite(filledPixmap(WALL_SIZE, height, Qt::gray)),
+        new StaticSprite(filledPixmap(WALL_SIZE, height, Qt::gray))
+    };
+    const QPointF wallPositions[] = {
+        QPointF(0, 0), QPointF(0, height - WALL_SIZE), QPointF(0, 0), QPointF(width - WALL_SIZE, 0)
+    };
+    for (int i = 0; i < 4; ++i) {
+        pWalls[i]->setCategory(StaticSprite::CategoryWall);
+        pScene->addSpriteToScene(pWalls[i], wallPositions[i]);
+    }
+
+    const QPixmap brickPixmap = filledPixmap(BRICK_WIDTH, BRICK_HEIGHT, Qt::red);
+    for (int i = 0; i < brickCount; ++i) {
+        Brick* pBrick = new Brick(brickPixmap);
+        pBrick->setCategory(StaticSprite::CategoryWall); // Incassable.
+        pScene->addSpriteToScene(pBrick, WALL_SIZE + (i % BRICK_COLUMNS) * (BRICK_WIDTH + BRICK_SPACING),
+                                 BRICKS_TOP + (i / BRICK_COLUMNS) * BRICK_HEIGHT);
+    }
+
+    RandomGenerator random(brickCount);
+    const int playAreaTop = BRICKS_TOP + rowCount * BRICK_HEIGHT + WALL_SIZE;
+    const int playAreaWidth = width - 4 * WALL_SIZE;
+
+    const QPixmap ballPixmap = filledPixmap(BALL_PIXMAP_SIZE, BALL_PIXMAP_SIZE, Qt::white);
+    for (int i = 0; i < ballCount; ++i) {
+        Ball* pBall = new Ball;
+        pBall->setPixmap(ballPixmap);
+        pBall->setSpriteVelocity(random.uniform() * 400 - 200, -200);
+        pScene->addSpriteToScene(pBall, 2 * WALL_SIZE + random.bounded(playAreaWidth),
+                                 playAreaTop + random.bounded(PLAY_AREA_HEIGHT / 2));
+        pBall->registerForTick();
+        benchScene.balls.append(pBall);
+    }
+
+    benchScene.pPlate = new Plate;
+    benchScene.pPlate->setPixmap(filledPixmap(PLATE_WIDTH, PLATE_HEIGHT, Qt::blue));
+    pScene->addSpriteToScene(benchScene.pPlate, width / 2 - PLATE_WIDTH / 2, height - 100);
+
+    // Positions de recherche réparties sur toute la scène, précalculées pour ne pas
+    // mesurer leur construction.
+    for (int i = 0; i < QUERY_COUNT; ++i) {
+        const QRectF rect(random.bounded(width - QUERY_SIZE), random.bounded(height - QUERY_SIZE), QUERY_SIZE, QUERY_SIZE);
+        QPainterPath shape;
+        shape.addEllipse(rect);
+        benchScene.queryRects.append(rect);
+        benchScene.queryShapes.append(shape);
+    }
+
+    return benchScene;
+}
+
+//! Mesure les différents chemins sur une scène de la taille donnée.
+//! \param pCanvas     Canvas qui crée la scène.
+//! \param rBenchmark  Banc de mesure.
+//! \param brickCount  Nombre de briques.
+//! \param ballCount   Nombre de balles.
+//! \param rFilter     Seules les mesures dont le nom contient ce texte sont faites.
+//! \param pReport     Rapport auquel les résultats sont ajoutés.
+static void runBenchmarks(GameCanvas* pCanvas, const Benchmark& rBenchmark, int brickCount, int ballCount,
+                          const QString& rFilter, BenchmarkReport* pReport) {
+    BenchScene benchScene = createBenchScene(pCanvas, brickCount, ballCount);
+    GameScene* pScene = benchScene.pScene;
+
+    auto measure = [&](const QString& rName, const std::function<void()>& rOperation) {
+        if (!rName.contains(rFilter))
+            return;
+
+        const Benchmark::Result result = rBenchmark.run(rName, brickCount, rOperation);
+        Benchmark::print(result);
+        pReport->add(result);
+    };
+
+    int queryIndex = 0;
+    int found = 0; // Utilisé pour que le compilateur ne supprime pas les recherches.
+
+    measure("GameScene::collidingSprites(rect)", [&]() {
+        found += pScene->collidingSprites(benchScene.queryRects[queryIndex]).count();
+        queryIndex = (queryIndex + 1) % QUERY_COUNT;
+    });
+
+    measure("GameScene::collidingSprites(shape)", [&]() {
+        found += pScene->collidingSprites(benchScene.queryShapes[queryIndex]).count();
+        queryIndex = (queryIndex + 1) % QUERY_COUNT;
+    });
+
+    int ballIndex = 0;
+    if (!benchScene.balls.isEmpty()) {
+        measure("Ball::tick", [&]() {
+            benchScene.balls[ballIndex]->tick(TICK_ELAPSED);
+            ballIndex = (ballIndex + 1) % benchScene.balls.count();
+        });
+    }
+
+    measure("Plate::tick", [&]() {
+        benchScene.pPlate->tick(TICK_ELAPSED);
+    });
+
+    measure("GameScene::tick", [&]() {
+        pScene->tick(TICK_ELAPSED);
+    });
+
+    measure("GameScene::sprites", [&]() {
+        found += pScene->sprites().count();
+    });
+
+    QImage frame(FRAME_SIZE, QImage::Format_ARGB32_Premultiplied);
+    const QRectF frameRect(0, qMax(0.0, pScene->height() - FRAME_SIZE.height() * 1.0),
+                           FRAME_SIZE.width(), FRAME_SIZE.height());
+    measure("GameScene::render", [&]() {
+        QPainter painter(&frame);
+        pScene->render(&painter, QRectF(QPointF(0, 0), FRAME_SIZE), frameRect);
+    });
+
+    if (found < 0)
+        qDebug() << found;
+
+    delete pScene;
+}
+
+//! Vérifie que les résultats ont été mesurés avec les mêmes paramètres que la référence.
+//! \param rReport    Résultats.
+//! \param rBaseline  Rapport de référence.
+//! \return vrai si les rapports sont comparables ; sinon, les différences sont signalées.
+static bool isComparable(const BenchmarkReport& rReport, const BenchmarkReport& rBaseline) {
+    const QStringList differences = rReport.parameterDifferences(rBaseline);
+    if (differences.isEmpty())
+        return true;
+
+    qWarning().noquote() << "Paramètres différents de ceux de la référence (référence / résultats) :"
+                         << differences.join(", ");
+    return false;
+}
+
+//! Point d'entrée des mesures de performance.
+int main(int argc, char* argv[]) {
+    // Le dessin est fait hors écran : aucune fenêtre n'est nécessaire.
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+
+    QApplication application(argc, argv);
+
+    QCommandLineParser parser;
+    parser.addHelpOption();
+    QCommandLineOption sizesOption("sizes", "Nombres de briques à mesurer, séparés par des virgules.", "n,n,...",
+                                   "100,1000,5000,20000");
+    QCommandLineOption ballsOption("balls", "Nombre de balles de chaque scène.", "m", "10");
+    QCommandLineOption minTimeOption("min-time", "Durée minimale de chaque mesure, en ms.", "ms", "500");
+    QCommandLineOption samplesOption("samples", "Nombre d'échantillons dont la médiane est retenue.", "n", "5");
+    QCommandLineOption filterOption("filter", "Ne fait que les mesures dont le nom contient <texte>.", "texte");
+    QCommandLineOption jsonOption("json", "Enregistre les résultats au format JSON dans <fichier>.", "fichier");
+    QCommandLineOption baselineOption("baseline", "Compare les résultats à ceux de <fichier> ; code 1 en cas de régression.",
+                                      "fichier");
+    QCommandLineOption toleranceOption("tolerance", "Augmentation tolérée par rapport à la référence, en %.", "pourcentage",
+                                       "10");
+    QCommandLineOption compareOption("compare", "Compare les résultats de <fichier> à la référence, sans mesurer.", "fichier");
+    QCommandLineOption allowMissingOption("allow-missing",
+                                          "Une mesure de la référence absente des résultats n'est pas une régression.");
+    parser.addOption(sizesOption);
+    parser.addOption(ballsOption);
+    parser.addOption(minTimeOption);
+    parser.addOption(samplesOption);
+    parser.addOption(filterOption);
+    parser.addOption(jsonOption);
+    parser.addOption(baselineOption);
+    parser.addOption(toleranceOption);
+    parser.addOption(compareOption);
+    parser.addOption(allowMissingOption);
+    parser.process(application);
+
+    bool isToleranceValid = false;
+    const double tolerance = parser.value(toleranceOption).toDouble(&isToleranceValid) / 100;
+    if (!isToleranceValid || tolerance < 0) {
+        qWarning().noquote() << "Tolérance invalide :" << parser.value(toleranceOption);
+        return 2;
+    }
+    const bool allowMissing = parser.isSet(allowMissingOption);
+
+    BenchmarkReport baseline;
+    const bool hasBaseline = parser.isSet(baselineOption);
+    if (hasBaseline && !baseline.load(parser.value(baselineOption))) {
+        qWarning().noquote() << "Référence illisible :" << baseline.errorString();
+        return 2;
+    }
+
+    BenchmarkReport report;
+    if (parser.isSet(compareOption)) {
+        if (!hasBaseline) {
+            qWarning() << "--compare nécessite --baseline.";
+            return 2;
+        }
+        if (!report.load(parser.value(compareOption))) {
+            qWarning().noquote() << "Résultats illisibles :" << report.errorString();
+            return 2;
+        }
+        if (!isComparable(report, baseline))
+            return 2;
+        return report.compare(baseline, tolerance, allowMissing) > 0 ? 1 : 0;
+    }
+
+    // Le canvas ne sert qu'à créer les scènes : la boucle d'événements ne tourne pas,
+    // GameCore n'est donc jamais construit et le tick jamais démarré.
+    GameView view;
+    GameCanvas canvas(&view);
+    const long long minTime = parser.value(minTimeOption).toLongLong();
+    const int sampleCount = parser.value(samplesOption).toInt();
+    const int ballCount = parser.value(ballsOption).toInt();
+    const QString filter = parser.value(filterOption);
+    Benchmark benchmark(minTime, sampleCount);
+
+    QJsonArray sizes;
+    for (const QString& rSize : parser.value(sizesOption).split(',', QString::SkipEmptyParts))
+        sizes.append(rSize.toInt());
+
+    QJsonObject parameters;
+    parameters["sizes"] = sizes;
+    parameters["balls"] = ballCount;
+    parameters["minTime"] = double(minTime);
+    parameters["samples"] = sampleCount;
+    parameters["filter"] = filter;
+    report.setParameters(parameters);
+
+    // Les paramètres sont vérifiés avant de mesurer, afin de ne pas faire des mesures
+    // qui ne pourront pas être comparées.
+    if (hasBaseline && !isComparable(report, baseline))
+        return 2;
+
+    Benchmark::printHeader();
+    for (const QJsonValue& rSize : sizes)
+        runBenchmarks(&canvas, benchmark, rSize.toInt(), ballCount, filter, &report);
+
+    if (parser.isSet(jsonOption) && !report.save(parser.value(jsonOption))) {
+        qWarning().noquote() << "Enregistrement des résultats impossible :" << report.errorString();
+        return 2;
+    }
+
+    if (hasBaseline) {
+        std::printf("\n");
+        return report.compare(baseline, tolerance, allowMissing) > 0 ? 1 : 0;
+    }
+
+    return 0;
+}
@@ -49,7 +49,7 @@ void BouncingSpriteHandler::tick(long long elapsedTimeInMilliseconds) {
 
     if (!collidingSprites.isEmpty()) {
         // On ne considère que la première collision (au cas où il y en aurait plusieurs)
-        Sprite* pCollidingSprite = collidingSprites[0];
+        StaticSprite* pCollidingSprite = collidingSprites[0];
 
         // Technique très approximative pour simuler un rebond en simplifiant
         // la façon de déterminer le vecteur normal de la surface du rebond.
@@ -74,7 +74,7 @@ void BouncingSpriteHandler::tick(long long elapsedTimeInMilliseconds) {
         // Parcours la liste et supprime ceux qui sont entrés en collision
         for(int i = 0; i < collidingSprites.size(); i++) {
             if (collidingSprites.at(i)->data(0).toString() == "brick-to-destroy") {
-                collidingSprites.at(i)->deleteLater();
+                m_pParentSprite->parentScene()->destroySpriteLater(collidingSprites.at(i));
             }
         }
     }
@@ -0,0 +1,62 @@
+/**
+  \file
+  \brief    Définition de la classe Brick.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "brick.h"
+
+//! Opacité d'une brique qui n'a plus qu'un point de vie sur un grand nombre.
+const double MIN_DAMAGED_OPACITY = 0.4;
+
+//! Construit une brique.
+//! \param rPixmap    Image de la brique.
+//! \param hitPoints  Nombre de coups nécessaires pour détruire la brique (au moins 1).
+//! \param pParent    Pointeur sur le parent (afin d'obtenir une destruction automatique de cet objet).
+Brick::Brick(const QPixmap& rPixmap, int hitPoints, QGraphicsItem* pParent) : StaticSprite(rPixmap, pParent) {
+    m_maxHitPoints = qMax(1, hitPoints);
+    m_hitPoints = m_maxHitPoints;
+}
+
+//! \return le nombre de points de vie restant à la brique.
+int Brick::hitPoints() const {
+    return m_hitPoints;
+}
+
+//! \return le nombre de points de vie initial de la brique.
+int Brick::maxHitPoints() const {
+    return m_maxHitPoints;
+}
+
+//! La brique est touchée : elle perd un point de vie et son opacité diminue.
+//! \return vrai si la brique n'a plus de point de vie et doit être détruite.
+bool Brick::hit() {
+    if (m_hitPoints > 0)
+        m_hitPoints--;
+
+    if (m_hitPoints > 0)
+        setOpacity(MIN_DAMAGED_OPACITY + (1.0 - MIN_DAMAGED_OPACITY) * m_hitPoints / m_maxHitPoints);
+
+    return m_hitPoints == 0;
+}
+
+//! Réinitialise la brique afin de la réutiliser (voir EndlessField) : elle reçoit une
+//! nouvelle image et tous ses points de vie.
+//! \param rPixmap    Nouvelle image de la brique.
+//! \param hitPoints  Nombre de coups nécessaires pour détruire la brique (au moins 1).
+void Brick::reset(const QPixmap& rPixmap, int hitPoints) {
+    setPixmap(rPixmap);
+    m_maxHitPoints = qMax(1, hitPoints);
+    m_hitPoints = m_maxHitPoints;
+    setOpacity(1.0);
+}
+
+//! \return le nom de la classe, pour les relevés de mémoire.
+const char* Brick::spriteClassName() const {
+    return "Brick";
+}
+
+//! \return la taille estimée de la brique en mémoire, en octets.
+qint64 Brick::estimatedSize() const {
+    return StaticSprite::estimatedSize() + qint64(sizeof(Brick) - sizeof(StaticSprite));
+}
@@ -0,0 +1,41 @@
+/**
+  \file
+  \brief    Déclaration de la classe Brick.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef BRICK_H
+#define BRICK_H
+
+#include "staticsprite.h"
+
+//! \brief Classe qui représente une brique.
+//!
+//! Une brique cassable (catégorie CategoryBrick) possède des points de vie : chaque
+//! coup reçu de la balle (hit()) lui en retire un, et elle est détruite lorsqu'elle
+//! n'en a plus. Son opacité diminue avec les coups reçus.
+//!
+//! Une brique incassable est rangée dans la catégorie CategoryWall : elle se comporte
+//! comme un mur et ses points de vie ne sont pas utilisés.
+//!
+//! Tous les sprites de la catégorie CategoryBrick sont des instances de Brick.
+class Brick : public StaticSprite
+{
+public:
+    Brick(const QPixmap& rPixmap, int hitPoints = 1, QGraphicsItem* pParent = nullptr);
+
+    int hitPoints() const;
+    int maxHitPoints() const;
+
+    bool hit();
+    void reset(const QPixmap& rPixmap, int hitPoints);
+
+    virtual const char* spriteClassName() const;
+    virtual qint64 estimatedSize() const;
+
+private:
+    int m_hitPoints;
+    int m_maxHitPoints;
+};
+
+#endif // BRICK_H
@@ -0,0 +1,113 @@
+/**
+  \file
+  \brief    Définition de la classe Camera.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "camera.h"
+
+#include <cmath>
+
+#include <QtGlobal>
+
+// Initialisation des constantes.
+const qreal MIN_ZOOM = 0.1;
+const qreal MAX_ZOOM = 10.0;
+const qreal FOLLOW_TIME_CONSTANT = 150.0; // Temps (en ms) pour parcourir ~63% de la distance à la cible.
+
+//! Construit une caméra désactivée.
+Camera::Camera() {
+    m_zoom = 1.0;
+}
+
+//! \return vrai si la caméra est activée (sa taille de vue a été définie).
+bool Camera::isEnabled() const {
+    return m_viewSize.isValid() && !m_viewSize.isEmpty();
+}
+
+//! Change la taille de la zone montrée par la caméra, à un zoom de 1.
+//! Une taille invalide désactive la caméra.
+//! \param rViewSize  Taille de la zone, en unités de la scène.
+void Camera::setViewSize(const QSizeF& rViewSize) {
+    m_viewSize = rViewSize;
+    clampCenter();
+}
+
+//! \return la taille de la zone montrée par la caméra, à un zoom de 1.
+QSizeF Camera::viewSize() const {
+    return m_viewSize;
+}
+
+//! Change le zoom de la caméra (2 : la zone montrée est deux fois plus petite).
+//! \param zoom  Nouveau zoom, limité entre 0.1 et 10.
+void Camera::setZoom(qreal zoom) {
+    m_zoom = qBound(MIN_ZOOM, zoom, MAX_ZOOM);
+    clampCenter();
+}
+
+//! \return le zoom de la caméra.
+qreal Camera::zoom() const {
+    return m_zoom;
+}
+
+//! Change les limites que la zone montrée par la caméra ne doit pas dépasser.
+//! \param rBounds  Limites de la caméra, en principe la surface de la scène.
+void Camera::setBounds(const QRectF& rBounds) {
+    m_bounds = rBounds;
+    clampCenter();
+}
+
+//! \return les limites de la caméra.
+QRectF Camera::bounds() const {
+    return m_bounds;
+}
+
+//! Place immédiatement la caméra sur le point donné (dans les limites de la caméra).
+//! \param rCenter  Nouveau centre de la caméra.
+void Camera::setCenter(const QPointF& rCenter) {
+    m_center = rCenter;
+    clampCenter();
+}
+
+//! \return le centre de la caméra.
+QPointF Camera::center() const {
+    return m_center;
+}
+
+//! Rapproche progressivement la caméra de la cible donnée (amortissement exponentiel,
+//! indépendant de la cadence).
+//! \param rTarget                    Point que la caméra doit suivre.
+//! \param elapsedTimeInMilliseconds  Temps écoulé depuis le dernier appel.
+void Camera::follow(const QPointF& rTarget, long long elapsedTimeInMilliseconds) {
+    const qreal factor = 1.0 - std::exp(-elapsedTimeInMilliseconds / FOLLOW_TIME_CONSTANT);
+    setCenter(m_center + (rTarget - m_center) * factor);
+}
+
+//! \return la zone de la scène montrée par la caméra. Si la caméra est désactivée,
+//! ce sont ses limites qui sont retournées.
+QRectF Camera::rect() const {
+    if (!isEnabled())
+        return m_bounds;
+
+    QSizeF size = m_viewSize / m_zoom;
+    return QRectF(m_center.x() - size.width() / 2, m_center.y() - size.height() / 2, size.width(), size.height());
+}
+
+//! Garde la zone montrée par la caméra à l'intérieur de ses limites. Si la zone est plus
+//! grande que les limites, elle est centrée sur celles-ci.
+void Camera::clampCenter() {
+    if (!isEnabled() || m_bounds.isNull())
+        return;
+
+    QSizeF halfSize = m_viewSize / m_zoom / 2;
+
+    if (halfSize.width() * 2 >= m_bounds.width())
+        m_center.setX(m_bounds.center().x());
+    else
+        m_center.setX(qBound(m_bounds.left() + halfSize.width(), m_center.x(), m_bounds.right() - halfSize.width()));
+
+    if (halfSize.height() * 2 >= m_bounds.height())
+        m_center.setY(m_bounds.center().y());
+    else
+        m_center.setY(qBound(m_bounds.top() + halfSize.height(), m_center.y(), m_bounds.bottom() - halfSize.height()));
+}
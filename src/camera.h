@@ -0,0 +1,59 @@
+/**
+  \file
+  \brief    Déclaration de la classe Camera.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef CAMERA_H
+#define CAMERA_H
+
+#include <QPointF>
+#include <QRectF>
+#include <QSizeF>
+
+//! \brief Caméra d'une scène : partie de la scène affichée par la vue.
+//!
+//! La caméra est définie par son centre, la taille de la zone qu'elle montre à un zoom
+//! de 1 (setViewSize()) et son zoom. Elle reste toujours à l'intérieur de ses limites
+//! (setBounds()), en principe la surface de la scène.
+//!
+//! Une caméra dont la taille de vue n'a pas été définie est désactivée : la vue affiche
+//! alors toute la scène, comme auparavant.
+//!
+//! follow() déplace progressivement la caméra vers une cible (la balle, par exemple).
+//!
+//! GameView affiche la zone rect() de la caméra de la scène courante, et GameScene ne
+//! cadence à pleine fréquence que les sprites proches de cette zone (voir TickRegistry).
+class Camera
+{
+public:
+    Camera();
+
+    bool isEnabled() const;
+
+    void setViewSize(const QSizeF& rViewSize);
+    QSizeF viewSize() const;
+
+    void setZoom(qreal zoom);
+    qreal zoom() const;
+
+    void setBounds(const QRectF& rBounds);
+    QRectF bounds() const;
+
+    void setCenter(const QPointF& rCenter);
+    QPointF center() const;
+
+    void follow(const QPointF& rTarget, long long elapsedTimeInMilliseconds);
+
+    QRectF rect() const;
+
+private:
+    void clampCenter();
+
+    QSizeF m_viewSize;
+    qreal m_zoom;
+    QRectF m_bounds;
+    QPointF m_center;
+};
+
+#endif // CAMERA_H
@@ -0,0 +1,186 @@
+/**
+  \file
+  \brief    Définition de la classe EndlessField.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "endlessfield.h"
+
+#include <cmath>
+
+#include "assetloader.h"
+#include "brick.h"
+#include "gamescene.h"
+
+// Initialisation des constantes.
+const int BRICK_WIDTH = 65;             // Largeur d'une brique (image réduite de moitié).
+const int BRICK_HEIGHT = 20;            // Hauteur d'une brique (image réduite de moitié).
+const int FIELD_TOP = 50;               // Haut de la zone des briques.
+const int EVICTION_MARGIN = 200;        // Distance entre la ligne d'éviction et le bas de la scène.
+const int CHUNK_ROWS = 2;               // Nombre de rangées d'un tronçon.
+const int INITIAL_CHUNK_COUNT = 3;      // Nombre de tronçons au début de la partie.
+const double SCROLL_SPEED = 15.0;       // Vitesse de défilement, en pixels par seconde.
+const double CHUNK_DENSITY = 0.6;
+const double CHUNK_UNBREAKABLE_RATIO = 0.05;
+const int CHUNK_MAX_HIT_POINTS = 2;
+
+//! Construit le champ de briques et génère ses premiers tronçons.
+//! \param pScene        Scène de jeu, à laquelle les briques sont ajoutées.
+//! \param rBrickColors  Noms des couleurs de briques, dans l'ordre de LevelReader::BrickType.
+//! \param seed          Graine du jeu, dont dépendent tous les tronçons générés.
+EndlessField::EndlessField(GameScene* pScene, const QList<QString>& rBrickColors, quint64 seed) {
+    m_pScene = pScene;
+    m_seed = seed;
+
+    for (int i = 0; i < LevelReader::BrickColorCount; ++i)
+        m_brickPixmaps[i] = AssetLoader::instance()->pixmap("brick" + rBrickColors.value(i) + ".png");
+
+    m_chunkParameters.columnCount = int(pScene->width()) / BRICK_WIDTH;
+    m_chunkParameters.rowCount = CHUNK_ROWS;
+    m_chunkParameters.density = CHUNK_DENSITY;
+    m_chunkParameters.unbreakableRatio = CHUNK_UNBREAKABLE_RATIO;
+    m_chunkParameters.maxHitPoints = CHUNK_MAX_HIT_POINTS;
+    m_originX = (pScene->width() - m_chunkParameters.columnCount * BRICK_WIDTH) / 2;
+    m_chunkHeight = CHUNK_ROWS * BRICK_HEIGHT;
+
+    // Le tableau circulaire contient assez de tronçons pour couvrir la zone des briques.
+    qreal fieldHeight = pScene->height() - EVICTION_MARGIN - FIELD_TOP;
+    m_chunks.resize(int(std::ceil(fieldHeight / m_chunkHeight)) + 1);
+    m_bottomChunk = 0;
+    m_liveChunkCount = 0;
+    m_generatedChunkCount = 0;
+    m_pFillingChunk = nullptr;
+
+    // Les premiers tronçons sont empilés à partir du haut de la zone, du bas vers le haut.
+    for (int i = INITIAL_CHUNK_COUNT - 1; i >= 0; --i)
+        spawnChunk(FIELD_TOP + i * m_chunkHeight);
+}
+
+//! Destructeur : détruit les briques de la réserve. Les briques encore présentes
+//! dans la scène appartiennent à la scène.
+EndlessField::~EndlessField() {
+    qDeleteAll(m_brickPool);
+}
+
+//! Cadence : fait descendre les briques, évince les tronçons qui ont atteint la ligne
+//! d'éviction et génère de nouveaux tronçons en haut de la zone.
+//! \param elapsedTimeInMilliseconds  Temps écoulé depuis le dernier appel.
+void EndlessField::tick(long long elapsedTimeInMilliseconds) {
+    const qreal scroll = SCROLL_SPEED * elapsedTimeInMilliseconds / 1000.;
+
+    for (int i = 0; i < m_liveChunkCount; ++i) {
+        Chunk& rChunk = m_chunks[(m_bottomChunk + i) % m_chunks.count()];
+        rChunk.top += scroll;
+        for (const SpriteHandle& rHandle : rChunk.bricks) {
+            StaticSprite* pBrick = m_pScene->sprite(rHandle);
+            if (pBrick)
+                pBrick->moveBy(0, scroll);
+        }
+    }
+
+    // Eviction des tronçons qui ont atteint la ligne d'éviction.
+    const qreal evictionLine = m_pScene->height() - EVICTION_MARGIN;
+    while (m_liveChunkCount > 0 && m_chunks[m_bottomChunk].top + m_chunkHeight >= evictionLine) {
+        releaseChunk(m_chunks[m_bottomChunk]);
+        m_bottomChunk = (m_bottomChunk + 1) % m_chunks.count();
+        m_liveChunkCount--;
+    }
+
+    // Génération de nouveaux tronçons, dès qu'il y a la place en haut de la zone.
+    forever {
+        if (m_liveChunkCount == 0) {
+            spawnChunk(FIELD_TOP);
+            continue;
+        }
+
+        const Chunk& rTopChunk = m_chunks[(m_bottomChunk + m_liveChunkCount - 1) % m_chunks.count()];
+        if (m_liveChunkCount == m_chunks.count() || rTopChunk.top - m_chunkHeight < FIELD_TOP)
+            break;
+        spawnChunk(rTopChunk.top - m_chunkHeight);
+    }
+}
+
+//! \return le nombre de tronçons générés depuis le début de la partie.
+int EndlessField::generatedChunkCount() const {
+    return m_generatedChunkCount;
+}
+
+//! \return le nombre de briques disponibles dans la réserve.
+int EndlessField::pooledBrickCount() const {
+    return m_brickPool.count();
+}
+
+//! Début de la génération d'un tronçon (LevelReader::Handler) : rien à faire, les
+//! dimensions des tronçons sont connues.
+void EndlessField::beginLevel(int columnCount, int rowCount) {
+    Q_UNUSED(columnCount)
+    Q_UNUSED(rowCount)
+}
+
+//! Ajoute au tronçon en cours de génération une séquence de briques (LevelReader::Handler).
+//! Les briques sont prises dans la réserve.
+void EndlessField::addBricks(int row, int column, LevelReader::BrickType type, int count, int hitPoints) {
+    Q_ASSERT(m_pFillingChunk != nullptr);
+
+    // Le générateur ne produit que des couleurs déterminées.
+    int colorIndex = (type == LevelReader::BrickRandom) ? 0 : type - LevelReader::BrickBlue;
+
+    for (int i = 0; i < count; ++i) {
+        Brick* pBrick = takeBrick();
+        pBrick->reset(m_brickPixmaps[colorIndex], hitPoints);
+        pBrick->setCategory(type == LevelReader::BrickGray ? StaticSprite::CategoryWall : StaticSprite::CategoryBrick);
+        m_pScene->addSpriteToScene(pBrick, m_originX + (column + i) * BRICK_WIDTH, m_pFillingChunk->top + row * BRICK_HEIGHT);
+        m_pFillingChunk->bricks.append(pBrick->handle());
+    }
+}
+
+//! Génère un nouveau tronçon au-dessus des tronçons existants.
+//! \param top  Position verticale de la première rangée du tronçon.
+void EndlessField::spawnChunk(qreal top) {
+    Q_ASSERT(m_liveChunkCount < m_chunks.count());
+
+    fillChunk(m_chunks[(m_bottomChunk + m_liveChunkCount) % m_chunks.count()], top);
+    m_liveChunkCount++;
+}
+
+//! Génère les briques du tronçon donné.
+//! \param rChunk  Tronçon à remplir (vide).
+//! \param top     Position verticale de la première rangée du tronçon.
+void EndlessField::fillChunk(Chunk& rChunk, qreal top) {
+    rChunk.top = top;
+    rChunk.bricks.resize(0); // Conserve la capacité du tableau.
+
+    // La graine de chaque tronçon dépend de son numéro : le champ est reproductible.
+    LevelGenerator generator(m_chunkParameters, m_seed + quint64(m_generatedChunkCount) * 0x9E3779B97F4A7C15ull);
+    m_pFillingChunk = &rChunk;
+    generator.generate(this);
+    m_pFillingChunk = nullptr;
+
+    m_generatedChunkCount++;
+}
+
+//! Retire de la scène les briques encore présentes du tronçon donné et les range
+//! dans la réserve.
+//! \param rChunk  Tronçon à vider.
+void EndlessField::releaseChunk(Chunk& rChunk) {
+    for (const SpriteHandle& rHandle : rChunk.bricks) {
+        StaticSprite* pBrick = m_pScene->sprite(rHandle);
+
+        // Une brique dont la destruction est planifiée sera détruite par la scène.
+        if (pBrick && !pBrick->isDestroyPending()) {
+            m_pScene->removeSpriteFromScene(pBrick);
+            m_brickPool.append(static_cast<Brick*>(pBrick));
+        }
+    }
+    rChunk.bricks.resize(0);
+}
+
+//! \return une brique prise dans la réserve ou, si elle est vide, une nouvelle brique.
+Brick* EndlessField::takeBrick() {
+    if (!m_brickPool.isEmpty())
+        return m_brickPool.takeLast();
+
+    Brick* pBrick = new Brick(QPixmap());
+    pBrick->setScale(0.5);
+    return pBrick;
+}
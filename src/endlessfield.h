@@ -0,0 +1,78 @@
+/**
+  \file
+  \brief    Déclaration de la classe EndlessField.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef ENDLESSFIELD_H
+#define ENDLESSFIELD_H
+
+#include <QPixmap>
+#include <QVector>
+
+#include "levelgenerator.h"
+#include "levelreader.h"
+#include "spritehandle.h"
+
+class Brick;
+class GameScene;
+
+//! \brief Classe qui gère le mode sans fin : un champ de briques qui défile vers le bas.
+//!
+//! Le champ est découpé en tronçons (chunks) de quelques rangées de briques. Chaque
+//! tronçon est généré par un LevelGenerator, avec une graine qui dépend de la graine du
+//! jeu et du numéro du tronçon : le champ est donc reproductible.
+//!
+//! A chaque cadence (tick()), les briques descendent. Lorsqu'un tronçon atteint la ligne
+//! d'éviction (au-dessus du plateau), ses briques sont retirées de la scène et rangées
+//! dans une réserve. Dès qu'il y a la place pour un tronçon en haut de la zone de jeu, un
+//! nouveau tronçon y est généré, avec des briques prises dans la réserve.
+//!
+//! Les tronçons sont rangés dans un tableau circulaire de taille fixe et les briques sont
+//! recyclées : la mémoire utilisée et le coût d'une cadence restent constants, quelle que
+//! soit la durée de la partie.
+class EndlessField : public LevelReader::Handler
+{
+public:
+    EndlessField(GameScene* pScene, const QList<QString>& rBrickColors, quint64 seed);
+    ~EndlessField();
+
+    void tick(long long elapsedTimeInMilliseconds);
+
+    int generatedChunkCount() const;
+    int pooledBrickCount() const;
+
+    // LevelReader::Handler
+    void beginLevel(int columnCount, int rowCount);
+    void addBricks(int row, int column, LevelReader::BrickType type, int count, int hitPoints);
+
+private:
+    //! Tronçon du champ de briques.
+    struct Chunk
+    {
+        qreal top = 0;                  //!< Position verticale de la première rangée.
+        QVector<SpriteHandle> bricks;   //!< Briques du tronçon (certaines ont pu être détruites).
+    };
+
+    void spawnChunk(qreal top);
+    void fillChunk(Chunk& rChunk, qreal top);
+    void releaseChunk(Chunk& rChunk);
+    Brick* takeBrick();
+
+    GameScene* m_pScene;
+    QPixmap m_brickPixmaps[LevelReader::BrickColorCount];
+    quint64 m_seed;
+    LevelGenerator::Parameters m_chunkParameters;
+    qreal m_originX;
+    qreal m_chunkHeight;
+
+    QVector<Chunk> m_chunks;
+    int m_bottomChunk;
+    int m_liveChunkCount;
+    int m_generatedChunkCount;
+    Chunk* m_pFillingChunk;
+
+    QVector<Brick*> m_brickPool;
+};
+
+#endif // ENDLESSFIELD_H
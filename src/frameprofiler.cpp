@@ -0,0 +1,184 @@
+/**
+  \file
+  \brief    Définition de la classe FrameProfiler.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "frameprofiler.h"
+
+#include <algorithm>
+
+#include "tracewriter.h"
+
+// Initialisation des constantes.
+const double NS_PER_MS = 1000000.0;
+const int FRAME_TIME_COUNT = 240;       // Nombre d'images prises en compte pour les centiles.
+const double STAGE_SMOOTHING = 0.05;    // Poids d'une nouvelle image dans la moyenne glissante.
+const qint64 NO_FRAME_START = -1;
+
+//! \return l'instance unique du profileur.
+FrameProfiler& FrameProfiler::instance() {
+    static FrameProfiler s_profiler;
+    return s_profiler;
+}
+
+//! Construit un profileur désactivé.
+FrameProfiler::FrameProfiler() : m_head(0), m_tail(0) {
+    m_enabled = false;
+    m_isRecording = false;
+    m_pTraceWriter = nullptr;
+    m_droppedEventCount = 0;
+
+    m_frameStart = NO_FRAME_START;
+    m_frameTimes.resize(FRAME_TIME_COUNT);
+    m_frameTimeIndex = 0;
+    m_frameTimeCount = 0;
+
+    m_clock.start();
+}
+
+//! Active ou désactive les mesures. A la désactivation, les mesures sont effacées.
+//! \param enabled  Indique si les durées des marqueurs et des images doivent être mesurées.
+void FrameProfiler::setEnabled(bool enabled) {
+    if (m_enabled == enabled)
+        return;
+
+    m_enabled = enabled;
+    m_isRecording = m_enabled || m_pTraceWriter;
+    if (!enabled) {
+        // Sans trace en cours, les événements en attente ne seront plus retirés.
+        if (!m_isRecording) {
+            Event event;
+            while (takeEvent(event)) { }
+        }
+        m_stages.clear();
+        m_stageIndexes.clear();
+        m_frameTimeCount = 0;
+        m_frameTimeIndex = 0;
+    }
+    resetFrameClock();
+}
+
+//! Définit l'écrivain auquel les événements et les images sont transmis, en plus des
+//! mesures. Les marqueurs enregistrent des événements tant qu'un écrivain est défini.
+//! \param pTraceWriter  Ecrivain de la trace, ou nullptr pour arrêter la transmission.
+void FrameProfiler::setTraceWriter(TraceWriter* pTraceWriter) {
+    m_pTraceWriter = pTraceWriter;
+    m_isRecording = m_enabled || m_pTraceWriter;
+    if (!m_isRecording) {
+        Event event;
+        while (takeEvent(event)) { }
+    }
+    resetFrameClock();
+}
+
+//! Enregistre un événement (producteur). Si le tableau est plein, l'événement est perdu.
+//! \param name      Nom du marqueur.
+//! \param start     Début de l'événement, en ns (voir now()).
+//! \param duration  Durée de l'événement, en ns.
+void FrameProfiler::record(const char* name, qint64 start, qint64 duration) {
+    const quint32 head = m_head.load();
+    if (head - m_tail.loadAcquire() >= quint32(EVENT_CAPACITY)) {
+        m_droppedEventCount++;
+        return;
+    }
+
+    Event& rEvent = m_events[head & (EVENT_CAPACITY - 1)];
+    rEvent.name = name;
+    rEvent.start = start;
+    rEvent.duration = duration;
+    m_head.storeRelease(head + 1);
+}
+
+//! Retire le plus ancien événement du tableau (consommateur).
+//! \param rEvent  Reçoit l'événement retiré.
+//! \return faux si le tableau est vide.
+bool FrameProfiler::takeEvent(Event& rEvent) {
+    const quint32 tail = m_tail.load();
+    if (tail == m_head.loadAcquire())
+        return false;
+
+    rEvent = m_events[tail & (EVENT_CAPACITY - 1)];
+    m_tail.storeRelease(tail + 1);
+    return true;
+}
+
+//! Commence une nouvelle image : la durée de l'image précédente est conservée et ses
+//! événements sont cumulés par marqueur, et transmis à l'écrivain de la trace s'il y en a un.
+void FrameProfiler::beginFrame() {
+    if (!m_isRecording)
+        return;
+
+    const qint64 frameStart = now();
+    if (m_frameStart != NO_FRAME_START) {
+        if (m_pTraceWriter)
+            m_pTraceWriter->addCompleteEvent("Frame", "frame", m_frameStart, frameStart - m_frameStart);
+
+        if (m_enabled) {
+            m_frameTimes[m_frameTimeIndex] = (frameStart - m_frameStart) / NS_PER_MS;
+            m_frameTimeIndex = (m_frameTimeIndex + 1) % FRAME_TIME_COUNT;
+            m_frameTimeCount = qMin(m_frameTimeCount + 1, FRAME_TIME_COUNT);
+        }
+    }
+    m_frameStart = frameStart;
+
+    Event event;
+    while (takeEvent(event)) {
+        if (m_pTraceWriter)
+            m_pTraceWriter->addCompleteEvent(event.name, "profile", event.start, event.duration);
+
+        if (!m_enabled)
+            continue;
+
+        int stageIndex = m_stageIndexes.value(event.name, -1);
+        if (stageIndex < 0) {
+            stageIndex = m_stages.count();
+            m_stageIndexes.insert(event.name, stageIndex);
+            m_stages.append(Stage());
+            m_stages.last().name = event.name;
+        }
+        m_stages[stageIndex].frameTime += event.duration / NS_PER_MS;
+    }
+
+    if (!m_enabled)
+        return;
+
+    for (Stage& rStage : m_stages) {
+        rStage.averageTime += STAGE_SMOOTHING * (rStage.frameTime - rStage.averageTime);
+        rStage.frameTime = 0;
+    }
+}
+
+//! Oublie le début de l'image en cours : l'intervalle jusqu'au prochain beginFrame()
+//! n'est pas compté comme une durée d'image (par exemple après une suspension du tick).
+void FrameProfiler::resetFrameClock() {
+    m_frameStart = NO_FRAME_START;
+}
+
+//! \return le centile donné (50, 95, 99...) de la durée des dernières images, en ms.
+//! \param percentile  Centile à calculer, entre 0 et 100.
+double FrameProfiler::frameTimePercentile(int percentile) const {
+    if (m_frameTimeCount == 0)
+        return 0;
+
+    QVector<double> frameTimes = m_frameTimes.mid(0, m_frameTimeCount);
+    const int index = qBound(0, (m_frameTimeCount * percentile) / 100, m_frameTimeCount - 1);
+    std::nth_element(frameTimes.begin(), frameTimes.begin() + index, frameTimes.end());
+    return frameTimes[index];
+}
+
+//! \return le nombre de durées d'images conservées.
+int FrameProfiler::frameTimeCount() const {
+    return m_frameTimeCount;
+}
+
+//! \return la durée moyenne par image de chaque marqueur, dans l'ordre de leur
+//! première apparition.
+const QVector<FrameProfiler::Stage>& FrameProfiler::stages() const {
+    return m_stages;
+}
+
+//! \return le nombre d'événements perdus parce que le tableau était plein.
+long long FrameProfiler::droppedEventCount() const {
+    return m_droppedEventCount;
+}
@@ -0,0 +1,123 @@
+/**
+  \file
+  \brief    Déclaration des classes FrameProfiler et ProfileScope.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+#include <QAtomicInteger>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QVector>
+
+class TraceWriter;
+
+//! \brief Classe qui mesure la durée des différentes parties d'une image (tick et dessin).
+//!
+//! Les parties mesurées sont délimitées par des marqueurs (ProfileScope) placés dans le
+//! code : GameCore::tick(), GameScene::tick(), la cadence de chaque type de sprite (voir
+//! TickRegistry), les recherches de collisions et le dessin de GameView. Chaque marqueur
+//! enregistre un événement (nom, début, durée) dans un tableau circulaire sans verrou, à un
+//! seul producteur et un seul consommateur : les marqueurs ne doivent être placés que dans
+//! le code exécuté par le thread principal. Lorsque le tableau est plein, les événements
+//! sont perdus (et comptés) plutôt que de bloquer le jeu.
+//!
+//! Au début de chaque image (beginFrame()), les événements de l'image précédente sont
+//! retirés du tableau et cumulés par nom (durées inclusives : un marqueur imbriqué est
+//! aussi compté dans son parent). La durée de chaque image (intervalle entre deux
+//! beginFrame()) est conservée pour les dernières images, ce qui permet d'en calculer la
+//! médiane et les 95e et 99e centiles (frameTimePercentile()).
+//!
+//! Les mesures ne sont faites que si le profileur est activé (setEnabled()), par exemple
+//! lorsque ProfilerOverlayItem est affiché, ou si une trace est écrite (setTraceWriter()) :
+//! chaque événement, ainsi que chaque image, est alors aussi transmis au TraceWriter.
+//! Sinon, un marqueur ne coûte qu'un test.
+class FrameProfiler
+{
+public:
+    //! Evénement enregistré par un marqueur.
+    struct Event
+    {
+        const char* name;   //!< Nom du marqueur (chaîne statique).
+        qint64 start;       //!< Début, en ns (voir now()).
+        qint64 duration;    //!< Durée, en ns.
+    };
+
+    //! Durée moyenne par image d'un marqueur.
+    struct Stage
+    {
+        const char* name = nullptr; //!< Nom du marqueur.
+        double frameTime = 0;       //!< Durée cumulée durant l'image en cours (ms).
+        double averageTime = 0;     //!< Moyenne glissante de la durée par image (ms).
+    };
+
+    static FrameProfiler& instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return m_isRecording; }
+    void setTraceWriter(TraceWriter* pTraceWriter);
+
+    qint64 now() const { return m_clock.nsecsElapsed(); }
+    void record(const char* name, qint64 start, qint64 duration);
+    bool takeEvent(Event& rEvent);
+
+    void beginFrame();
+    void resetFrameClock();
+
+    double frameTimePercentile(int percentile) const;
+    int frameTimeCount() const;
+    const QVector<Stage>& stages() const;
+    long long droppedEventCount() const;
+
+private:
+    FrameProfiler();
+
+    enum { EVENT_CAPACITY = 4096 }; // Puissance de deux.
+
+    bool m_enabled;         // Mesures par marqueur et durées des images (ProfilerOverlayItem).
+    bool m_isRecording;     // Les marqueurs enregistrent des événements (mesures ou trace).
+    TraceWriter* m_pTraceWriter;
+    QElapsedTimer m_clock;
+
+    Event m_events[EVENT_CAPACITY];
+    QAtomicInteger<quint32> m_head;     // Prochain emplacement écrit (producteur).
+    QAtomicInteger<quint32> m_tail;     // Prochain emplacement lu (consommateur).
+    long long m_droppedEventCount;
+
+    qint64 m_frameStart;
+    QVector<double> m_frameTimes;       // Tableau circulaire des durées des dernières images (ms).
+    int m_frameTimeIndex;
+    int m_frameTimeCount;
+
+    QVector<Stage> m_stages;
+    QHash<const char*, int> m_stageIndexes;
+};
+
+//! \brief Marqueur qui mesure la durée de la portée dans laquelle il est déclaré.
+//!
+//! Exemple : `ProfileScope scope("GameScene::tick");` au début d'une méthode. Le nom doit
+//! être une chaîne statique, dont l'adresse identifie le marqueur.
+class ProfileScope
+{
+public:
+    explicit ProfileScope(const char* name) {
+        FrameProfiler& rProfiler = FrameProfiler::instance();
+        m_name = name;
+        m_start = rProfiler.isEnabled() ? rProfiler.now() : -1;
+    }
+
+    ~ProfileScope() {
+        if (m_start >= 0) {
+            FrameProfiler& rProfiler = FrameProfiler::instance();
+            rProfiler.record(m_name, m_start, rProfiler.now() - m_start);
+        }
+    }
+
+private:
+    const char* m_name;
+    qint64 m_start;
+};
+
+#endif // FRAMEPROFILER_H
@@ -6,12 +6,19 @@
 */
 #include "gamecanvas.h"
 
+#include "assetloader.h"
+#include "autoplayer.h"
+#include "frameprofiler.h"
 #include "gamecore.h"
+#include "gameoptions.h"
 #include "gamescene.h"
 #include "gameview.h"
+#include "profileroverlayitem.h"
+#include "tracewriter.h"
 
 #include <limits>
 
+#include <QCoreApplication>
 #include <QDebug>
 #include <QGraphicsSceneMouseEvent>
 #include <QGraphicsItem>
@@ -19,6 +26,13 @@
 #include <QKeyEvent>
 
 const int DEFAULT_TICK_INTERVAL = 10;
+const long long MAX_SIMULATION_STEP = 20;   // Durée maximale (en ms) d'un pas de simulation.
+const int MAX_SIMULATION_STEPS = 16;        // Nombre maximal de pas de simulation par tick.
+const double MAX_TIME_SCALE = 64.0;
+const QPoint PROFILER_OVERLAY_POS(10, 120);  // Position des mesures du profileur, en pixels dans la vue.
+const qint64 MEMORY_UPDATE_INTERVAL = 1000;   // Intervalle (en ms) entre deux relevés de mémoire affichés.
+const int MAX_HEADLESS_MEMORY_LINES = 2;      // Lignes du résumé de la mémoire écrites en mode sans fenêtre.
+const long long REPLAY_CHECK_INTERVAL = 100;  // Nombre de ticks entre deux empreintes de l'état du jeu enregistrées.
 
 //!
 //! Construit le canvas de jeu, qui se charge de faire l'interface entre GameView, GameScene et GameCore.
@@ -28,13 +42,29 @@ GameCanvas::GameCanvas(GameView* pView, QObject* pParent) : QObject(pParent) {
     m_pView = pView;
     m_pGameCore = nullptr;
     m_pDetailedInfosItem = nullptr;
-
-    m_keepTicking = false;
-
-    m_tickTimer.setSingleShot(true);
-    m_tickTimer.setInterval(DEFAULT_TICK_INTERVAL);
-    m_tickTimer.setTimerType(Qt::PreciseTimer); // Important pour avoir un précision suffisante sous Windows
-    connect(&m_tickTimer, SIGNAL(timeout()), this, SLOT(onTick()));
+    m_pProfilerOverlayItem = nullptr;
+
+    m_hasPendingMouseMove = false;
+    m_pendingMouseTimestamp = 0;
+    m_coalescedMouseMoveCount = 0;
+
+    m_isTickStarted = false;
+    m_isTickSuspended = false;
+    // En jeu automatique, le tick doit continuer sur les scènes de fin de partie, que le
+    // joueur automatique quitte lui-même.
+    m_onDemandTick = !GameOptions::instance().continuousTick() && !GameOptions::instance().autoPlay();
+    m_isHeadless = false;
+    m_replayDivergenceCount = 0;
+
+    m_timeScale = 1.0;
+    m_isPaused = false;
+    m_simulationTimeRemainder = 0;
+    setTimeScale(GameOptions::instance().timeScale());
+    connect(m_pView, SIGNAL(framePainted()), this, SLOT(onFramePainted()));
+
+    m_loopScheduler.setInterval(DEFAULT_TICK_INTERVAL);
+    m_loopScheduler.setMode(GameOptions::instance().loopMode());
+    connect(&m_loopScheduler, SIGNAL(tick()), this, SLOT(onTick()));
 
     initDetailedInfos();
 
@@ -46,6 +76,19 @@ GameCanvas::GameCanvas(GameView* pView, QObject* pParent) : QObject(pParent) {
 //!
 GameCanvas::~GameCanvas()
 {
+    // Les items d'information sont retirés de la scène affichée, puis détruits, avant que
+    // GameCore ne détruise ses scènes : ils ne sont ainsi détruits qu'une fois.
+    if (m_pDetailedInfosItem) {
+        if (m_pDetailedInfosItem->scene())
+            m_pDetailedInfosItem->scene()->removeItem(m_pDetailedInfosItem);
+        delete m_pDetailedInfosItem;
+    }
+
+    if (m_pProfilerOverlayItem->scene())
+        m_pProfilerOverlayItem->scene()->removeItem(m_pProfilerOverlayItem);
+    delete m_pProfilerOverlayItem;
+    m_pProfilerOverlayItem = nullptr;
+
     delete m_pGameCore;
     m_pGameCore = nullptr;
 }
@@ -57,6 +100,7 @@ GameCanvas::~GameCanvas()
 GameScene* GameCanvas::createScene() {
     GameScene* pScene = new GameScene(this);
     pScene->installEventFilter(this);
+    connect(pScene, SIGNAL(tickRequested()), this, SLOT(onTickRequested()));
     return pScene;
 }
 
@@ -67,6 +111,7 @@ GameScene* GameCanvas::createScene() {
 GameScene* GameCanvas::createScene(const QRectF& rSceneRect) {
     GameScene* pScene = new GameScene(rSceneRect, this);
     pScene->installEventFilter(this);
+    connect(pScene, SIGNAL(tickRequested()), this, SLOT(onTickRequested()));
     return pScene;
 }
 
@@ -77,16 +122,26 @@ GameScene* GameCanvas::createScene(const QRectF& rSceneRect) {
 GameScene* GameCanvas::createScene(qreal x, qreal y, qreal width, qreal height) {
     GameScene* pScene = new GameScene(x, y, width, height, this);
     pScene->installEventFilter(this);
+    connect(pScene, SIGNAL(tickRequested()), this, SLOT(onTickRequested()));
     return pScene;
 }
 
 //! Change la scène de jeu actuellement affichée.
 void GameCanvas::setCurrentScene(GameScene* pScene) {
-    if (m_pView->scene())
+    if (TraceWriter* pTraceWriter = TraceWriter::instance())
+        pTraceWriter->addInstantEvent("GameCanvas::setCurrentScene", "scene", FrameProfiler::instance().now(),
+                                      QString("%1 x %2").arg(pScene->width()).arg(pScene->height()));
+
+    if (m_pView->scene()) {
         m_pView->scene()->removeItem(m_pDetailedInfosItem);
+        m_pView->scene()->removeItem(m_pProfilerOverlayItem);
+    }
 
     m_pView->setScene(pScene);
     m_pView->scene()->addItem(m_pDetailedInfosItem);
+    m_pView->scene()->addItem(m_pProfilerOverlayItem);
+    m_pView->updateCamera();
+    wakeUpTick();
 }
 
 //! \return un pointeur sur la scène qui est actuellement affichée par GameView.
@@ -102,19 +157,62 @@ GameScene* GameCanvas::currentScene() const {
 //!
 void GameCanvas::startTick(int tickInterval)  {
     if (tickInterval != KEEP_PREVIOUS_TICK_INTERVAL)
-        m_tickTimer.setInterval(tickInterval);
+        m_loopScheduler.setInterval(tickInterval);
 
-    m_keepTicking = true;
+    m_isTickStarted = true;
+    m_isTickSuspended = false;
     m_lastUpdateTime.start();
-    m_tickTimer.start();
+
+    // Sans fenêtre, les ticks sont enchaînés par runHeadless().
+    if (!m_isHeadless)
+        m_loopScheduler.start();
 }
 
 //!
 //! Arrête la génération du tick.
 //!
 void GameCanvas::stopTick()  {
-    m_keepTicking = false;
-    m_tickTimer.stop();
+    m_isTickStarted = false;
+    m_isTickSuspended = false;
+    m_loopScheduler.stop();
+}
+
+//! Change le facteur d'échelle du temps de simulation.
+//! Le changement n'est pas enregistré dans le journal des entrées : seuls le sont les
+//! changements demandés par le joueur (voir setUserTimeScale()).
+//! \param timeScale  Facteur d'échelle, limité entre 0 (simulation arrêtée) et 64.
+void GameCanvas::setTimeScale(double timeScale) {
+    m_timeScale = qBound(0.0, timeScale, MAX_TIME_SCALE);
+    if (m_timeScale == 0)
+        m_simulationTimeRemainder = 0;
+}
+
+//! Change le facteur d'échelle du temps à la demande du joueur (raccourcis clavier). Le
+//! changement est enregistré dans le journal des entrées, après la touche qui l'a demandé.
+//! \param timeScale  Facteur d'échelle demandé.
+void GameCanvas::setUserTimeScale(double timeScale) {
+    setTimeScale(timeScale);
+    m_inputLog.writeTimeScale(m_timeScale);
+    qDebug() << "Time scale set to " << m_timeScale;
+}
+
+//! \return le facteur d'échelle du temps de simulation.
+double GameCanvas::timeScale() const {
+    return m_timeScale;
+}
+
+//! Met en pause ou reprend la simulation. L'échelle du temps n'est pas modifiée : elle
+//! s'applique de nouveau à la reprise, même si elle a changé durant la pause.
+//! \param isPaused  Vrai pour arrêter la simulation.
+void GameCanvas::setPaused(bool isPaused) {
+    m_isPaused = isPaused;
+    if (m_isPaused)
+        m_simulationTimeRemainder = 0;
+}
+
+//! \return vrai si la simulation est en pause.
+bool GameCanvas::isPaused() const {
+    return m_isPaused;
 }
 
 //! Enclenche le suivi du déplacement de la souris.
@@ -138,12 +236,31 @@ QPointF GameCanvas::currentMousePosition() const
 //! Filtre et dispatch les événements intéressant de la scène.
 bool GameCanvas::eventFilter(QObject* pObject, QEvent* pEvent)
 {
+    // Chaque événement est horodaté à sa réception (voir InputLatencyMonitor).
+    const qint64 eventTimestamp = m_inputLatency.timestamp();
+
+    // Un événement d'entrée réveille la cadence suspendue. En rejeu, les entrées du
+    // joueur sont ignorées.
     switch (pEvent->type())  {
-    case QEvent::KeyPress:                  this->keyPressed(static_cast<QKeyEvent*>(pEvent));                         return true;
-    case QEvent::KeyRelease:                this->keyReleased(static_cast<QKeyEvent *>(pEvent));                       return true;
-    case QEvent::GraphicsSceneMouseMove:    this->mouseMoved(static_cast<QGraphicsSceneMouseEvent*>(pEvent));          return true;
-    case QEvent::GraphicsSceneMousePress:   this->mouseButtonPressed(static_cast<QGraphicsSceneMouseEvent*>(pEvent));  return true;
-    case QEvent::GraphicsSceneMouseRelease: this->mouseButtonReleased(static_cast<QGraphicsSceneMouseEvent*>(pEvent)); return true;
+    case QEvent::KeyPress:
+    case QEvent::KeyRelease:
+    case QEvent::GraphicsSceneMouseMove:
+    case QEvent::GraphicsSceneMousePress:
+    case QEvent::GraphicsSceneMouseRelease:
+        if (m_inputLog.isReplaying())
+            return true;
+        wakeUpTick();
+        break;
+    default:
+        break;
+    }
+
+    switch (pEvent->type())  {
+    case QEvent::KeyPress:                  this->keyPressed(static_cast<QKeyEvent*>(pEvent), eventTimestamp);                         return true;
+    case QEvent::KeyRelease:                this->keyReleased(static_cast<QKeyEvent *>(pEvent), eventTimestamp);                       return true;
+    case QEvent::GraphicsSceneMouseMove:    this->mouseMoved(static_cast<QGraphicsSceneMouseEvent*>(pEvent), eventTimestamp);          return true;
+    case QEvent::GraphicsSceneMousePress:   this->mouseButtonPressed(static_cast<QGraphicsSceneMouseEvent*>(pEvent), eventTimestamp);  return true;
+    case QEvent::GraphicsSceneMouseRelease: this->mouseButtonReleased(static_cast<QGraphicsSceneMouseEvent*>(pEvent), eventTimestamp); return true;
     default : return QObject::eventFilter(pObject, pEvent);
     }
 }
@@ -156,16 +273,23 @@ void GameCanvas::initDetailedInfos()
     m_pDetailedInfosItem->setPos(0,20);
     m_pDetailedInfosItem->setZValue(std::numeric_limits<qreal>::max()); // Toujours devant les autres items
     m_pDetailedInfosItem->hide();
+
+    m_pProfilerOverlayItem = new ProfilerOverlayItem;
+    m_pProfilerOverlayItem->setFrameBudget(DEFAULT_TICK_INTERVAL);
+    m_pProfilerOverlayItem->setZValue(std::numeric_limits<qreal>::max());
+    m_pProfilerOverlayItem->setMemoryMonitor(&m_memoryMonitor);
 }
 
 //! Gère l'appui sur une touche du clavier.
 //! Les répétitions automatiques sont ignorées.
-void GameCanvas::keyPressed(QKeyEvent* pKeyEvent) {
+void GameCanvas::keyPressed(QKeyEvent* pKeyEvent, qint64 eventTimestamp) {
     // Supprimer ce premier test si la répétition de touche doit être signalée.
     if (pKeyEvent->isAutoRepeat())
         pKeyEvent->ignore();
     else {
         m_pGameCore->keyPressed(pKeyEvent->key());
+        m_inputLog.writeKeyPressed(pKeyEvent->key());
+        m_inputLatency.inputApplied(eventTimestamp);
 
         if (pKeyEvent->modifiers()==(Qt::ShiftModifier|Qt::ControlModifier)) {
             switch (pKeyEvent->key()) {
@@ -173,13 +297,29 @@ void GameCanvas::keyPressed(QKeyEvent* pKeyEvent) {
                 if (m_pDetailedInfosItem)
                     m_pDetailedInfosItem->setVisible(!m_pDetailedInfosItem->isVisible());
                 break;
+            case Qt::Key_G:
+                m_pProfilerOverlayItem->setOverlayVisible(!m_pProfilerOverlayItem->isVisible());
+                break;
+            case Qt::Key_D:
+                updateMemoryMonitor();
+                qDebug().noquote() << m_memoryMonitor.report();
+                break;
             case Qt::Key_P:
-                m_tickTimer.setInterval(m_tickTimer.interval()+1);
-                qDebug() << "Tick interval set to " << m_tickTimer.interval();
+                m_loopScheduler.setInterval(m_loopScheduler.interval()+1);
+                qDebug() << "Tick interval set to " << m_loopScheduler.interval();
                 break;
             case Qt::Key_M:
-                m_tickTimer.setInterval(m_tickTimer.interval()-1);
-                qDebug() << "Tick interval set to " << m_tickTimer.interval();
+                m_loopScheduler.setInterval(m_loopScheduler.interval()-1);
+                qDebug() << "Tick interval set to " << m_loopScheduler.interval();
+                break;
+            case Qt::Key_S:
+                setUserTimeScale(m_timeScale / 2);
+                break;
+            case Qt::Key_F:
+                setUserTimeScale(m_timeScale * 2);
+                break;
+            case Qt::Key_N:
+                setUserTimeScale(1.0);
                 break;
             }
         }
@@ -188,13 +328,15 @@ void GameCanvas::keyPressed(QKeyEvent* pKeyEvent) {
 }
 
 //! Gère le relâchement d'une touche du clavier.
-void GameCanvas::keyReleased(QKeyEvent* pKeyEvent) {
+void GameCanvas::keyReleased(QKeyEvent* pKeyEvent, qint64 eventTimestamp) {
     // Supprimer ce premier test si la répétition de touche doit être signalée.
     /*
     if (pKeyEvent->isAutoRepeat())
         pKeyEvent->ignore();
     else */{
         m_pGameCore->keyReleased(pKeyEvent->key());
+        m_inputLog.writeKeyReleased(pKeyEvent->key());
+        m_inputLatency.inputApplied(eventTimestamp);
         pKeyEvent->accept();
     }
 }
@@ -202,22 +344,52 @@ void GameCanvas::keyReleased(QKeyEvent* pKeyEvent) {
 //! Gère le déplacement de la souris.
 //! Pour que cet événement soit pris en compte, la propriété MouseTracking de GameView
 //! doit être enclenchée.
-void GameCanvas::mouseMoved(QGraphicsSceneMouseEvent* pMouseEvent) {
-    m_pGameCore->mouseMoved(pMouseEvent->scenePos());
+//! Lorsque le tick est démarré, seule la dernière position reçue avant un tick est
+//! transmise à GameCore, au début de ce tick (voir flushMouseMove()).
+void GameCanvas::mouseMoved(QGraphicsSceneMouseEvent* pMouseEvent, qint64 eventTimestamp) {
+    if (!m_loopScheduler.isActive()) {
+        m_pGameCore->mouseMoved(pMouseEvent->scenePos());
+        m_inputLog.writeMouseMoved(pMouseEvent->scenePos());
+        m_inputLatency.inputApplied(eventTimestamp);
+        return;
+    }
+
+    if (m_hasPendingMouseMove)
+        m_coalescedMouseMoveCount++;
+    else
+        m_pendingMouseTimestamp = eventTimestamp;
+
+    m_hasPendingMouseMove = true;
+    m_pendingMousePosition = pMouseEvent->scenePos();
+}
+
+//! Transmet à GameCore la dernière position de la souris reçue depuis le tick précédent.
+void GameCanvas::flushMouseMove() {
+    if (!m_hasPendingMouseMove)
+        return;
+
+    m_hasPendingMouseMove = false;
+    m_pGameCore->mouseMoved(m_pendingMousePosition);
+    m_inputLog.writeMouseMoved(m_pendingMousePosition);
+    m_inputLatency.inputApplied(m_pendingMouseTimestamp);
 }
 
 //! Gère l'événement d'appui sur un bouton de la souris.
 //! La conception de cette fonction fait que GameCore n'a pas de moyen de savoir quel
 //! bouton a été pressé.
-void GameCanvas::mouseButtonPressed(QGraphicsSceneMouseEvent* pMouseEvent) {
+void GameCanvas::mouseButtonPressed(QGraphicsSceneMouseEvent* pMouseEvent, qint64 eventTimestamp) {
     m_pGameCore->mouseButtonPressed(pMouseEvent->scenePos(), pMouseEvent->buttons());
+    m_inputLog.writeMouseButtonPressed(pMouseEvent->scenePos(), pMouseEvent->buttons());
+    m_inputLatency.inputApplied(eventTimestamp);
 }
 
 //! Gère l'événement de relâchement d'un bouton de la souris.
 //! La conception de cette fonction fait que GameCore n'a pas de moyen de savoir quel
 //! bouton a été relâché.
-void GameCanvas::mouseButtonReleased(QGraphicsSceneMouseEvent* pMouseEvent) {
+void GameCanvas::mouseButtonReleased(QGraphicsSceneMouseEvent* pMouseEvent, qint64 eventTimestamp) {
     m_pGameCore->mouseButtonReleased(pMouseEvent->scenePos(), pMouseEvent->buttons());
+    m_inputLog.writeMouseButtonReleased(pMouseEvent->scenePos(), pMouseEvent->buttons());
+    m_inputLatency.inputApplied(eventTimestamp);
 }
 
 //! Instancie un objet de type GameCore, en charge de la logique du jeu.
@@ -225,13 +397,166 @@ void GameCanvas::mouseButtonReleased(QGraphicsSceneMouseEvent* pMouseEvent) {
 //! afin que GameCore n'appelle pas la fonction startTick alors que le signaux
 //! ne sont pas encore connectés.
 void GameCanvas::onInit() {
+    // En mode sans fenêtre, GameCore est déjà construit par runHeadless().
+    if (m_pGameCore == nullptr)
+        createGameCore();
+}
+
+//! Construit GameCore, puis commence l'enregistrement ou le rejeu des entrées dès que les
+//! images sont chargées (voir openInputLog()).
+void GameCanvas::createGameCore() {
     m_pGameCore = new GameCore(this, this);
+
+    // GameCore est connecté avant ce canvas : il a construit ses scènes lorsque
+    // openInputLog() est appelée.
+    AssetLoader* pAssetLoader = AssetLoader::instance();
+    if (pAssetLoader->isFinished())
+        openInputLog();
+    else
+        connect(pAssetLoader, &AssetLoader::finished, this, &GameCanvas::openInputLog);
+}
+
+//! Commence l'enregistrement (option `--record`) ou le rejeu (option `--replay`) des entrées.
+//! L'échelle du temps actuelle est enregistrée, afin que le rejeu ne dépende pas de l'option
+//! `--time-scale`. Les étapes non critiques ne sont pas sautées durant l'enregistrement ou
+//! le rejeu : l'étape d'animation déplace la caméra, qui détermine la zone cadencée à
+//! pleine fréquence, et le rejeu ne dépend ainsi pas de la durée des ticks.
+void GameCanvas::openInputLog() {
+    disconnect(AssetLoader::instance(), &AssetLoader::finished, this, &GameCanvas::openInputLog);
+    m_replayDivergenceCount = 0;
+
+    const GameOptions& rOptions = GameOptions::instance();
+    if (!rOptions.replayFileName().isEmpty()) {
+        if (!m_inputLog.open(rOptions.replayFileName()))
+            qWarning() << "Rejeu impossible :" << m_inputLog.errorString();
+    } else if (!rOptions.recordFileName().isEmpty()) {
+        if (m_inputLog.create(rOptions.recordFileName(), m_pGameCore->seed()))
+            m_inputLog.writeTimeScale(m_timeScale);
+        else
+            qWarning() << "Enregistrement des entrées impossible :" << m_inputLog.errorString();
+    }
+
+    m_tickPipeline.setSkippingEnabled(!m_inputLog.isRecording() && !m_inputLog.isReplaying());
+}
+
+//! Transmet à GameCore les entrées du journal rejoué jusqu'au prochain tick enregistré,
+//! puis traite ce tick avec le temps écoulé enregistré. Les empreintes de l'état du jeu
+//! lues en chemin sont comparées à l'état rejoué : une différence est une divergence. A la
+//! fin du journal, le rejeu s'arrête et les entrées du joueur sont de nouveau transmises.
+//! \return le temps écoulé transmis au tick, ou -1 à la fin du journal.
+long long GameCanvas::replayTick() {
+    InputLog::Record record;
+    while (m_inputLog.read(record)) {
+        switch (record.type) {
+        case InputLog::RecordTick:
+            processTick(qMax(1LL, record.elapsedTime));
+            return record.elapsedTime;
+        case InputLog::RecordKeyPressed:
+            m_pGameCore->keyPressed(record.key);
+            break;
+        case InputLog::RecordKeyReleased:
+            m_pGameCore->keyReleased(record.key);
+            break;
+        case InputLog::RecordMouseMoved:
+            m_pGameCore->mouseMoved(record.position);
+            break;
+        case InputLog::RecordMouseButtonPressed:
+            m_pGameCore->mouseButtonPressed(record.position, record.buttons);
+            break;
+        case InputLog::RecordMouseButtonReleased:
+            m_pGameCore->mouseButtonReleased(record.position, record.buttons);
+            break;
+        case InputLog::RecordTimeScale:
+            setTimeScale(record.timeScale);
+            break;
+        case InputLog::RecordChecksum:
+            if (record.checksum != m_pGameCore->stateChecksum()) {
+                // Seule la première divergence est détaillée : les suivantes en découlent.
+                if (m_replayDivergenceCount == 0)
+                    qWarning() << "Rejeu divergent à partir du tick" << m_inputLog.tickCount();
+                m_replayDivergenceCount++;
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    if (!m_inputLog.errorString().isEmpty())
+        qWarning() << "Rejeu interrompu :" << m_inputLog.errorString();
+    qDebug() << "Rejeu terminé :" << m_inputLog.tickCount() << "ticks," << m_replayDivergenceCount
+             << "empreinte(s) divergente(s)";
+    m_inputLog.close();
+    m_tickPipeline.setSkippingEnabled(true);
+    return -1;
+}
+
+//! Simule une partie sans fenêtre, aussi vite que possible, puis écrit le nombre de ticks
+//! traités par seconde dans la sortie de debug.
+//!
+//! Une fois les images chargées, la scène de jeu est affichée (GameCore::startGame()), puis
+//! les ticks sont enchaînés sans attendre le LoopScheduler. Chaque tick reçoit un temps écoulé
+//! synthétique égal à l'intervalle du tick : le résultat de la simulation ne dépend pas de la
+//! vitesse de la machine. Les événements en attente sont traités entre deux ticks ; les
+//! minuteries (QTimer) restent toutefois cadencées en temps réel.
+//! \param tickCount  Nombre de ticks à simuler.
+//! \return le code de sortie du programme : 0 si la simulation a eu lieu et, en rejeu, si
+//! elle est conforme à l'enregistrement (aucune empreinte divergente).
+int GameCanvas::runHeadless(long long tickCount) {
+    m_isHeadless = true;
+    if (m_pGameCore == nullptr)
+        createGameCore();
+
+    // La scène de jeu est construite par GameCore à la fin du chargement des images. En rejeu,
+    // la partie est démarrée par les entrées du journal.
+    AssetLoader::instance()->waitForFinished();
+    const bool isReplaying = m_inputLog.isReplaying();
+    if (!isReplaying && !m_pGameCore->startGame()) {
+        qWarning() << "Simulation sans fenêtre impossible : la scène de jeu n'a pas été construite.";
+        return 1;
+    }
+
+    // En rejeu, tous les ticks du journal sont traités, quel que soit tickCount.
+    long long simulatedTime = 0;
+    long long tick = 0;
+    QElapsedTimer runTimer;
+    runTimer.start();
+
+    for (; isReplaying || tick < tickCount; ++tick) {
+        m_lastUpdateTime.start();
+
+        long long elapsedTime = m_loopScheduler.interval();
+        if (isReplaying)
+            elapsedTime = replayTick();
+        else
+            processTick(elapsedTime);
+
+        if (elapsedTime < 0)
+            break;
+        simulatedTime += elapsedTime;
+        QCoreApplication::processEvents();
+    }
+
+    const double seconds = qMax(qint64(1), runTimer.nsecsElapsed()) / 1e9;
+    qDebug().noquote() << QString("Simulation sans fenêtre : %1 ticks en %2 s, %3 ticks/s, %4 s simulées")
+                          .arg(tick)
+                          .arg(seconds, 0, 'f', 3)
+                          .arg(tick / seconds, 0, 'f', 0)
+                          .arg(simulatedTime / 1000.0, 0, 'f', 1);
+
+    if (m_pGameCore->autoPlayer() != nullptr)
+        qDebug().noquote() << m_pGameCore->autoPlayer()->summary();
+
+    // Les pics de mémoire montrent une éventuelle fuite d'une partie à l'autre.
+    updateMemoryMonitor();
+    qDebug().noquote() << m_memoryMonitor.summary(MAX_HEADLESS_MEMORY_LINES).join('\n');
+    return m_replayDivergenceCount > 0 ? 1 : 0;
 }
 
 
 //! Traite le tick : le temps exact écoulé entre ce tick et le tick précédent
-//! est mesuré et l'objet GameCore est lui-même informé du tick.
-//! Poursuit la génération du tick si nécessaire.
+//! est mesuré, puis les étapes du tick sont traitées (processTick()).
+//! La génération du tick suivant est assurée par le LoopScheduler.
 void GameCanvas::onTick() {
     long long elapsedTime = m_lastUpdateTime.elapsed();
 
@@ -241,15 +566,156 @@ void GameCanvas::onTick() {
 
     m_lastUpdateTime.start();
 
-    m_pGameCore->tick(elapsedTime);
-    currentScene()->tick(elapsedTime);
+    // En rejeu, le tick reçoit le temps écoulé enregistré.
+    if (m_inputLog.isReplaying())
+        replayTick();
+    else
+        processTick(elapsedTime);
+
+    suspendTickIfIdle();
+}
+
+//! Traite les étapes d'un tick dans l'ordre (voir TickPipeline).
+//! \param elapsedTime  Temps écoulé depuis le tick précédent, en ms (au moins 1).
+void GameCanvas::processTick(long long elapsedTime) {
+    m_tickPipeline.beginFrame(elapsedTime);
+    FrameProfiler::instance().beginFrame();
+
+    // Temps de simulation de ce tick, selon l'échelle du temps (0 : jeu en pause).
+    const long long simulationElapsedTime = simulationTime(elapsedTime);
+
+    if (m_tickPipeline.beginStage(TickPipeline::StageInput)) {
+        flushMouseMove();
+        m_inputLog.writeTick(elapsedTime);
+        m_pGameCore->processInput(simulationElapsedTime);
+        m_tickPipeline.endStage(TickPipeline::StageInput);
+    }
+
+    // En pause, les étapes de simulation ne sont pas traitées.
+    if (simulationElapsedTime > 0 && m_tickPipeline.beginStage(TickPipeline::StagePhysics)) {
+        GameScene* pScene = currentScene();
+        pScene->setTickProfile(m_tickPipeline.spriteTypeProfile());
+
+        // Le temps de simulation est découpé en pas de durée limitée.
+        const long long stepCount = (simulationElapsedTime + MAX_SIMULATION_STEP - 1) / MAX_SIMULATION_STEP;
+        for (long long step = 0; step < stepCount; ++step) {
+            const long long stepStart = simulationElapsedTime * step / stepCount;
+            pScene->tick(simulationElapsedTime * (step + 1) / stepCount - stepStart);
+        }
+
+        pScene->setTickProfile(nullptr);
+        m_tickPipeline.endStage(TickPipeline::StagePhysics);
+    }
+
+    if (simulationElapsedTime > 0 && m_tickPipeline.beginStage(TickPipeline::StageGameplay)) {
+        m_pGameCore->tick(simulationElapsedTime);
+        m_tickPipeline.endStage(TickPipeline::StageGameplay);
+    }
 
-    if (m_pDetailedInfosItem && m_pDetailedInfosItem->isVisible())
-        m_pDetailedInfosItem->setPlainText(QString("FPS : %1, Elapsed : %2ms, Tick duration : %3ms")
-                                      .arg(1000/elapsedTime)
-                                      .arg(elapsedTime)
-                                      .arg(m_lastUpdateTime.elapsed()));
+    if (m_tickPipeline.beginStage(TickPipeline::StageAnimation)) {
+        m_pGameCore->animate(m_tickPipeline.stageTime(TickPipeline::StageAnimation));
+        m_pView->updateCamera();
+        m_tickPipeline.endStage(TickPipeline::StageAnimation);
+    }
+
+    if (m_tickPipeline.beginStage(TickPipeline::StageHud)) {
+        if (m_pDetailedInfosItem && m_pDetailedInfosItem->isVisible())
+            m_pDetailedInfosItem->setPlainText(QString("FPS : %1, Elapsed : %2ms, Tick duration : %3ms\n"
+                                                       "Rate : %4Hz, Jitter p99 : %5ms, Load : %6%, Missed : %7, Mode : %8\n"
+                                                       "Physics : %9ms, Skipped (animation/hud) : %10/%11\n"
+                                                       "Input latency p50/p99/max : %12/%13/%14ms, Coalesced moves : %15")
+                                          .arg(1000/elapsedTime)
+                                          .arg(elapsedTime)
+                                          .arg(m_lastUpdateTime.elapsed())
+                                          .arg(m_loopScheduler.achievedRate(), 0, 'f', 1)
+                                          .arg(m_loopScheduler.jitterP99(), 0, 'f', 2)
+                                          .arg(int(m_loopScheduler.load() * 100))
+                                          .arg(m_loopScheduler.missedTickCount())
+                                          .arg(LoopScheduler::modeName(m_loopScheduler.activeMode()))
+                                          .arg(m_tickPipeline.lastDuration(TickPipeline::StagePhysics), 0, 'f', 2)
+                                          .arg(m_tickPipeline.skippedCount(TickPipeline::StageAnimation))
+                                          .arg(m_tickPipeline.skippedCount(TickPipeline::StageHud))
+                                          .arg(m_inputLatency.latencyP50(), 0, 'f', 1)
+                                          .arg(m_inputLatency.latencyP99(), 0, 'f', 1)
+                                          .arg(m_inputLatency.latencyMax(), 0, 'f', 1)
+                                          .arg(m_coalescedMouseMoveCount));
+        if (m_pProfilerOverlayItem->isVisible()) {
+            if (!m_memoryUpdateTimer.isValid() || m_memoryUpdateTimer.elapsed() >= MEMORY_UPDATE_INTERVAL)
+                updateMemoryMonitor();
+            m_pProfilerOverlayItem->setFrameBudget(m_loopScheduler.interval());
+            m_pProfilerOverlayItem->setPos(m_pView->mapToScene(PROFILER_OVERLAY_POS));
+            m_pProfilerOverlayItem->update();
+        }
+        m_tickPipeline.endStage(TickPipeline::StageHud);
+    }
+
+    // Empreinte de l'état du jeu après ce tick, vérifiée lors du rejeu.
+    if (m_inputLog.isRecording() && m_inputLog.tickCount() % REPLAY_CHECK_INTERVAL == 0)
+        m_inputLog.writeChecksum(m_pGameCore->stateChecksum());
+
+    m_tickPipeline.endFrame();
+}
+
+//! Fait un relevé de la mémoire occupée par toutes les scènes créées (affichées ou non) et par
+//! le cache d'images.
+void GameCanvas::updateMemoryMonitor() {
+    m_memoryMonitor.update(findChildren<GameScene*>(QString(), Qt::FindDirectChildrenOnly));
+    m_memoryUpdateTimer.start();
+}
+
+//! Calcule le temps de simulation correspondant au temps écoulé, selon l'échelle du temps
+//! (nulle durant la pause).
+//! La fraction de milliseconde restante est reportée au tick suivant. Le temps de
+//! simulation d'un tick est limité à MAX_SIMULATION_STEPS pas : au-delà, le temps est perdu
+//! plutôt que de prolonger le tick.
+//! \param elapsedTimeInMilliseconds  Temps réel écoulé depuis le tick précédent.
+//! \return le temps de simulation, en millisecondes.
+long long GameCanvas::simulationTime(long long elapsedTimeInMilliseconds) {
+    const double effectiveTimeScale = m_isPaused ? 0 : m_timeScale;
+    const double scaledTime = elapsedTimeInMilliseconds * effectiveTimeScale + m_simulationTimeRemainder;
+    const long long simulationTime = static_cast<long long>(scaledTime);
+    m_simulationTimeRemainder = scaledTime - simulationTime;
+
+    return qMin(simulationTime, MAX_SIMULATION_STEP * MAX_SIMULATION_STEPS);
+}
+
+//! Reprend la cadence si elle a été suspendue parce que la scène était inactive.
+//! Le temps écoulé durant la suspension n'est pas transmis au tick suivant.
+void GameCanvas::wakeUpTick() {
+    if (!m_isTickSuspended)
+        return;
+
+    m_isTickSuspended = false;
+    m_lastUpdateTime.start();
+    m_loopScheduler.start();
+    FrameProfiler::instance().resetFrameClock();
+}
+
+//! Suspend la cadence si la scène affichée est inactive (cadence à la demande).
+//! La cadence n'est pas suspendue tant que les informations détaillées sont affichées ou
+//! qu'un déplacement de la souris reste à transmettre.
+void GameCanvas::suspendTickIfIdle() {
+    if (!m_onDemandTick || !m_isTickStarted || m_hasPendingMouseMove || m_inputLog.isReplaying())
+        return;
+
+    if ((m_pDetailedInfosItem && m_pDetailedInfosItem->isVisible()) || m_pProfilerOverlayItem->isVisible())
+        return;
+
+    if (!currentScene()->isIdle())
+        return;
+
+    m_isTickSuspended = true;
+    m_loopScheduler.stop();
+}
+
+//! Un sprite s'est abonné à la cadence d'une scène qui n'avait aucun sprite cadencé :
+//! la cadence est reprise si elle était suspendue.
+void GameCanvas::onTickRequested() {
+    wakeUpTick();
+}
 
-    if (m_keepTicking)
-        m_tickTimer.start();
+//! Une image vient d'être dessinée par GameView : la latence des entrées transmises
+//! depuis l'image précédente est mesurée.
+void GameCanvas::onFramePainted() {
+    m_inputLatency.framePresented();
 }
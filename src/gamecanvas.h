@@ -13,11 +13,18 @@
 #include <QTimer>
 #include <QElapsedTimer>
 
+#include "inputlatencymonitor.h"
+#include "inputlog.h"
+#include "loopscheduler.h"
+#include "memorymonitor.h"
+#include "tickpipeline.h"
+
 class GameCore;
 class GameScene;
 class GameView;
 class QGraphicsSceneMouseEvent;
 class QGraphicsTextItem;
+class ProfilerOverlayItem;
 class QKeyEvent;
 
 //! \brief Classe de gestion des scènes du jeu et de sa cadence.
@@ -35,13 +42,57 @@ class QKeyEvent;
 //! Cette classe implémente également le mécanisme de cadence du jeu (le tick).
 //!
 //! Pour démarrer le tick, utiliser la commande startTick(). Dès que le tick est démarré, la méthode GameCore::tick() est
-//! appelée régulièrement, toutes les 20 millisecondes par défaut.
+//! appelée régulièrement, toutes les 10 millisecondes par défaut. La cadence est générée par un LoopScheduler, qui vise
+//! des échéances absolues (le temps de traitement d'un tick ne s'ajoute pas à la période) et mesure la fréquence
+//! obtenue et la gigue de réveil, affichées avec les informations détaillées (Ctrl+Shift+I).
+//!
+//! Le traitement d'un tick est découpé en étapes (voir TickPipeline) : entrées (GameCore::processInput()), physique
+//! (GameScene::tick()), logique de jeu (GameCore::tick()), animation (GameCore::animate() et la caméra de GameView) et
+//! informations détaillées. Chaque étape a un budget de temps ; les étapes d'animation et d'informations peuvent être
+//! sautées lorsque le tick est trop long.
+//!
+//! Les déplacements de la souris reçus entre deux ticks sont regroupés : seule la dernière position est transmise à
+//! GameCore, au début du tick suivant (étape d'entrée). Chaque événement d'entrée est horodaté à sa réception, et la
+//! latence jusqu'à l'image qui le montre est mesurée par un InputLatencyMonitor.
+//!
+//! Un facteur d'échelle du temps (setTimeScale()) est appliqué au temps transmis aux étapes de simulation (physique et
+//! logique de jeu) : 0 arrête la simulation, une valeur inférieure à 1 la ralentit et une valeur supérieure l'accélère.
+//! La pause du jeu (setPaused()) est indépendante de ce facteur : elle arrête la simulation sans le modifier.
+//! Le temps de simulation d'un tick est découpé en pas d'au plus MAX_SIMULATION_STEP ms, afin que les collisions
+//! restent détectées en accéléré. Ctrl+Shift+S divise le facteur par deux, Ctrl+Shift+F le double et Ctrl+Shift+N le
+//! remet à 1.
+//!
+//! Ctrl+Shift+G affiche ou cache les mesures du FrameProfiler (ProfilerOverlayItem) : centiles de la durée des images et
+//! durée moyenne de chaque partie mesurée. Les mesures sont suivies d'un résumé de la mémoire occupée par les scènes, les
+//! sprites et les images (voir MemoryMonitor), relevée chaque seconde. Ctrl+Shift+D écrit le détail de ce relevé dans
+//! la sortie de debug.
 //!
 //! Elle se charge alors d'appeler la méthode GameCore::tick() et GameScene::tick() de façon
 //! à ce que ces classes puissent réagir à la cadence.
 //!
 //! Pour stopper le tick, utiliser la commande stopTick().
 //!
+//! Cadence à la demande : lorsque la scène affichée est inactive (GameScene::isIdle(), par exemple les scènes de menu),
+//! le tick est suspendu après avoir été traité, et la vue n'est redessinée que si la scène change. Le tick reprend
+//! dès qu'un événement d'entrée est reçu, que la scène affichée change ou qu'un sprite s'abonne à la cadence. Ce mode
+//! peut être désactivé avec l'option `--continuous-tick`.
+//!
+//! Mode sans fenêtre (option `--headless`) : runHeadless() simule une partie aussi vite que possible, sans
+//! LoopScheduler. Chaque tick reçoit un temps écoulé synthétique égal à l'intervalle du tick, ce qui rend la simulation
+//! indépendante de la vitesse de la machine, et le nombre de ticks traités par seconde est écrit à la fin. Avec
+//! l'option `--autoplay`, les parties sont jouées automatiquement (voir AutoPlayer) ; le nombre de parties jouées et les
+//! pics de mémoire sont alors aussi écrits.
+//!
+//! Enregistrement et rejeu des entrées : avec l'option `--record`, chaque entrée transmise à GameCore et chaque tick
+//! sont écrits dans un InputLog ; avec l'option `--replay`, le journal est relu et ses entrées sont transmises à GameCore
+//! dans le même ordre, chaque tick recevant le temps écoulé enregistré. Les entrées du joueur sont alors ignorées. Le
+//! journal ne commence qu'une fois les images chargées, GameCore ignorant les entrées reçues avant. Seuls les
+//! changements d'échelle du temps demandés par le joueur sont enregistrés, après la touche qui les a demandés : ceux
+//! que GameCore fait lui-même (pause avec Echap) se reproduisent en rejouant cette touche. Tous les 100 ticks, une
+//! empreinte de l'état du jeu est aussi enregistrée et comparée à l'état rejoué. Un aller-retour se vérifie ainsi :
+//! enregistrer une partie avec `--record` en la mettant en pause puis en la reprenant, puis la rejouer avec
+//! `--headless --replay` ; le programme se termine avec le code 1 si le rejeu diverge.
+//!
 //! GameCanvas permet également d'enclencher le suivi des déplacements de la souris (startMouseTracking() et de
 //! le stopper (stopMouseTracking()).
 class GameCanvas : public QObject
@@ -64,10 +115,17 @@ public:
     void startTick(int tickInterval = KEEP_PREVIOUS_TICK_INTERVAL);
     void stopTick();
 
+    void setTimeScale(double timeScale);
+    double timeScale() const;
+    void setPaused(bool isPaused);
+    bool isPaused() const;
+
     void startMouseTracking();
     void stopMouseTracking();
     QPointF currentMousePosition() const;
 
+    int runHeadless(long long tickCount);
+
 signals:
 
 public slots:
@@ -78,25 +136,55 @@ protected:
 private:
     void initDetailedInfos();
 
-    void keyPressed(QKeyEvent* pKeyEvent);
-    void keyReleased(QKeyEvent* pKeyEvent);
-
-    void mouseMoved(QGraphicsSceneMouseEvent* pMouseEvent);
-    void mouseButtonPressed(QGraphicsSceneMouseEvent* pMouseEvent);
-    void mouseButtonReleased(QGraphicsSceneMouseEvent* pMouseEvent);
+    void keyPressed(QKeyEvent* pKeyEvent, qint64 eventTimestamp);
+    void keyReleased(QKeyEvent* pKeyEvent, qint64 eventTimestamp);
+
+    void mouseMoved(QGraphicsSceneMouseEvent* pMouseEvent, qint64 eventTimestamp);
+    void mouseButtonPressed(QGraphicsSceneMouseEvent* pMouseEvent, qint64 eventTimestamp);
+    void mouseButtonReleased(QGraphicsSceneMouseEvent* pMouseEvent, qint64 eventTimestamp);
+    void flushMouseMove();
+    void processTick(long long elapsedTime);
+    long long replayTick();
+    void setUserTimeScale(double timeScale);
+    void createGameCore();
+    void wakeUpTick();
+    void suspendTickIfIdle();
+    long long simulationTime(long long elapsedTimeInMilliseconds);
+    void updateMemoryMonitor();
 
     GameView* m_pView;
     GameCore* m_pGameCore;
     QPointer<QGraphicsTextItem> m_pDetailedInfosItem; // Smart Pointer pour qu'il soit mis à zéro au cas où l'item est effacé par GameScene::clear()
-
-    bool m_keepTicking;
+    ProfilerOverlayItem* m_pProfilerOverlayItem;
+    MemoryMonitor m_memoryMonitor;
+    QElapsedTimer m_memoryUpdateTimer;
 
     QElapsedTimer m_lastUpdateTime;
-    QTimer m_tickTimer;
+    LoopScheduler m_loopScheduler;
+    TickPipeline m_tickPipeline;
+    bool m_isTickStarted;
+    bool m_isTickSuspended;
+    bool m_onDemandTick;
+    bool m_isHeadless;
+    int m_replayDivergenceCount;        // Empreintes de l'état du jeu différentes de l'enregistrement.
+
+    InputLatencyMonitor m_inputLatency;
+    InputLog m_inputLog;
+    bool m_hasPendingMouseMove;
+    QPointF m_pendingMousePosition;
+    qint64 m_pendingMouseTimestamp;     // Horodatage du plus ancien déplacement regroupé.
+    long long m_coalescedMouseMoveCount;
+
+    double m_timeScale;
+    bool m_isPaused;
+    double m_simulationTimeRemainder;   // Fraction de milliseconde de simulation reportée au tick suivant.
 
 private slots:
     void onInit();
     void onTick();
+    void onFramePainted();
+    void onTickRequested();
+    void openInputLog();
 
 };
 
@@ -7,15 +7,16 @@
 #include "gamecore.h"
 
 #include <cmath>
-#include <random>
-#include <ctime>
-#include <windows.h>
+#include <cstring>
 
 #include <QColor>
 #include <QtCore>
 #include <QCoreApplication>
 #include <QCursor>
+#include <QDateTime>
 #include <QDebug>
+#include <QBuffer>
+#include <QElapsedTimer>
 #include <QGraphicsScale>
 #include <QPainter>
 #include <QSettings>
@@ -23,13 +24,22 @@
 #include <QTime>
 #include <QTimer>
 
+#include "assetloader.h"
+#include "autoplayer.h"
 #include "ball.h"
+#include "brick.h"
 #include "bouncingspritehandler.h"
+#include "endlessfield.h"
+#include "frameprofiler.h"
 #include "gamescene.h"
 #include "gamecanvas.h"
+#include "gameoptions.h"
+#include "levelgenerator.h"
+#include "levelreader.h"
 #include "plate.h"
 #include "resources.h"
 #include "sprite.h"
+#include "staticsprite.h"
 #include "utilities.h"
 
 // Initialisation des constantes.
@@ -39,30 +49,122 @@ const int BORDER_SIZE = 10;
 const int PLAYER_LIFES = 3;
 const QPoint BRICK_SIZE(65, 20);
 const QPointF BOUNCING_AREA_POS(0, 0);
-const QPointF BOUNCING_AREA_SIZE(SCENE_WIDTH, SCENE_HEIGHT);
+const int LOADING_TEXT_SIZE = 30;
+const int BRICKS_TOP = 50;
+const int PLAY_AREA_HEIGHT = 500;  // Hauteur minimale entre les briques et le bas de la scène.
+const char DEFAULT_LEVEL_FILE[] = "levels/level1.txt";
+const char DEFAULT_LEVEL[] = "..????????..\n"
+                             "????????????\n"
+                             ".??????????.\n";
+const long long MAX_AUTOPLAY_GAME_TIME = 600000; // Temps de jeu (en ms) au-delà duquel une partie automatique est abandonnée.
+const int SCENE_PREWARM_DELAY = 500; // Délai (en ms) avant la construction des scènes en arrière-plan.
+const quint64 CHECKSUM_BASIS = 14695981039346656037ULL; // Valeur initiale de l'empreinte (FNV-1a).
+const quint64 CHECKSUM_PRIME = 1099511628211ULL;        // Multiplicateur de l'empreinte (FNV-1a).
+
+//! Ajoute une valeur à une empreinte FNV-1a.
+//! \param checksum  Empreinte en cours.
+//! \param value     Valeur à ajouter, octet par octet.
+//! \return la nouvelle empreinte.
+static quint64 addToChecksum(quint64 checksum, quint64 value) {
+    for (int i = 0; i < 8; ++i) {
+        checksum = (checksum ^ (value & 0xFF)) * CHECKSUM_PRIME;
+        value >>= 8;
+    }
+    return checksum;
+}
+
+//! \return la représentation binaire du nombre donné, à ajouter à une empreinte.
+static quint64 doubleBits(double value) {
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+//! \brief Gestionnaire de lecture de niveau qui ajoute les briques lues à la scène de jeu.
+//! Si le niveau est plus grand que la scène, la scène est agrandie (une caméra n'en montre
+//! alors qu'une partie, voir GameCore::initGame()). Le niveau est centré horizontalement dans la scène. Les couleurs aléatoires sont
+//! tirées avec le générateur donné, afin d'être reproductibles.
+class BrickLevelBuilder : public LevelReader::Handler
+{
+public:
+    BrickLevelBuilder(GameScene* pScene, const QList<QString>& rBrickColors, RandomGenerator& rRandom)
+        : m_pScene(pScene), m_rRandom(rRandom), m_originX(0) {
+        // Les images sont récupérées une fois pour toutes, et non pour chaque brique.
+        for (int i = 0; i < LevelReader::BrickColorCount; ++i)
+            m_brickPixmaps[i] = AssetLoader::instance()->pixmap("brick" + rBrickColors.value(i) + ".png");
+    }
+
+    void beginLevel(int columnCount, int rowCount) {
+        const int levelWidth = (columnCount + 2) * BRICK_SIZE.x();
+        const int levelHeight = BRICKS_TOP + rowCount * BRICK_SIZE.y() + PLAY_AREA_HEIGHT;
+        if (levelWidth > m_pScene->width())
+            m_pScene->setWidth(levelWidth);
+        if (levelHeight > m_pScene->height())
+            m_pScene->setHeight(levelHeight);
+
+        m_originX = (m_pScene->width() - (columnCount * BRICK_SIZE.x())) / 2;
+    }
+
+    void addBricks(int row, int column, LevelReader::BrickType type, int count, int hitPoints) {
+        for (int i = 0; i < count; ++i) {
+            int colorIndex = (type == LevelReader::BrickRandom) ? int(m_rRandom.bounded(LevelReader::BrickColorCount))
+                                                                : type - LevelReader::BrickBlue;
+
+            Brick* pBrick = new Brick(m_brickPixmaps[colorIndex], hitPoints);
+            pBrick->setPos(m_originX + (column + i) * BRICK_SIZE.x(), BRICKS_TOP + row * BRICK_SIZE.y());
+            pBrick->setScale(0.5);
+            if (colorIndex + LevelReader::BrickBlue == LevelReader::BrickGray) {
+                // Une brique incassable se comporte comme un mur.
+                pBrick->setCategory(StaticSprite::CategoryWall);
+            } else {
+                pBrick->setCategory(StaticSprite::CategoryBrick);
+            }
+            m_pScene->addSpriteToScene(pBrick);
+        }
+    }
+
+private:
+    GameScene* m_pScene;
+    RandomGenerator& m_rRandom;
+    QPixmap m_brickPixmaps[LevelReader::BrickColorCount];
+    int m_originX;
+};
 
 //! Initialise le contrôleur de jeu.
 //! \param pGameCanvas  GameCanvas pour lequel cet objet travaille.
 //! \param pParent      Pointeur sur le parent (afin d'obtenir une destruction automatique de cet objet).
 GameCore::GameCore(GameCanvas* pGameCanvas, QObject* pParent) : QObject(pParent) {
 
-    // Initialise le générateur pseudo-aléatoire.
-    std::srand(std::time(nullptr));
+    // Initialise le générateur pseudo-aléatoire. La graine est affichée afin de
+    // pouvoir rejouer une partie identique avec l'option --seed.
+    const GameOptions& rOptions = GameOptions::instance();
+    m_seed = rOptions.hasSeed() ? rOptions.seed() : quint64(QDateTime::currentMSecsSinceEpoch());
+    m_random.seed(m_seed);
+    qDebug() << "Graine du générateur pseudo-aléatoire :" << m_seed;
+
+    // Jeu automatique, reproductible pour une même graine.
+    if (rOptions.autoPlay())
+        m_pAutoPlayer = new AutoPlayer(m_seed);
 
     // Mémorise l'accès au canvas (qui gère le tick et l'affichage d'une scène).
     m_pGameCanvas = pGameCanvas;
 
-    // Crée les scènes de menu.
+    // Crée la scène de démarrage, qui affiche la progression du chargement des images,
+    // et la définit comme scène actuelle.
     createSceneStart();
-    createSceneMenu();
-    createSceneWin();
-    createSceneLoss();
-
-    // Définis la scène actuelle (Scène de démarrage).
     pGameCanvas->setCurrentScene(m_pSceneStart);
 
-    // Initalise tout les éléments du du jeu.
-    initGame();
+    // Charge les images en arrière-plan. Les autres scènes et les éléments du jeu
+    // sont créés une fois le chargement terminé (onAssetsLoaded()).
+    AssetLoader* pAssetLoader = AssetLoader::instance();
+    connect(pAssetLoader, &AssetLoader::progressChanged, this, &GameCore::onAssetLoadingProgress);
+    connect(pAssetLoader, &AssetLoader::finished, this, &GameCore::onAssetsLoaded);
+    pAssetLoader->load(imageNames());
+
+    // Les scènes de menu, de victoire et de défaite sont construites à la demande
+    // ou, lorsque l'application est inoccupée, par onPrewarmTimeout().
+    m_prewarmTimer.setInterval(0);
+    connect(&m_prewarmTimer, &QTimer::timeout, this, &GameCore::onPrewarmTimeout);
 
     // Démarre le tick pour que les animations qui en dépendent fonctionnent correctement.
     m_pGameCanvas->startTick();
@@ -70,6 +172,12 @@ GameCore::GameCore(GameCanvas* pGameCanvas, QObject* pParent) : QObject(pParent)
 
 //! Destructeur de GameCore : efface les scènes
 GameCore::~GameCore() {
+    delete m_pEndlessField;
+    m_pEndlessField = nullptr;
+
+    delete m_pAutoPlayer;
+    m_pAutoPlayer = nullptr;
+
     delete m_pSceneGame;
     m_pSceneGame = nullptr;
 }
@@ -77,43 +185,201 @@ GameCore::~GameCore() {
 //! Initialise les éléments du jeu.
 void GameCore::initGame() {    
     createSceneGame();  // Création de la scène de jeu.
+    createBricks();     // Création des blocs à détruire (peut agrandir la scène).
     setupBoucingArea(); // Création des murs.
-    createBricks();     // Création des blocs à détruire.
     createPlate();      // Création du plateau.
     createBall();       // Création de la balle.
     createLife();       // Création de l'UI.
+    setupCamera();      // Caméra, si la scène est plus grande que l'écran.
 }
 
 //! Reinitialise les éléments du jeu et change la scène actuelle.
+//! La scène de la partie précédente, qui n'est plus affichée, est détruite avec ses sprites.
 void GameCore::restartGame() {
-    m_pCounterBall = 0;
+    GameScene* pPreviousSceneGame = m_pSceneGame;
+
+    resumeGame();
     initGame();
     changeCurrentScene(m_pSceneGame);
+
+    delete pPreviousSceneGame;
 }
 
 
-//! Cadence.
-//! Gère le déplacement de la Terre qui tourne en cercle.
+//! Affiche la scène de jeu, comme le bouton Start de la scène de démarrage.
+//! \return faux si la scène de jeu n'existe pas encore (images en cours de chargement).
+bool GameCore::startGame() {
+    if (m_pSceneGame == nullptr)
+        return false;
+
+    changeCurrentScene(m_pSceneGame);
+    return true;
+}
+
+//! Etape d'entrée de la cadence (voir TickPipeline) : tant que la balle n'est pas lancée,
+//! elle est placée sur le plateau, puis lancée au clic du joueur.
 //! \param elapsedTimeInMilliseconds  Temps écoulé depuis le dernier appel.
-void GameCore::tick(long long elapsedTimeInMilliseconds) {
+void GameCore::processInput(long long elapsedTimeInMilliseconds) {
+    // La scène de jeu n'existe pas tant que les images sont en cours de chargement.
+    if (m_pSceneGame == nullptr)
+        return;
+
+    if (m_pAutoPlayer != nullptr)
+        autoPlay(elapsedTimeInMilliseconds);
+
     if (m_pIsWaiting) {
-        m_pBall->setPos(m_pPlate->left() + ((m_pPlate->width() / 2.0) - (m_pBall->width() / 2.0)), m_pPlate->top() - m_pBall->height());
+        StaticSprite* pPlate = m_pSceneGame->sprite(m_plateHandle);
+        Sprite* pBall = static_cast<Sprite*>(m_pSceneGame->sprite(m_ballHandle));
 
-        if (m_pOnClick) {
-            m_pBall->registerForTick();
-            m_pOnClick = false;
-            m_pIsWaiting = false;
-            m_pBall = nullptr;
+        if (pPlate && pBall) {
+            pBall->setPos(pPlate->left() + ((pPlate->width() / 2.0) - (pBall->width() / 2.0)), pPlate->top() - pBall->height());
+
+            if (m_pOnClick) {
+                pBall->registerForTick();
+                m_pOnClick = false;
+                m_pIsWaiting = false;
+                m_ballHandle = SpriteHandle();
+            }
         }
     }
+}
+
+//! Etape de logique de jeu de la cadence (voir TickPipeline), traitée après la
+//! cadence des sprites : vies, victoire et défaite.
+//! \param elapsedTimeInMilliseconds  Temps écoulé depuis le dernier appel.
+void GameCore::tick(long long elapsedTimeInMilliseconds) {
+    ProfileScope profileScope("GameCore::tick");
+
+    // La scène de jeu n'existe pas tant que les images sont en cours de chargement.
+    if (m_pSceneGame == nullptr)
+        return;
+
+    // Les balles sont comptées par le registre de la scène : s'il n'en reste
+    // plus en jeu, le joueur perd une vie.
+    if (!m_pIsWaiting && m_pSceneGame->spriteCount(StaticSprite::CategoryBall) == 0)
+        loseLife();
+
+    // En mode sans fin, les briques défilent tant que la balle est en jeu, et la partie
+    // ne se termine que lorsque le joueur n'a plus de vie.
+    if (m_pEndlessField != nullptr) {
+        if (!m_pIsWaiting && m_pGameCanvas->currentScene() == m_pSceneGame)
+            m_pEndlessField->tick(elapsedTimeInMilliseconds);
+
+        if (m_pPlayerLife == 0)
+            changeCurrentScene(lazyScene(LazySceneLoss));
+        return;
+    }
+
+    int brickCount = m_pSceneGame->spriteCount(StaticSprite::CategoryBrick);
+
+    if (brickCount == 0 && m_pPlayerLife > 0) {
+        changeCurrentScene(lazyScene(LazySceneWin));
+    }
+
+    if (brickCount > 0 && m_pPlayerLife == 0) {
+        changeCurrentScene(lazyScene(LazySceneLoss));
+    }
+}
+
+//! Etape d'animation de la cadence (voir TickPipeline) : la caméra suit la balle en jeu
+//! ou, en attendant le lancement, le plateau. Cette étape peut être sautée lorsque le
+//! tick est trop long : le temps reçu est alors celui écoulé depuis son dernier traitement.
+//! \param elapsedTimeInMilliseconds  Temps écoulé depuis le dernier appel.
+void GameCore::animate(long long elapsedTimeInMilliseconds) {
+    if (m_pSceneGame == nullptr)
+        return;
+
+    Camera& rCamera = m_pSceneGame->camera();
+    if (rCamera.isEnabled()) {
+        const QVector<StaticSprite*>& rBalls = m_pSceneGame->sprites(StaticSprite::CategoryBall);
+        StaticSprite* pTarget = (!m_pIsWaiting && !rBalls.isEmpty()) ? rBalls.first() : m_pSceneGame->sprite(m_plateHandle);
+        if (pTarget)
+            rCamera.follow(pTarget->globalBoundingBox().center(), elapsedTimeInMilliseconds);
+    }
+}
+
+//! \return le joueur automatique, ou nullptr si le jeu n'est pas joué automatiquement
+//! (option `--autoplay`).
+const AutoPlayer* GameCore::autoPlayer() const {
+    return m_pAutoPlayer;
+}
+
+//! \return la graine du générateur pseudo-aléatoire, dont dépendent les niveaux.
+quint64 GameCore::seed() const {
+    return m_seed;
+}
+
+//! Calcule une empreinte de l'état du jeu : scène affichée, pause, vies, nombre de
+//! briques, et position et vitesse des balles et du plateau. Deux exécutions qui
+//! reçoivent les mêmes entrées ont la même empreinte après chaque tick (voir InputLog).
+//! \return l'empreinte de l'état du jeu.
+quint64 GameCore::stateChecksum() const {
+    const GameScene* pCurrentScene = m_pGameCanvas->currentScene();
+    // Indice de la scène affichée (5 si aucune de ces scènes n'est affichée).
+    const GameScene* scenes[] = { m_pSceneStart, m_pSceneGame, m_pSceneMenu, m_pSceneWin, m_pSceneLoss };
+    int sceneIndex = 0;
+    while (sceneIndex < 5 && scenes[sceneIndex] != pCurrentScene)
+        sceneIndex++;
+
+    quint64 checksum = CHECKSUM_BASIS;
+    checksum = addToChecksum(checksum, quint64(sceneIndex));
+    checksum = addToChecksum(checksum, m_isPaused);
+    checksum = addToChecksum(checksum, quint64(m_pPlayerLife));
+    if (m_pSceneGame == nullptr)
+        return checksum;
+
+    checksum = addToChecksum(checksum, quint64(m_pSceneGame->spriteCount(StaticSprite::CategoryBrick)));
+    for (StaticSprite* pSprite : m_pSceneGame->sprites(StaticSprite::CategoryBall)) {
+        Ball* pBall = static_cast<Ball*>(pSprite);
+        checksum = addToChecksum(checksum, doubleBits(pBall->x()));
+        checksum = addToChecksum(checksum, doubleBits(pBall->y()));
+        checksum = addToChecksum(checksum, doubleBits(pBall->getSpriteVelocity().x()));
+        checksum = addToChecksum(checksum, doubleBits(pBall->getSpriteVelocity().y()));
+    }
+    for (StaticSprite* pPlate : m_pSceneGame->sprites(StaticSprite::CategoryPlate)) {
+        checksum = addToChecksum(checksum, doubleBits(pPlate->x()));
+        checksum = addToChecksum(checksum, doubleBits(pPlate->y()));
+    }
+    return checksum;
+}
+
+//! Joue à la place du joueur : démarre une partie depuis la scène de démarrage, déplace
+//! le plateau comme la souris (Plate::onMouseMoved()), lance la balle dès qu'elle est posée
+//! sur le plateau et recommence une partie dès que la précédente est terminée. Une partie
+//! qui dure plus de MAX_AUTOPLAY_GAME_TIME (balle coincée entre des briques incassables)
+//! est abandonnée.
+//! \param elapsedTimeInMilliseconds  Temps de simulation écoulé depuis le dernier appel.
+void GameCore::autoPlay(long long elapsedTimeInMilliseconds) {
+    GameScene* pCurrentScene = m_pGameCanvas->currentScene();
+
+    if (pCurrentScene == m_pSceneStart) {
+        startGame();
+        return;
+    }
 
-    if (m_pCounterBricks == 0 && m_pPlayerLife > 0) {
-        changeCurrentScene(m_pSceneWin);
+    if (pCurrentScene != m_pSceneGame) {
+        if (pCurrentScene == m_pSceneWin || pCurrentScene == m_pSceneLoss) {
+            m_pAutoPlayer->gameFinished(pCurrentScene == m_pSceneWin);
+            restartGame();
+        }
+        return;
     }
 
-    if (m_pCounterBricks > 0 && m_pPlayerLife == 0) {
-        changeCurrentScene(m_pSceneLoss);
+    m_pAutoPlayer->addGameTime(elapsedTimeInMilliseconds);
+    if (m_pAutoPlayer->gameTime() > MAX_AUTOPLAY_GAME_TIME) {
+        m_pAutoPlayer->gameAbandoned();
+        restartGame();
+        return;
     }
+
+    StaticSprite* pPlate = m_pSceneGame->sprite(m_plateHandle);
+    if (pPlate == nullptr)
+        return;
+
+    mouseMoved(m_pAutoPlayer->mousePosition(m_pSceneGame, pPlate));
+
+    if (m_pIsWaiting)
+        m_pOnClick = true;
 }
 
 //! Traite la pression d'une touche.
@@ -121,11 +387,14 @@ void GameCore::tick(long long elapsedTimeInMilliseconds) {
 void GameCore::keyPressed(int key) {
     emit notifyKeyPressed(key);
 
+    if (!m_assetsLoaded)
+        return;
+
     switch (key) {
     // A la pression de la touche ESC, affiche le menu.
     case Qt::Key_Escape:
-        emit notifyOnPause();
-        changeCurrentScene(m_pSceneMenu);
+        pauseGame();
+        changeCurrentScene(lazyScene(LazySceneMenu));
         break;
     }
 }
@@ -149,6 +418,10 @@ void GameCore::mouseMoved(QPointF newMousePosition) {
 void GameCore::mouseButtonPressed(QPointF mousePosition, Qt::MouseButtons buttons) {
     emit notifyMouseButtonPressed(mousePosition, buttons);
 
+    // Les boutons n'existent pas tant que les images sont en cours de chargement.
+    if (!m_assetsLoaded)
+        return;
+
     // Au clique gauche de la souris.
     if (buttons.testFlag(Qt::LeftButton)) {
 
@@ -156,11 +429,11 @@ void GameCore::mouseButtonPressed(QPointF mousePosition, Qt::MouseButtons button
         if (m_pGameCanvas->currentScene() == m_pSceneStart) {
             // Vérifie si il est positionner sur le bouton Start.
             if (m_pBTStartStart == m_pSceneStart->spriteAt(mousePosition)) {
-                changeCurrentScene(m_pSceneGame);
+                startGame();
 
             // Vérifie si il est positionner sur le bouton Exit.
             } else if (m_pBTStartExit == m_pSceneStart->spriteAt(mousePosition)) {
-                exit(0);
+                QCoreApplication::quit();
             }
 
 
@@ -169,7 +442,7 @@ void GameCore::mouseButtonPressed(QPointF mousePosition, Qt::MouseButtons button
             // Vérifie si il est positionner sur le bouton Resume.
             if (m_pBTMenuResume == m_pSceneMenu->spriteAt(mousePosition)) {
                 changeCurrentScene(m_pSceneGame);
-                emit notifyOnResume();
+                resumeGame();
 
             // Vérifie si il est positionner sur le bouton New Game.
             } else if (m_pBTMenuNewGame == m_pSceneMenu->spriteAt(mousePosition)) {
@@ -177,7 +450,7 @@ void GameCore::mouseButtonPressed(QPointF mousePosition, Qt::MouseButtons button
 
             // Vérifie si il est positionner sur le bouton Exit.
             } else if (m_pBTMenuExit == m_pSceneMenu->spriteAt(mousePosition)) {
-                exit(0);
+                QCoreApplication::quit();
             }
 
 
@@ -197,7 +470,7 @@ void GameCore::mouseButtonPressed(QPointF mousePosition, Qt::MouseButtons button
 
             // Vérifie si il est positionner sur le bouton Exit.
             } else if (m_pBTWinExit == m_pSceneWin->spriteAt(mousePosition)) {
-                exit(0);
+                QCoreApplication::quit();
             }
 
 
@@ -209,7 +482,7 @@ void GameCore::mouseButtonPressed(QPointF mousePosition, Qt::MouseButtons button
 
             // Vérifie si il est positionner sur le bouton Exit.
             } else if (m_pBTLossExit == m_pSceneLoss->spriteAt(mousePosition)) {
-                exit(0);
+                QCoreApplication::quit();
             }
         }
     }
@@ -227,30 +500,54 @@ void GameCore::mouseButtonReleased(QPointF mousePosition, Qt::MouseButtons butto
 //! Met en place le rectangle autour de la zone de jeu.
 void GameCore::setupBoucingArea() {
     // Création des bordures de délimitation de la zone et placement.
-    QPixmap border = QPixmap(BrickBreaker::imagesPath() + "border.png");
+    QPixmap border = AssetLoader::instance()->pixmap("border.png");
     border = border.scaled(BORDER_SIZE, BORDER_SIZE);
 
+    // La zone de rebond couvre toute la scène, éventuellement agrandie par le niveau.
+    const QPointF bouncingAreaSize(m_pSceneGame->width(), m_pSceneGame->height());
+
     // Création d'une image faite d'une suite horizontale de bordure.
-    QPixmap horizontalWall(BOUNCING_AREA_SIZE.x() + (2 * BORDER_SIZE), BORDER_SIZE);
+    QPixmap horizontalWall(bouncingAreaSize.x() + (2 * BORDER_SIZE), BORDER_SIZE);
     QPainter painterHW(&horizontalWall);
-    for (int col = 0; col < (BOUNCING_AREA_SIZE.x() + (2 * BORDER_SIZE) / BORDER_SIZE); col++)
+    for (int col = 0; col < (bouncingAreaSize.x() + (2 * BORDER_SIZE) / BORDER_SIZE); col++)
         painterHW.drawPixmap(col * BORDER_SIZE, 0, border);
 
     // Création d'une image faite d'une suite verticale de bordure.
-    QPixmap verticalWall(BORDER_SIZE, BOUNCING_AREA_SIZE.y());
+    QPixmap verticalWall(BORDER_SIZE, bouncingAreaSize.y());
     QPainter painterVW(&verticalWall);
-    for (int col = 0; col < (BOUNCING_AREA_SIZE.y() / BORDER_SIZE); col++)
+    for (int col = 0; col < (bouncingAreaSize.y() / BORDER_SIZE); col++)
         painterVW.drawPixmap(0, col * BORDER_SIZE, border);
 
     // Ajout de 3 sprites (utilisant les murs horizontaux et verticaux) pour délimiter une zone de rebond.
-    m_pSceneGame->addSpriteToScene(new Sprite(horizontalWall), BOUNCING_AREA_POS.x() - BORDER_SIZE, BOUNCING_AREA_POS.y() - BORDER_SIZE);
-    m_pSceneGame->addSpriteToScene(new Sprite(verticalWall), BOUNCING_AREA_POS.x() - BORDER_SIZE, BOUNCING_AREA_POS.y());
-    m_pSceneGame->addSpriteToScene(new Sprite(verticalWall), BOUNCING_AREA_POS.x() + BOUNCING_AREA_SIZE.x(), BOUNCING_AREA_POS.y());
+    StaticSprite* pTopWall = new StaticSprite(horizontalWall);
+    StaticSprite* pLeftWall = new StaticSprite(verticalWall);
+    StaticSprite* pRightWall = new StaticSprite(verticalWall);
+    pTopWall->setCategory(StaticSprite::CategoryWall);
+    pLeftWall->setCategory(StaticSprite::CategoryWall);
+    pRightWall->setCategory(StaticSprite::CategoryWall);
+    m_pSceneGame->addSpriteToScene(pTopWall, BOUNCING_AREA_POS.x() - BORDER_SIZE, BOUNCING_AREA_POS.y() - BORDER_SIZE);
+    m_pSceneGame->addSpriteToScene(pLeftWall, BOUNCING_AREA_POS.x() - BORDER_SIZE, BOUNCING_AREA_POS.y());
+    m_pSceneGame->addSpriteToScene(pRightWall, BOUNCING_AREA_POS.x() + bouncingAreaSize.x(), BOUNCING_AREA_POS.y());
 
     // Trace un rectangle tout autour des limites de la scène.
     m_pSceneGame->addRect(m_pSceneGame->sceneRect(), QPen(Qt::white));
 }
 
+//! Met en place la caméra de la scène de jeu.
+//! Si le niveau a agrandi la scène au-delà de la taille de l'écran, la caméra n'en
+//! montre qu'une partie de la taille de l'écran, centrée sur le plateau, puis suit la
+//! balle (voir tick()). Sinon, la caméra reste désactivée et toute la scène est affichée.
+void GameCore::setupCamera() {
+    if (m_pSceneGame->width() <= SCENE_WIDTH && m_pSceneGame->height() <= SCENE_HEIGHT)
+        return;
+
+    Camera& rCamera = m_pSceneGame->camera();
+    rCamera.setViewSize(QSizeF(SCENE_WIDTH, SCENE_HEIGHT));
+    StaticSprite* pPlate = m_pSceneGame->sprite(m_plateHandle);
+    if (pPlate)
+        rCamera.setCenter(pPlate->globalBoundingBox().center());
+}
+
 //! Créer le plateau que le joueur contrôle.
 //! Positionne le plateau et l'ajoute à la scène de jeu.
 //! Ajoute le plateau à la cadence et envoie une notifications lorsque la souris est bougée.
@@ -260,59 +557,74 @@ void GameCore::createPlate() {
     m_pSceneGame->addSpriteToScene(pPlate);
     pPlate->registerForTick();
     connect(this, &GameCore::notifyMouseMoved, pPlate, &Plate::onMouseMoved);
-    m_pPlate = pPlate;
+    m_plateHandle = pPlate->handle();
 }
 
-//! Créer les briques avec des couleurs aléatoires.
-//! Positionne les briques selon une liste et les ajoutes à la scéne de jeu.
+//! Créer les briques du niveau.
+//! En mode sans fin (option `--endless`), les briques sont gérées par un EndlessField.
+//! Avec l'option `--generate`, le niveau est généré à partir de la graine du jeu (voir
+//! LevelGenerator) : il est identique pour une même graine. Sinon, il est lu depuis le
+//! fichier donné avec l'option `--level` ou, par défaut, depuis `res/levels/level1.txt`
+//! (voir LevelReader). Si le fichier ne peut pas être lu, la disposition d'origine
+//! (trois rangées de couleurs aléatoires) est utilisée.
+//! Les briques sont directement ajoutées à la scène de jeu.
 //! Lorsque des briques grises sont générés, elles sont indéstructiblent.
 void GameCore::createBricks() {
-    int spaceLines = 0;
-    int spaceColumns = 0;
-    QList<int> brickBuilder = {8, 12, 10};
+    QElapsedTimer loadingTimer;
+    loadingTimer.start();
 
-    int minRandomColor = 1;
-    int maxRandomColor = m_pBrickColors.length();
+    const GameOptions& rOptions = GameOptions::instance();
 
-    m_pCounterBricks = 0;
+    delete m_pEndlessField;
+    m_pEndlessField = nullptr;
+    if (rOptions.endless()) {
+        m_pEndlessField = new EndlessField(m_pSceneGame, m_pBrickColors, m_seed);
+        return;
+    }
 
-    for (int j = 0; j < brickBuilder.length(); j++) {
-        m_pCounterBricks += brickBuilder[j];
+    BrickLevelBuilder builder(m_pSceneGame, m_pBrickColors, m_random);
 
-        for (int i = 0; i < brickBuilder[j]; i++) {
-            QString color = m_pBrickColors[(rand() % maxRandomColor + minRandomColor) - 1];
+    if (rOptions.generateLevel()) {
+        LevelGenerator generator(rOptions.levelParameters(), m_seed);
+        generator.generate(&builder);
+        qDebug() << generator.brickCount() << "briques générées en" << loadingTimer.elapsed() << "ms";
+        return;
+    }
 
-            // Ajout d'un sprite (brique à casser) et lui attribut un "id".
-            Sprite* pBrick = new Sprite(BrickBreaker::imagesPath() + "brick" + color + ".png");
-            pBrick->setPos(((m_pSceneGame->width() - (brickBuilder[j] * BRICK_SIZE.x())) / 2) + spaceLines, 50 + spaceColumns);
-            pBrick->setData(0, "brick");
-            pBrick->setScale(0.5);
-            if (color == "Gray") {
-                pBrick->setData(1, "unbreakable");
-                m_pCounterBricks--;
-            }
-            m_pSceneGame->addSpriteToScene(pBrick);
-            connect(pBrick, &Sprite::destroyed, this, &GameCore::onBrickDestroyed);
-            spaceLines += BRICK_SIZE.x();
+    QString levelFileName = rOptions.levelFileName();
+    if (levelFileName.isEmpty())
+        levelFileName = BrickBreaker::resourcesPath() + DEFAULT_LEVEL_FILE;
+
+    LevelReader reader(&builder);
+    if (!reader.read(levelFileName)) {
+        qWarning() << reader.errorString() << "- utilisation du niveau par défaut";
+
+        // Les briques éventuellement ajoutées avant l'erreur sont retirées.
+        for (StaticSprite* pBrick : QVector<StaticSprite*>(m_pSceneGame->sprites(StaticSprite::CategoryBrick)))
+            delete pBrick;
+        for (StaticSprite* pWall : QVector<StaticSprite*>(m_pSceneGame->sprites(StaticSprite::CategoryWall))) {
+            if (dynamic_cast<Brick*>(pWall) != nullptr)
+                delete pWall;
         }
 
-        // Réinitialise les valeurs et ajoutes une marge de 65 pour l'espacement des blocs.
-        spaceLines = 0;
-        spaceColumns += BRICK_SIZE.y();
+        QByteArray defaultLevel(DEFAULT_LEVEL);
+        QBuffer buffer(&defaultLevel);
+        buffer.open(QIODevice::ReadOnly);
+        reader.read(&buffer);
     }
+
+    qDebug() << reader.brickCount() << "briques chargées en" << loadingTimer.elapsed() << "ms";
 }
 
 //! Créer une balle qui rebondit.
 //! Positionne la balle et l'ajoute à la scène de jeu.
-//! Envoie une notifications lorsque la balle est détruite, que le jeu est mit en pause et qu'il n'est plus en pause.
+//! Sa destruction est constatée par GameCore::tick(), grâce au registre de la scène.
+//! La pause n'a pas besoin d'être signalée à la balle : elle arrête la cadence de toute
+//! la simulation (voir pauseGame()).
 void GameCore::createBall() {
     Ball* pBall = new Ball;
-    m_pCounterBall++;
     m_pSceneGame->addSpriteToScene(pBall);
-    connect(pBall, &Ball::destroyed, this, &GameCore::onBallDestroyed);
-    connect(this, &GameCore::notifyOnResume, pBall, &Ball::onResumeTick);
-    connect(this, &GameCore::notifyOnPause, pBall, &Ball::onPauseTick);
-    m_pBall = pBall;
+    m_ballHandle = pBall->handle();
 
     m_pIsWaiting = true;
 }
@@ -321,36 +633,44 @@ void GameCore::createBall() {
 //! Positionne les coeurs et les ajoutes à la scène de jeu.
 void GameCore::createLife() {
     m_pPlayerLife = PLAYER_LIFES;
-    m_pPlayerLifeList = {};
+    m_playerLifeHandles = {};
 
     int margin = BORDER_SIZE + 5;
+    int posX = 0;
 
     for(int i = 0; i < PLAYER_LIFES; i++) {
-        Sprite* heart = new Sprite(BrickBreaker::imagesPath("GameUI") + "heart.png");
+        StaticSprite* heart = createUISprite("GameUI/heart.png");
         heart->setScale(0.2);
 
-        int posX = 0;
-        if (i>0) {
-            posX = m_pPlayerLifeList[i - 1]->right();
-        }
-
-        m_pPlayerLifeList.append(heart);
         m_pSceneGame->addSpriteToScene(heart, posX, -heart->height() - margin);
+        m_playerLifeHandles.append(heart->handle());
+        posX = heart->right();
     }
 }
 
 
 //! Création de la scène de démarrage du jeu.
-//! Crée le titre et les boutons de la scène.
-//! Positionne le titre et les boutons et les ajoutes à la scène de démarrage.
+//! Cette scène est affichée immédiatement : elle ne contient qu'un texte indiquant
+//! la progression du chargement des images. Le titre et les boutons y sont ajoutés
+//! par setupSceneStart() une fois le chargement terminé.
 void GameCore::createSceneStart() {
     // Créé la scène de démarrage du jeu.
     m_pSceneStart = m_pGameCanvas->createScene(0, 0, SCENE_WIDTH, SCENE_HEIGHT);
+    m_pSceneStart->setObjectName("start");
 
+    // Créé le texte de progression du chargement.
+    m_pLoadingText = m_pSceneStart->createText(QPointF(0, 0), "", LOADING_TEXT_SIZE);
+    onAssetLoadingProgress(0, 0);
+}
+
+//! Complète la scène de démarrage du jeu, une fois les images chargées.
+//! Crée le titre et les boutons de la scène.
+//! Positionne le titre et les boutons et les ajoutes à la scène de démarrage.
+void GameCore::setupSceneStart() {
     // Créé le titre et les boutons avec leurs images.
-    m_pLogoTitle = new Sprite(BrickBreaker::imagesPath() + "logoTitle.png");
-    m_pBTStartStart = new Sprite(BrickBreaker::imagesPath("GameUI") + "start.png");
-    m_pBTStartExit = new Sprite(BrickBreaker::imagesPath("GameUI") + "exit.png");
+    m_pLogoTitle = createUISprite("logoTitle.png");
+    m_pBTStartStart = createUISprite("GameUI/start.png");
+    m_pBTStartExit = createUISprite("GameUI/exit.png");
 
     // Ajoute et positionne les sprites précédement crées.
     m_pSceneStart->addSpriteToScene(m_pLogoTitle, (SCENE_WIDTH / 2) - (m_pLogoTitle->width() / 2), (SCENE_HEIGHT / 4) - (m_pLogoTitle->height() / 2));
@@ -363,12 +683,13 @@ void GameCore::createSceneStart() {
 void GameCore::createSceneGame() {
     // Créé la scène de base.
     m_pSceneGame = m_pGameCanvas->createScene(0, 0, SCENE_WIDTH, SCENE_HEIGHT);
+    m_pSceneGame->setObjectName("game");
 
     // Définie l'image de fond de la scène.
-    m_pSceneGame->setBackgroundImage(QImage(BrickBreaker::imagesPath() + "background.jpg"));
+    m_pSceneGame->setBackgroundImage(AssetLoader::instance()->image("background.jpg"));
 
     // Créé le titre, l'ajoute et le positionne.
-    m_pLogoGame = new Sprite(BrickBreaker::imagesPath() + "logoTitle.png");
+    m_pLogoGame = createUISprite("logoTitle.png");
     m_pLogoGame->setScale(0.7);
     m_pSceneGame->addSpriteToScene(m_pLogoGame, (SCENE_WIDTH / 2) - (m_pLogoGame->width() / 2), -m_pLogoGame->height() - (BORDER_SIZE * 1.5));
 }
@@ -379,12 +700,13 @@ void GameCore::createSceneGame() {
 void GameCore::createSceneMenu() {
     // Créé la scène de base.
     m_pSceneMenu = m_pGameCanvas->createScene(0, 0, SCENE_WIDTH, SCENE_HEIGHT);
+    m_pSceneMenu->setObjectName("menu");
 
     // Créé le titre et les boutons avec leurs images.
-    m_pLogoMenu = new Sprite(BrickBreaker::imagesPath("GameUI") + "menu.png");
-    m_pBTMenuResume = new Sprite(BrickBreaker::imagesPath("GameUI") + "resume.png");
-    m_pBTMenuNewGame = new Sprite(BrickBreaker::imagesPath("GameUI") + "newGame.png");
-    m_pBTMenuExit = new Sprite(BrickBreaker::imagesPath("GameUI") + "exit.png");
+    m_pLogoMenu = createUISprite("GameUI/menu.png");
+    m_pBTMenuResume = createUISprite("GameUI/resume.png");
+    m_pBTMenuNewGame = createUISprite("GameUI/newGame.png");
+    m_pBTMenuExit = createUISprite("GameUI/exit.png");
 
     // Ajoute et positionne les sprites précédement crées.
     m_pSceneMenu->addSpriteToScene(m_pLogoMenu, (SCENE_WIDTH / 2) - (m_pLogoMenu->width() / 2), (SCENE_HEIGHT / 5) - m_pLogoMenu->height() / 2);
@@ -399,11 +721,12 @@ void GameCore::createSceneMenu() {
 void GameCore::createSceneWin() {
     // Créé la scène de base.
     m_pSceneWin = m_pGameCanvas->createScene(0, 0, SCENE_WIDTH, SCENE_HEIGHT);
+    m_pSceneWin->setObjectName("win");
 
     // Créé le titre et les boutons avec leurs images.
-    m_pLogoWin = new Sprite(BrickBreaker::imagesPath("GameUI") + "victory.png");
-    m_pBTWinNewGame = new Sprite(BrickBreaker::imagesPath("GameUI") + "newGame.png");
-    m_pBTWinExit = new Sprite(BrickBreaker::imagesPath("GameUI") + "exit.png");
+    m_pLogoWin = createUISprite("GameUI/victory.png");
+    m_pBTWinNewGame = createUISprite("GameUI/newGame.png");
+    m_pBTWinExit = createUISprite("GameUI/exit.png");
 
     // Ajoute et positionne les sprites précédement crées.
     m_pSceneWin->addSpriteToScene(m_pLogoWin, (SCENE_WIDTH / 2) - (m_pLogoWin->width() / 2), (SCENE_HEIGHT / 5) - m_pLogoWin->height() / 2);
@@ -417,11 +740,12 @@ void GameCore::createSceneWin() {
 void GameCore::createSceneLoss() {
     // Créé la scène de base et indique au canvas qu'il faut l'afficher.
     m_pSceneLoss = m_pGameCanvas->createScene(0, 0, SCENE_WIDTH, SCENE_HEIGHT);
+    m_pSceneLoss->setObjectName("loss");
 
     // Créé le titre et les boutons avec leurs images.
-    m_pLogoLoss = new Sprite(BrickBreaker::imagesPath("GameUI") + "gameover.png");
-    m_pBTLossNewGame = new Sprite(BrickBreaker::imagesPath("GameUI") + "newGame.png");
-    m_pBTLossExit = new Sprite(BrickBreaker::imagesPath("GameUI") + "exit.png");
+    m_pLogoLoss = createUISprite("GameUI/gameover.png");
+    m_pBTLossNewGame = createUISprite("GameUI/newGame.png");
+    m_pBTLossExit = createUISprite("GameUI/exit.png");
 
     // Ajoute et positionne les sprites précédement crées.
     m_pSceneLoss->addSpriteToScene(m_pLogoLoss, (SCENE_WIDTH / 2) - (m_pLogoLoss->width() / 2), (SCENE_HEIGHT / 5) - m_pLogoLoss->height() / 2);
@@ -429,6 +753,67 @@ void GameCore::createSceneLoss() {
     m_pSceneLoss->addSpriteToScene(m_pBTLossExit, (SCENE_WIDTH / 2) - (m_pBTLossExit->width() / 2), m_pBTLossNewGame->bottom());
 }
 
+//! \return la liste des images utilisées par la scène de démarrage et la scène de jeu,
+//! relativement au répertoire des images. Les images des autres scènes sont données
+//! par lazySceneImageNames().
+QStringList GameCore::imageNames() const {
+    QStringList imageNames = {
+        "background.jpg", "ball.png", "border.png", "logoTitle.png", "plate.png",
+        "GameUI/exit.png", "GameUI/heart.png", "GameUI/heartbroken.png", "GameUI/start.png"
+    };
+
+    for (const QString& rColor : m_pBrickColors)
+        imageNames << "brick" + rColor + ".png";
+
+    return imageNames;
+}
+
+//! Retourne la scène donnée, en la construisant si elle n'existe pas encore.
+//! Les images de la scène qui n'ont pas encore été chargées le sont alors immédiatement.
+//! \param scene  Scène à retourner.
+//! \return un pointeur sur la scène.
+GameScene* GameCore::lazyScene(LazyScene scene) {
+    GameScene*& rpScene = lazySceneSlot(scene);
+    if (rpScene == nullptr) {
+        switch (scene) {
+        case LazySceneMenu: createSceneMenu(); break;
+        case LazySceneWin:  createSceneWin();  break;
+        case LazySceneLoss: createSceneLoss(); break;
+        case LazySceneCount: break;
+        }
+    }
+    return rpScene;
+}
+
+//! \return une référence sur le pointeur qui mémorise la scène donnée.
+//! \param scene  Scène dont le pointeur doit être retourné.
+GameScene*& GameCore::lazySceneSlot(LazyScene scene) {
+    switch (scene) {
+    case LazySceneMenu: return m_pSceneMenu;
+    case LazySceneWin:  return m_pSceneWin;
+    default:            return m_pSceneLoss;
+    }
+}
+
+//! \return la liste des images utilisées par la scène donnée.
+//! \param scene  Scène dont les images doivent être retournées.
+QStringList GameCore::lazySceneImageNames(LazyScene scene) const {
+    switch (scene) {
+    case LazySceneMenu: return { "GameUI/menu.png", "GameUI/resume.png", "GameUI/newGame.png", "GameUI/exit.png" };
+    case LazySceneWin:  return { "GameUI/victory.png", "GameUI/newGame.png", "GameUI/exit.png" };
+    default:            return { "GameUI/gameover.png", "GameUI/newGame.png", "GameUI/exit.png" };
+    }
+}
+
+//! Crée un élément d'interface (titre, bouton ou icône).
+//! \param rImageName Chemin de l'image de l'élément, relatif au répertoire des images.
+//! \return un pointeur sur le sprite créé, rangé dans la catégorie CategoryUI.
+StaticSprite* GameCore::createUISprite(const QString& rImageName) {
+    StaticSprite* pSprite = new StaticSprite(AssetLoader::instance()->pixmap(rImageName));
+    pSprite->setCategory(StaticSprite::CategoryUI);
+    return pSprite;
+}
+
 //! Change la scène actuelle et la visibilité du curseur de la souris.
 //! \param pScene prochaine scène à afficher.
 //! Si la prochaine scène est la scène de jeu : cache le curseur.
@@ -445,28 +830,104 @@ void GameCore::changeCurrentScene(GameScene *pScene) {
 }
 
 
-//! Désincrémente le compteur de balle lorsqu'une balle est détruite
-//! et vérifie si il reste encore des balles en jeu sinon enlève une
-//! vie au joueur et recrée une nouvelle balle.
-void GameCore::onBallDestroyed() {
-    m_pCounterBall--;
+//! Enlève une vie au joueur lorsqu'il n'y a plus de balle en jeu,
+//! affiche un coeur brisé à la place de la vie perdue et recrée une nouvelle balle.
+void GameCore::loseLife() {
+    m_pPlayerLife--;
 
-    if (m_pCounterBall == 0) {
-        m_pPlayerLife--;
-
-        if (m_pPlayerLifeList.size() > 0) {
-            Sprite* heart = m_pPlayerLifeList[m_pPlayerLife];
-            if (heart) {
-                heart->clearAnimationFrames();
-                heart->addAnimationFrame(BrickBreaker::imagesPath("GameUI") + "heartbroken.png");
-            }
-        }
-        createBall();
+    if (m_pPlayerLife >= 0 && m_pPlayerLife < m_playerLifeHandles.size()) {
+        StaticSprite* heart = m_pSceneGame->sprite(m_playerLifeHandles[m_pPlayerLife]);
+        if (heart)
+            heart->setPixmap(AssetLoader::instance()->pixmap("GameUI/heartbroken.png"));
     }
+    createBall();
+}
+
+//! Met le jeu en pause : la simulation est arrêtée (voir GameCanvas::setPaused()), ce qui
+//! arrête la cadence de tous les sprites à la fois. L'échelle du temps n'est pas modifiée.
+void GameCore::pauseGame() {
+    if (m_isPaused)
+        return;
+
+    m_isPaused = true;
+    m_pGameCanvas->setPaused(true);
+    emit notifyOnPause();
+}
+
+//! Reprend le jeu, avec l'échelle du temps en cours.
+void GameCore::resumeGame() {
+    if (!m_isPaused)
+        return;
+
+    m_isPaused = false;
+    m_pGameCanvas->setPaused(false);
+    emit notifyOnResume();
 }
 
-//! Désincrémente le compteur si une brique est détruite.
-void GameCore::onBrickDestroyed() {
-    m_pCounterBricks--;
+//! Met à jour le texte de progression du chargement des images.
+//! \param loadedCount  Nombre d'images chargées.
+//! \param totalCount   Nombre total d'images à charger.
+void GameCore::onAssetLoadingProgress(int loadedCount, int totalCount) {
+    if (m_pLoadingText == nullptr)
+        return;
+
+    int percent = (totalCount > 0) ? (100 * loadedCount / totalCount) : 0;
+    m_pLoadingText->setText(QString("Chargement... %1 %").arg(percent));
+    m_pLoadingText->setPos((SCENE_WIDTH - m_pLoadingText->boundingRect().width()) / 2,
+                           (SCENE_HEIGHT - m_pLoadingText->boundingRect().height()) / 2);
 }
 
+//! Les images de démarrage sont chargées : le texte de progression est remplacé par
+//! le titre et les boutons de la scène de démarrage, puis les éléments du jeu sont créés.
+//! Les autres scènes seront construites en arrière-plan, une fois la scène de démarrage
+//! affichée (startScenePrewarm()).
+void GameCore::onAssetsLoaded() {
+    if (m_assetsLoaded)
+        return;
+
+    delete m_pLoadingText;
+    m_pLoadingText = nullptr;
+
+    setupSceneStart();
+
+    // Initalise tout les éléments du du jeu.
+    initGame();
+
+    m_assetsLoaded = true;
+
+    QTimer::singleShot(SCENE_PREWARM_DELAY, this, &GameCore::startScenePrewarm);
+}
+
+//! Démarre la préparation en arrière-plan des scènes qui n'ont pas encore été affichées :
+//! leurs images sont décodées par l'AssetLoader, puis les scènes sont construites une à
+//! une par onPrewarmTimeout(), lorsque l'application est inoccupée.
+void GameCore::startScenePrewarm() {
+    QStringList prewarmImageNames;
+    for (int scene = 0; scene < LazySceneCount; ++scene) {
+        if (lazySceneSlot(LazyScene(scene)) == nullptr)
+            prewarmImageNames << lazySceneImageNames(LazyScene(scene));
+    }
+    prewarmImageNames.removeDuplicates();
+
+    if (!prewarmImageNames.isEmpty()) {
+        AssetLoader::instance()->load(prewarmImageNames);
+        m_prewarmTimer.start();
+    }
+}
+
+//! L'application est inoccupée : construit la prochaine scène qui n'existe pas encore,
+//! une fois ses images décodées. Une seule scène est construite à la fois, afin de ne pas
+//! retarder le traitement des événements.
+void GameCore::onPrewarmTimeout() {
+    if (!AssetLoader::instance()->isFinished())
+        return;
+
+    for (int scene = 0; scene < LazySceneCount; ++scene) {
+        if (lazySceneSlot(LazyScene(scene)) == nullptr) {
+            lazyScene(LazyScene(scene));
+            return;
+        }
+    }
+
+    m_prewarmTimer.stop();
+}
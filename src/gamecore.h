@@ -12,10 +12,18 @@
 #include <QObject>
 #include <QPointF>
 #include <QString>
+#include <QStringList>
+#include <QTimer>
 
+#include "randomgenerator.h"
+#include "spritehandle.h"
+
+class AutoPlayer;
+class EndlessField;
 class GameCanvas;
 class GameScene;
 class Sprite;
+class StaticSprite;
 
 //! Classe qui gère la logique du jeu.
 //! Dans son état actuel, cette classe crée une scène vide, délimite
@@ -36,7 +44,14 @@ public:
 
     void initGame();
     void restartGame();
+    bool startGame();
+    void processInput(long long elapsedTimeInMilliseconds);
     void tick(long long elapsedTimeInMilliseconds);
+    void animate(long long elapsedTimeInMilliseconds);
+
+    const AutoPlayer* autoPlayer() const;
+    quint64 seed() const;
+    quint64 stateChecksum() const;
 
 signals:
     void notifyKeyPressed(int key);
@@ -57,64 +72,98 @@ private:
     GameScene* m_pSceneWin = nullptr;
     GameScene* m_pSceneLoss = nullptr;
 
+    //! Scènes construites à la demande, lors du premier affichage ou en arrière-plan
+    //! (voir lazyScene()).
+    enum LazyScene { LazySceneMenu, LazySceneWin, LazySceneLoss, LazySceneCount };
+
 
     /***** Fonctions *****/
     // Scènes
     void createSceneStart();
+    void setupSceneStart();
     void createSceneGame();
     void createSceneMenu();
     void createSceneWin();
     void createSceneLoss();
+    QStringList imageNames() const;
+    GameScene* lazyScene(LazyScene scene);
+    GameScene*& lazySceneSlot(LazyScene scene);
+    QStringList lazySceneImageNames(LazyScene scene) const;
+    StaticSprite* createUISprite(const QString& rImageName);
     void changeCurrentScene(GameScene* pScene);
 
     // Eléments du jeux
     void setupBoucingArea();
+    void setupCamera();
     void createBricks();
     void createPlate();
     void createBall();
     void createLife();
+    void loseLife();
+    void pauseGame();
+    void resumeGame();
+    void autoPlay(long long elapsedTimeInMilliseconds);
 
 
     /***** Sprites *****/
-    Sprite* m_pLogoTitle = nullptr;
-    Sprite* m_pLogoGame = nullptr;
-    Sprite* m_pLogoMenu = nullptr;
-    Sprite* m_pLogoWin = nullptr;
-    Sprite* m_pLogoLoss = nullptr;
-    Sprite* m_pBTStartStart = nullptr;
-    Sprite* m_pBTStartExit = nullptr;
-    Sprite* m_pBTMenuResume = nullptr;
-    Sprite* m_pBTMenuNewGame = nullptr;
-    Sprite* m_pBTMenuExit = nullptr;
-    Sprite* m_pBTWinNewGame = nullptr;
-    Sprite* m_pBTWinExit = nullptr;
-    Sprite* m_pBTLossNewGame = nullptr;
-    Sprite* m_pBTLossExit = nullptr;
-    Sprite* m_pPlate = nullptr;
-    Sprite* m_pBall = nullptr;
+    StaticSprite* m_pLogoTitle = nullptr;
+    StaticSprite* m_pLogoGame = nullptr;
+    StaticSprite* m_pLogoMenu = nullptr;
+    StaticSprite* m_pLogoWin = nullptr;
+    StaticSprite* m_pLogoLoss = nullptr;
+    StaticSprite* m_pBTStartStart = nullptr;
+    StaticSprite* m_pBTStartExit = nullptr;
+    StaticSprite* m_pBTMenuResume = nullptr;
+    StaticSprite* m_pBTMenuNewGame = nullptr;
+    StaticSprite* m_pBTMenuExit = nullptr;
+    StaticSprite* m_pBTWinNewGame = nullptr;
+    StaticSprite* m_pBTWinExit = nullptr;
+    StaticSprite* m_pBTLossNewGame = nullptr;
+    StaticSprite* m_pBTLossExit = nullptr;
+    QGraphicsSimpleTextItem* m_pLoadingText = nullptr;
+
+
+    /***** Handles (sprites de la scène de jeu) *****/
+    SpriteHandle m_plateHandle;
+    SpriteHandle m_ballHandle;
 
 
     /***** Booléen *****/
     bool m_pOnClick = false;
     bool m_pIsWaiting = true;
+    bool m_assetsLoaded = false;
+    bool m_isPaused = false;
 
 
     /***** Int *****/
     int m_pPlayerLife = 0;
-    int m_pCounterBall = 0;
-    int m_pCounterBricks = 0;
 
 
     /***** Coordonées *****/
     QPointF m_pOldMousePosition = QPointF(0, 0);
 
+    /***** Mode sans fin *****/
+    EndlessField* m_pEndlessField = nullptr;
+
+    /***** Jeu automatique *****/
+    AutoPlayer* m_pAutoPlayer = nullptr;
+
+    /***** Générateur pseudo-aléatoire *****/
+    quint64 m_seed = 0;
+    RandomGenerator m_random;
+
+    /***** Timers *****/
+    QTimer m_prewarmTimer;
+
     /***** Listes *****/
-    QList<Sprite*> m_pPlayerLifeList = {};
+    QList<SpriteHandle> m_playerLifeHandles = {};
     QList<QString> m_pBrickColors = {"Blue", "Cyan", "Gray", "Green", "Orange", "Pink", "Red", "Yellow"};
 
 private slots:
-    void onBallDestroyed();
-    void onBrickDestroyed();
+    void onAssetLoadingProgress(int loadedCount, int totalCount);
+    void onAssetsLoaded();
+    void startScenePrewarm();
+    void onPrewarmTimeout();
 };
 
 
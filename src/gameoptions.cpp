@@ -0,0 +1,261 @@
+/**
+  \file
+  \brief    Définition de la classe GameOptions.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "gameoptions.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDebug>
+#include <QStringList>
+
+#include "inputlog.h"
+
+//! Signale la valeur invalide d'une option, affiche l'aide, puis quitte l'application
+//! avec le code 1.
+//! \param rParser  Analyseur de la ligne de commande.
+//! \param rOption  Option dont la valeur est invalide.
+static void rejectValue(QCommandLineParser& rParser, const QCommandLineOption& rOption) {
+    qWarning().noquote() << QString("Valeur invalide pour --%1 : %2").arg(rOption.names().first(), rParser.value(rOption));
+    rParser.showHelp(1);
+}
+
+//! Construit des options vides (valeurs par défaut).
+GameOptions::GameOptions() {
+    m_packAssets = false;
+    m_hasSeed = false;
+    m_seed = 0;
+    m_generateLevel = false;
+    m_endless = false;
+    m_loopMode = LoopScheduler::ModeAuto;
+    m_timeScale = 1.0;
+    m_continuousTick = false;
+    m_headless = false;
+    m_headlessTickCount = 100000;
+    m_autoPlay = false;
+}
+
+//! \return l'instance unique des options du jeu.
+GameOptions& GameOptions::instance() {
+    static GameOptions s_options;
+    return s_options;
+}
+
+//! Lit les options de la ligne de commande de l'application.
+//! En cas d'option inconnue ou de valeur invalide, ou si l'aide est demandée, l'application
+//! est quittée.
+//! \param rApplication  Application dont les arguments doivent être lus.
+void GameOptions::process(const QCoreApplication& rApplication) {
+    QCommandLineParser parser;
+    parser.addHelpOption();
+
+    QCommandLineOption resourcesPathOption("res-dir", "Utilise le répertoire de ressources <dir>.", "dir");
+    QCommandLineOption packAssetsOption("pack-assets", "Produit le paquet d'images pré-décodées, puis quitte.");
+    QCommandLineOption levelOption("level", "Charge le niveau <fichier> (texte ou binaire).", "fichier");
+    QCommandLineOption convertLevelOption("convert-level", "Convertit le niveau texte <fichier> au format binaire, puis quitte.", "fichier");
+    QCommandLineOption seedOption("seed", "Graine du générateur pseudo-aléatoire.", "n");
+    QCommandLineOption generateOption("generate", "Génère un niveau de <colonnes>x<rangées> briques.", "taille");
+    QCommandLineOption densityOption("density", "Proportion de cases occupées du niveau généré (0 à 1).", "d");
+    QCommandLineOption unbreakableOption("unbreakable", "Proportion de briques incassables du niveau généré (0 à 1).", "r");
+    QCommandLineOption hitPointsOption("hit-points", "Points de vie maximum des briques du niveau généré.", "n");
+    QCommandLineOption endlessOption("endless", "Mode sans fin : les briques défilent vers le bas.");
+    QCommandLineOption loopModeOption("loop-mode", "Attente du tick suivant : auto, timer ou busy.", "mode");
+    QCommandLineOption timeScaleOption("time-scale", "Echelle du temps de simulation (0.5 : ralenti, 2 : accéléré).", "x");
+    QCommandLineOption continuousTickOption("continuous-tick", "Ne suspend jamais le tick, même sur une scène inactive.");
+    QCommandLineOption headlessOption("headless", "Simule une partie sans fenêtre, aussi vite que possible, puis quitte.");
+    QCommandLineOption ticksOption("ticks", "Nombre de ticks simulés en mode --headless.", "n");
+    QCommandLineOption autoPlayOption("autoplay", "Joue automatiquement, partie après partie.");
+    QCommandLineOption recordOption("record", "Enregistre les entrées du joueur dans <fichier>.", "fichier");
+    QCommandLineOption replayOption("replay", "Rejoue le journal des entrées <fichier>.", "fichier");
+    QCommandLineOption traceOption("trace", "Ecrit une trace de l'exécution (format Chrome trace event) dans <fichier>.", "fichier");
+    parser.addOption(resourcesPathOption);
+    parser.addOption(packAssetsOption);
+    parser.addOption(levelOption);
+    parser.addOption(convertLevelOption);
+    parser.addOption(seedOption);
+    parser.addOption(generateOption);
+    parser.addOption(densityOption);
+    parser.addOption(unbreakableOption);
+    parser.addOption(hitPointsOption);
+    parser.addOption(endlessOption);
+    parser.addOption(loopModeOption);
+    parser.addOption(timeScaleOption);
+    parser.addOption(continuousTickOption);
+    parser.addOption(traceOption);
+    parser.addOption(headlessOption);
+    parser.addOption(ticksOption);
+    parser.addOption(autoPlayOption);
+    parser.addOption(recordOption);
+    parser.addOption(replayOption);
+    parser.process(rApplication);
+
+    m_resourcesPath = parser.value(resourcesPathOption);
+    m_packAssets = parser.isSet(packAssetsOption);
+    m_levelFileName = parser.value(levelOption);
+    m_convertLevelFileName = parser.value(convertLevelOption);
+
+    m_endless = parser.isSet(endlessOption);
+
+    const QString loopMode = parser.value(loopModeOption);
+    if (loopMode == "timer")
+        m_loopMode = LoopScheduler::ModeTimer;
+    else if (loopMode == "busy")
+        m_loopMode = LoopScheduler::ModeBusy;
+    else if (!loopMode.isEmpty() && loopMode != "auto")
+        rejectValue(parser, loopModeOption);
+
+    bool isValid = false;
+    if (parser.isSet(timeScaleOption)) {
+        m_timeScale = parser.value(timeScaleOption).toDouble(&isValid);
+        if (!isValid || !(m_timeScale > 0))
+            rejectValue(parser, timeScaleOption);
+    }
+    m_continuousTick = parser.isSet(continuousTickOption);
+    m_traceFileName = parser.value(traceOption);
+    m_headless = parser.isSet(headlessOption);
+    m_autoPlay = parser.isSet(autoPlayOption);
+    if (parser.isSet(ticksOption)) {
+        m_headlessTickCount = parser.value(ticksOption).toLongLong(&isValid);
+        if (!isValid || m_headlessTickCount <= 0)
+            rejectValue(parser, ticksOption);
+    }
+
+    m_hasSeed = parser.isSet(seedOption);
+    if (m_hasSeed) {
+        m_seed = parser.value(seedOption).toULongLong(&isValid);
+        if (!isValid)
+            rejectValue(parser, seedOption);
+    }
+
+    // Le rejeu impose la graine de l'enregistrement, dont dépendent les niveaux.
+    m_recordFileName = parser.value(recordOption);
+    m_replayFileName = parser.value(replayOption);
+    if (!m_replayFileName.isEmpty()) {
+        if (InputLog::readSeed(m_replayFileName, m_seed))
+            m_hasSeed = true;
+        else
+            qWarning() << "Journal des entrées illisible :" << m_replayFileName;
+    }
+
+    m_generateLevel = parser.isSet(generateOption);
+    if (m_generateLevel) {
+        const QStringList size = parser.value(generateOption).split('x');
+        bool isRowCountValid = false;
+        if (size.count() == 2) {
+            m_levelParameters.columnCount = size[0].toInt(&isValid);
+            m_levelParameters.rowCount = size[1].toInt(&isRowCountValid);
+        }
+        if (size.count() != 2 || !isValid || !isRowCountValid
+            || m_levelParameters.columnCount <= 0 || m_levelParameters.rowCount <= 0)
+            rejectValue(parser, generateOption);
+    }
+
+    // Les proportions doivent être comprises entre 0 et 1 (le test rejette aussi NaN).
+    if (parser.isSet(densityOption)) {
+        m_levelParameters.density = parser.value(densityOption).toDouble(&isValid);
+        if (!isValid || !(m_levelParameters.density >= 0 && m_levelParameters.density <= 1))
+            rejectValue(parser, densityOption);
+    }
+    if (parser.isSet(unbreakableOption)) {
+        m_levelParameters.unbreakableRatio = parser.value(unbreakableOption).toDouble(&isValid);
+        if (!isValid || !(m_levelParameters.unbreakableRatio >= 0 && m_levelParameters.unbreakableRatio <= 1))
+            rejectValue(parser, unbreakableOption);
+    }
+    if (parser.isSet(hitPointsOption)) {
+        m_levelParameters.maxHitPoints = parser.value(hitPointsOption).toInt(&isValid);
+        if (!isValid || m_levelParameters.maxHitPoints < 1)
+            rejectValue(parser, hitPointsOption);
+    }
+}
+
+//! \return le répertoire de ressources imposé, ou une chaîne vide.
+QString GameOptions::resourcesPath() const {
+    return m_resourcesPath;
+}
+
+//! \return vrai si le paquet d'images pré-décodées doit être produit.
+bool GameOptions::packAssets() const {
+    return m_packAssets;
+}
+
+//! \return le fichier du niveau à charger, ou une chaîne vide pour le niveau par défaut.
+QString GameOptions::levelFileName() const {
+    return m_levelFileName;
+}
+
+//! \return le fichier du niveau texte à convertir, ou une chaîne vide.
+QString GameOptions::convertLevelFileName() const {
+    return m_convertLevelFileName;
+}
+
+//! \return vrai si une graine a été imposée.
+bool GameOptions::hasSeed() const {
+    return m_hasSeed;
+}
+
+//! \return la graine imposée du générateur pseudo-aléatoire.
+quint64 GameOptions::seed() const {
+    return m_seed;
+}
+
+//! \return vrai si le niveau doit être généré plutôt que lu.
+bool GameOptions::generateLevel() const {
+    return m_generateLevel;
+}
+
+//! \return les paramètres du niveau à générer.
+LevelGenerator::Parameters GameOptions::levelParameters() const {
+    return m_levelParameters;
+}
+
+//! \return vrai si le jeu doit être lancé en mode sans fin.
+bool GameOptions::endless() const {
+    return m_endless;
+}
+
+//! \return la façon d'attendre le tick suivant.
+LoopScheduler::Mode GameOptions::loopMode() const {
+    return m_loopMode;
+}
+
+//! \return l'échelle du temps de simulation.
+double GameOptions::timeScale() const {
+    return m_timeScale;
+}
+
+//! \return vrai si le tick ne doit jamais être suspendu.
+bool GameOptions::continuousTick() const {
+    return m_continuousTick;
+}
+
+//! \return le fichier dans lequel écrire la trace de l'exécution, ou une chaîne vide.
+QString GameOptions::traceFileName() const {
+    return m_traceFileName;
+}
+
+//! \return vrai si le jeu doit être simulé sans fenêtre.
+bool GameOptions::headless() const {
+    return m_headless;
+}
+
+//! \return le nombre de ticks à simuler en mode sans fenêtre.
+long long GameOptions::headlessTickCount() const {
+    return m_headlessTickCount;
+}
+
+//! \return vrai si le jeu doit être joué automatiquement.
+bool GameOptions::autoPlay() const {
+    return m_autoPlay;
+}
+
+//! \return le nom du journal dans lequel les entrées doivent être enregistrées, ou une chaîne vide.
+QString GameOptions::recordFileName() const {
+    return m_recordFileName;
+}
+
+//! \return le nom du journal des entrées à rejouer, ou une chaîne vide.
+QString GameOptions::replayFileName() const {
+    return m_replayFileName;
+}
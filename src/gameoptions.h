@@ -0,0 +1,92 @@
+/**
+  \file
+  \brief    Déclaration de la classe GameOptions.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef GAMEOPTIONS_H
+#define GAMEOPTIONS_H
+
+#include <QString>
+
+#include "levelgenerator.h"
+#include "loopscheduler.h"
+
+class QCoreApplication;
+
+//! \brief Classe qui mémorise les options passées au jeu sur la ligne de commande.
+//!
+//! Les options sont lues une seule fois, par process(), au démarrage de l'application
+//! (voir main()). Elles sont ensuite accessibles depuis n'importe quelle classe du jeu
+//! grâce à l'instance unique retournée par instance().
+//!
+//! Options disponibles :
+//! - `--res-dir <dir>` : répertoire des ressources à utiliser.
+//! - `--pack-assets` : produit le paquet d'images pré-décodées (voir AssetBundle), puis quitte.
+//! - `--level <fichier>` : niveau à charger (voir LevelReader).
+//! - `--convert-level <fichier>` : convertit un niveau texte au format binaire, puis quitte.
+//! - `--seed <n>` : graine du générateur pseudo-aléatoire du jeu (aléatoire par défaut).
+//! - `--generate <colonnes>x<rangées>` : génère un niveau (voir LevelGenerator) au lieu de le lire.
+//! - `--density <d>`, `--unbreakable <r>`, `--hit-points <n>` : paramètres du niveau généré.
+//! - `--endless` : mode sans fin, les briques défilent vers le bas (voir EndlessField).
+//! - `--loop-mode <auto|timer|busy>` : façon d'attendre le tick suivant (voir LoopScheduler).
+//! - `--time-scale <x>` : échelle du temps de simulation (voir GameCanvas::setTimeScale()).
+//! - `--continuous-tick` : le tick n'est jamais suspendu, même sur une scène inactive (voir GameCanvas).
+//! - `--trace <fichier>` : écrit une trace de l'exécution, à ouvrir dans Perfetto (voir TraceWriter).
+//! - `--headless` : simule une partie sans fenêtre, aussi vite que possible (voir GameCanvas::runHeadless()).
+//! - `--ticks <n>` : nombre de ticks simulés en mode `--headless`.
+//! - `--autoplay` : le jeu est joué automatiquement, partie après partie (voir AutoPlayer).
+//! - `--record <fichier>` : enregistre les entrées du joueur dans un journal (voir InputLog).
+//! - `--replay <fichier>` : rejoue un journal des entrées, avec sa graine. Les options de niveau doivent
+//!   être celles de l'enregistrement. Avec `--headless`, le journal est rejoué aussi vite que possible.
+class GameOptions
+{
+public:
+    static GameOptions& instance();
+
+    void process(const QCoreApplication& rApplication);
+
+    QString resourcesPath() const;
+    bool packAssets() const;
+    QString levelFileName() const;
+    QString convertLevelFileName() const;
+
+    bool hasSeed() const;
+    quint64 seed() const;
+    bool generateLevel() const;
+    LevelGenerator::Parameters levelParameters() const;
+    bool endless() const;
+    LoopScheduler::Mode loopMode() const;
+    double timeScale() const;
+    bool continuousTick() const;
+    QString traceFileName() const;
+    bool headless() const;
+    long long headlessTickCount() const;
+    bool autoPlay() const;
+    QString recordFileName() const;
+    QString replayFileName() const;
+
+private:
+    GameOptions();
+
+    QString m_resourcesPath;
+    bool m_packAssets;
+    QString m_levelFileName;
+    QString m_convertLevelFileName;
+    bool m_hasSeed;
+    quint64 m_seed;
+    bool m_generateLevel;
+    LevelGenerator::Parameters m_levelParameters;
+    bool m_endless;
+    LoopScheduler::Mode m_loopMode;
+    double m_timeScale;
+    bool m_continuousTick;
+    QString m_traceFileName;
+    bool m_headless;
+    long long m_headlessTickCount;
+    bool m_autoPlay;
+    QString m_recordFileName;
+    QString m_replayFileName;
+};
+
+#endif // GAMEOPTIONS_H
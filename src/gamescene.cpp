@@ -15,9 +15,15 @@
 #include <QPainter>
 #include <QPen>
 
+#include "frameprofiler.h"
 #include "gamecore.h"
 #include "resources.h"
 #include "sprite.h"
+#include "staticsprite.h"
+
+//! Marge (proportion de la taille de la caméra) autour de la zone montrée par la caméra,
+//! dans laquelle les sprites sont encore cadencés à pleine fréquence.
+const qreal ACTIVE_MARGIN_RATIO = 0.25;
 
 //! Construit la scène de jeu avec une taille par défaut et un fond noir.
 //! \param pParent  Objet propriétaire de cette scène.
@@ -44,6 +50,10 @@ GameScene::GameScene(qreal X, qreal Y, qreal width, qreal height, QObject* pPare
 
 //! Destruction de la scène.
 GameScene::~GameScene()  {
+    // Les sprites sont effacés tant que la scène est intègre, car ils s'en
+    // désabonnent (cadence) au moment de leur destruction.
+    clear();
+
     delete m_pBackgroundImage;
     m_pBackgroundImage = nullptr;
 }
@@ -51,14 +61,13 @@ GameScene::~GameScene()  {
 //! Ajoute le sprite à la scène.
 //! La scène prend possession du sprite et se chargera de l'effacer.
 //! \param pSprite Pointeur sur le sprite à ajouter à la scène.
-void GameScene::addSpriteToScene(Sprite* pSprite)
+void GameScene::addSpriteToScene(StaticSprite* pSprite)
 {
     Q_ASSERT(pSprite != nullptr);
 
     this->addItem(pSprite);
     pSprite->setParentScene(this);
-
-    connect(pSprite, &Sprite::destroyed, this, &GameScene::onSpriteDestroyed);
+    registerSprite(pSprite);
 
     emit spriteAddedToScene(pSprite);
 }
@@ -67,7 +76,7 @@ void GameScene::addSpriteToScene(Sprite* pSprite)
 //! La scène prend possession du sprite et se chargera de l'effacer.
 //! \param pSprite  Pointeur sur le sprite à ajouter à la scène.
 //! \param pos      Position du sprite.
-void GameScene::addSpriteToScene(Sprite* pSprite, QPointF pos)
+void GameScene::addSpriteToScene(StaticSprite* pSprite, QPointF pos)
 {
     addSpriteToScene(pSprite);
     pSprite->setPos(pos.x(), pos.y());
@@ -78,7 +87,7 @@ void GameScene::addSpriteToScene(Sprite* pSprite, QPointF pos)
 //! \param pSprite Pointeur sur le sprite à ajouter à la scène.
 //! \param posX    Position X du sprite.
 //! \param posY    Position Y du sprite.
-void GameScene::addSpriteToScene(Sprite* pSprite, double posX, double posY)
+void GameScene::addSpriteToScene(StaticSprite* pSprite, double posX, double posY)
 {
     addSpriteToScene(pSprite);
     pSprite->setPos(posX, posY);
@@ -87,30 +96,52 @@ void GameScene::addSpriteToScene(Sprite* pSprite, double posX, double posY)
 //! Retire le sprite de la scène.
 //! La scène n'est plus propriétaire du sprite et ne se chargera pas de l'effacer.
 //! \param pSprite Pointeur sur le sprite à enlever de la scène.
-void GameScene::removeSpriteFromScene(Sprite* pSprite)
+void GameScene::removeSpriteFromScene(StaticSprite* pSprite)
 {
     removeItem(pSprite);
 
-    disconnect(pSprite, &Sprite::destroyed, this, &GameScene::onSpriteDestroyed);
+    if (pSprite->type() == Sprite::SpriteItemType)
+        m_tickRegistry.remove(static_cast<Sprite*>(pSprite));
 
-    m_registeredForTickSpriteList.removeAll(pSprite);
+    unregisterSprite(pSprite);
+    pSprite->setParentScene(nullptr);
 
     emit spriteRemovedFromScene(pSprite);
 
 }
 
+//! Planifie la destruction du sprite donné.
+//! Le sprite est détruit à la fin de la cadence en cours (ou de la prochaine),
+//! ce qui permet de l'appeler depuis Sprite::tick() sans invalider les sprites
+//! en cours de traitement. C'est l'équivalent de QObject::deleteLater() pour un StaticSprite.
+//! Juste avant sa destruction, le signal spriteDestroyed() est émis.
+//! Appeler cette méthode plusieurs fois pour le même sprite n'a pas d'effet supplémentaire.
+//! \param pSprite Pointeur sur le sprite à détruire.
+void GameScene::destroySpriteLater(StaticSprite* pSprite)
+{
+    Q_ASSERT(pSprite != nullptr);
+
+    if (pSprite->m_isDestroyPending)
+        return;
+
+    pSprite->m_isDestroyPending = true;
+    m_spritesToDestroy.append(pSprite);
+}
+
 //! Construit la liste de tous les sprites en collision avec le sprite donné en
 //! paramètre.
 //! Si la scène contient de nombreux sprites, cette méthode peut prendre du temps.
 //! \param pSprite Sprite pour lequel les collisions doivent être vérifiées.
 //! \return une liste de sprites en collision. Si aucun autre sprite ne collisionne
 //! le sprite donné, la liste retournée est vide.
-QList<Sprite*> GameScene::collidingSprites(const Sprite* pSprite) const {
-    QList<Sprite*> spriteList;
+QList<StaticSprite*> GameScene::collidingSprites(const StaticSprite* pSprite) const {
+    ProfileScope profileScope("GameScene::collidingSprites");
+
+    QList<StaticSprite*> spriteList;
     const auto collidingItems = pSprite->collidingItems();
     for(QGraphicsItem* pItem : collidingItems) {
-        if (pItem->type() == Sprite::SpriteItemType)
-            spriteList << static_cast<Sprite*>(pItem);
+        if (StaticSprite::isSpriteItem(pItem))
+            spriteList << static_cast<StaticSprite*>(pItem);
     }
     return spriteList;
 }
@@ -120,12 +151,16 @@ QList<Sprite*> GameScene::collidingSprites(const Sprite* pSprite) const {
 //! Si la scène contient de nombreux sprites, cette méthode peut prendre du temps.
 //! \param rRect Rectangle avec lequel il faut tester les collisions.
 //! \return une liste de sprites en collision.
-QList<Sprite*> GameScene::collidingSprites(const QRectF &rRect) const  {
-    QList<Sprite*> collidingSpriteList;
-    for(Sprite* pSprite : sprites())  {
-        QRectF globalBBox = pSprite->globalBoundingBox();
-        if (globalBBox.intersects(rRect)) {
-            collidingSpriteList << pSprite;
+QList<StaticSprite*> GameScene::collidingSprites(const QRectF &rRect) const  {
+    ProfileScope profileScope("GameScene::collidingSprites");
+
+    QList<StaticSprite*> collidingSpriteList;
+    for (int category = 0; category < StaticSprite::CategoryCount; ++category) {
+        for(StaticSprite* pSprite : m_spritesByCategory[category])  {
+            QRectF globalBBox = pSprite->globalBoundingBox();
+            if (globalBBox.intersects(rRect)) {
+                collidingSpriteList << pSprite;
+            }
         }
     }
     return collidingSpriteList;
@@ -136,10 +171,10 @@ QList<Sprite*> GameScene::collidingSprites(const QRectF &rRect) const  {
 //! Si la scène contient de nombreux sprites, cette méthode peut prendre du temps.
 //! \param rShape Forme avec laquelle il faut tester les collisions.
 //! \return une liste de sprites en collision.
-QList<Sprite*> GameScene::collidingSprites(const QPainterPath& rShape) const {
-    QList<Sprite*> collidingSpriteList;
+QList<StaticSprite*> GameScene::collidingSprites(const QPainterPath& rShape) const {
+    QList<StaticSprite*> collidingSpriteList;
     auto spriteList = collidingSprites(rShape.boundingRect());
-    for(Sprite* pSprite : spriteList)  {
+    for(StaticSprite* pSprite : spriteList)  {
         if (pSprite->globalShape().intersects(rShape)) {
             collidingSpriteList << pSprite;
         }
@@ -148,24 +183,58 @@ QList<Sprite*> GameScene::collidingSprites(const QPainterPath& rShape) const {
 }
 
 //!
-//! \return la liste des sprites de cette scène (y compris ceux qui ne sont pas visibles).
+//! \return la liste des sprites de cette scène (y compris ceux qui ne sont pas visibles),
+//! regroupés par catégorie.
 //!
-QList<Sprite*> GameScene::sprites() const  {
-    QList<Sprite*> spriteList;
-    auto allItems = this->items();
-    for(QGraphicsItem* pItem : allItems) {
-        if (pItem->type() == Sprite::SpriteItemType)
-            spriteList << static_cast<Sprite*>(pItem);
+QList<StaticSprite*> GameScene::sprites() const  {
+    QList<StaticSprite*> spriteList;
+    for (int category = 0; category < StaticSprite::CategoryCount; ++category) {
+        for(StaticSprite* pSprite : m_spritesByCategory[category])
+            spriteList << pSprite;
     }
     return spriteList;
 }
 
+//! \param category Catégorie des sprites recherchés.
+//! \return le tableau (dans un ordre quelconque) des sprites de cette scène qui
+//! appartiennent à la catégorie donnée. Ce tableau ne doit pas être conservé : il
+//! est modifié chaque fois qu'un sprite est ajouté ou retiré de la scène.
+const QVector<StaticSprite*>& GameScene::sprites(StaticSprite::Category category) const {
+    return m_spritesByCategory[category];
+}
+
+//! \param category Catégorie des sprites à compter.
+//! \return le nombre de sprites de cette scène qui appartiennent à la catégorie donnée.
+int GameScene::spriteCount(StaticSprite::Category category) const {
+    return m_spritesByCategory[category].count();
+}
+
+//! Retrouve le sprite auquel se réfère le handle donné.
+//! \param rHandle Handle du sprite recherché.
+//! \return un pointeur sur le sprite, ou null si le handle est nul, périmé (le sprite a
+//! été détruit ou retiré de la scène) ou s'il appartient à une autre scène.
+StaticSprite* GameScene::sprite(const SpriteHandle& rHandle) const {
+    if (rHandle.index < 0 || rHandle.index >= m_entities.count())
+        return nullptr;
+
+    const EntitySlot& rSlot = m_entities[rHandle.index];
+    if (rSlot.generation != rHandle.generation)
+        return nullptr;
+
+    return rSlot.pSprite;
+}
+
+//! \return vrai si le handle donné se réfère à un sprite de cette scène qui existe toujours.
+bool GameScene::isAlive(const SpriteHandle& rHandle) const {
+    return sprite(rHandle) != nullptr;
+}
+
 //! Récupère le sprite visible le plus en avant se trouvant à la position donnée.
 //! \return un pointeur sur le sprite trouvé, ou null si aucun sprite ne se trouve à cette position.
-Sprite* GameScene::spriteAt(const QPointF& rPosition) const {
+StaticSprite* GameScene::spriteAt(const QPointF& rPosition) const {
     QGraphicsItem* pTopMostVisibleItem = this->itemAt(rPosition, QTransform());
-    if (pTopMostVisibleItem && pTopMostVisibleItem->type() == Sprite::SpriteItemType)
-        return static_cast<Sprite*>(pTopMostVisibleItem);
+    if (pTopMostVisibleItem && StaticSprite::isSpriteItem(pTopMostVisibleItem))
+        return static_cast<StaticSprite*>(pTopMostVisibleItem);
 
     return nullptr;
 }
@@ -197,6 +266,11 @@ void GameScene::setBackgroundImage(const QImage& rImage)  {
     m_pBackgroundImage = new QImage(rImage);
 }
 
+//! \return la taille des pixels de l'image de fond, en octets (0 sans image de fond).
+qint64 GameScene::backgroundImageSize() const {
+    return m_pBackgroundImage ? m_pBackgroundImage->sizeInBytes() : 0;
+}
+
 //! Défini la couleur de fond de cette scène.
 void GameScene::setBackgroundColor(QColor color) {
     if (m_pBackgroundImage) {
@@ -220,15 +294,36 @@ void GameScene::setHeight(int sceneHeight)  {
 }
 
 //! Le sprite donné sera informé du tick.
+//! Un sprite déjà enregistré ne l'est pas une seconde fois.
 //! \param pSprite Sprite qui s'enregistre pour le tick.
 void GameScene::registerSpriteForTick(Sprite* pSprite) {
-    m_registeredForTickSpriteList.append(pSprite);
+    const bool wasEmpty = (m_tickRegistry.count() == 0);
+    m_tickRegistry.add(pSprite);
+    if (wasEmpty && m_tickRegistry.count() > 0)
+        emit tickRequested();
 }
 
 //! Le sprite donné se va plus être informé du tick.
 //! \param pSprite Sprite qui démissionne du tick.
 void GameScene::unregisterSpriteFromTick(Sprite* pSprite) {
-    m_registeredForTickSpriteList.removeAll(pSprite);
+    m_tickRegistry.remove(pSprite);
+}
+
+//! \return vrai si la scène n'a besoin d'aucune cadence : aucun sprite n'y est cadencé,
+//! aucun sprite n'y est animé et aucun sprite n'y attend sa destruction.
+//! Le parcours des sprites n'est fait que si aucun sprite n'est cadencé.
+bool GameScene::isIdle() const {
+    if (m_tickRegistry.count() > 0 || !m_spritesToDestroy.isEmpty())
+        return false;
+
+    for (int category = 0; category < StaticSprite::CategoryCount; ++category) {
+        for (StaticSprite* pStaticSprite : m_spritesByCategory[category]) {
+            Sprite* pSprite = dynamic_cast<Sprite*>(pStaticSprite);
+            if (pSprite && pSprite->isAnimationRunning())
+                return false;
+        }
+    }
+    return true;
 }
 
 //! Vérifie si la position donnée fait partie de la scène.
@@ -247,15 +342,48 @@ bool GameScene::isInsideScene(const QRectF& rRect) const {
     return sceneRect().contains(rRect);
 }
 
+//! \return la caméra de la scène.
+Camera& GameScene::camera() {
+    return m_camera;
+}
+
+//! \return la caméra de la scène.
+const Camera& GameScene::camera() const {
+    return m_camera;
+}
+
+//! La surface de la scène a changé : les limites de la caméra sont adaptées.
+//! \param rRect  Nouvelle surface de la scène.
+void GameScene::onSceneRectChanged(const QRectF& rRect) {
+    m_camera.setBounds(rRect);
+}
+
 //! Cadence.
 //! \param elapsedTimeInMilliseconds  Temps écoulé depuis le tick précédent.
 void GameScene::tick(long long elapsedTimeInMilliseconds) {
-    auto spriteListCopy = m_registeredForTickSpriteList; // On travaille sur une copie au cas où
-                                        // la liste originale serait modifiée
-                                        // lors de l'appel de tick auprès d'un sprite.
-    for(Sprite* pSprite : spriteListCopy) {
-        pSprite->tick(elapsedTimeInMilliseconds);
+    ProfileScope profileScope("GameScene::tick");
+
+    // Les sprites peuvent s'abonner ou se désabonner pendant le parcours :
+    // TickRegistry applique les retraits une fois le parcours terminé.
+    // Seuls les sprites proches de la zone montrée par la caméra sont cadencés à
+    // pleine fréquence. Si la caméra est désactivée, tous les sprites le sont.
+    if (m_camera.isEnabled()) {
+        QRectF cameraRect = m_camera.rect();
+        QRectF activeRect = cameraRect.adjusted(-cameraRect.width() * ACTIVE_MARGIN_RATIO, -cameraRect.height() * ACTIVE_MARGIN_RATIO,
+                                                cameraRect.width() * ACTIVE_MARGIN_RATIO, cameraRect.height() * ACTIVE_MARGIN_RATIO);
+        m_tickRegistry.tick(elapsedTimeInMilliseconds, activeRect);
+    } else {
+        m_tickRegistry.tick(elapsedTimeInMilliseconds);
     }
+
+    destroyPendingSprites();
+}
+
+//! Définit la répartition par type de sprite dans laquelle la durée de la cadence de
+//! chaque sprite est cumulée (voir TickRegistry::setTypeProfile()).
+//! \param pProfile  Répartition à compléter, ou nullptr pour ne pas mesurer la cadence.
+void GameScene::setTickProfile(SpriteTypeTickProfile* pProfile) {
+    m_tickRegistry.setTypeProfile(pProfile);
 }
 
 //! Dessine le fond d'écran de la scène.
@@ -273,14 +401,105 @@ void GameScene::drawBackground(QPainter* pPainter, const QRectF& rRect)  {
 //! Initialise la scène
 void GameScene::init() {
     m_pBackgroundImage = nullptr;
+    m_firstFreeEntity = -1;
 
     this->setBackgroundBrush(QBrush(Qt::black));
+
+    m_camera.setBounds(sceneRect());
+    connect(this, &QGraphicsScene::sceneRectChanged, this, &GameScene::onSceneRectChanged);
     //setBackgroundImage(QImage(GameFramework::imagesPath() + "space.jpg"));
 
 }
 
-//! Retire de la liste des sprite le sprite qui va être détruit.
-void GameScene::onSpriteDestroyed(QObject* pSprite) {
-    Sprite* pSpriteDestroyed = static_cast<Sprite*>(pSprite);
-    m_registeredForTickSpriteList.removeAll(pSpriteDestroyed);
+//! Détruit les sprites dont la destruction a été planifiée avec destroySpriteLater().
+void GameScene::destroyPendingSprites() {
+    // On travaille sur une copie au cas où la destruction d'un sprite en planifierait d'autres.
+    const auto spritesToDestroy = m_spritesToDestroy;
+    m_spritesToDestroy.clear();
+
+    for (StaticSprite* pSprite : spritesToDestroy) {
+        pSprite->m_isDestroyPending = false;
+        emit spriteDestroyed(pSprite);
+        delete pSprite;
+    }
+}
+
+//! Range le sprite dans le tableau de sa catégorie et lui attribue un emplacement
+//! de la table des entités, et donc un handle.
+//! \param pSprite Sprite à ajouter au registre.
+void GameScene::registerSprite(StaticSprite* pSprite) {
+    addSpriteToCategory(pSprite);
+
+    int slotIndex = m_firstFreeEntity;
+    if (slotIndex >= 0) {
+        m_firstFreeEntity = m_entities[slotIndex].nextFreeSlot;
+    } else {
+        slotIndex = m_entities.count();
+        m_entities.append(EntitySlot { nullptr, 0, -1 });
+    }
+
+    EntitySlot& rSlot = m_entities[slotIndex];
+    rSlot.pSprite = pSprite;
+    rSlot.nextFreeSlot = -1;
+    pSprite->m_handle.index = slotIndex;
+    pSprite->m_handle.generation = rSlot.generation;
+}
+
+//! Retire le sprite du registre et libère son emplacement de la table des entités :
+//! la génération de l'emplacement est incrémentée, ce qui rend périmés tous les handles
+//! qui s'y réfèrent encore.
+//! Si la destruction du sprite avait été planifiée, elle est annulée.
+//! \param pSprite Sprite à retirer du registre.
+void GameScene::unregisterSprite(StaticSprite* pSprite) {
+    removeSpriteFromCategory(pSprite);
+
+    int slotIndex = pSprite->m_handle.index;
+    if (slotIndex >= 0) {
+        EntitySlot& rSlot = m_entities[slotIndex];
+        Q_ASSERT(rSlot.pSprite == pSprite);
+        rSlot.pSprite = nullptr;
+        rSlot.generation++;
+        rSlot.nextFreeSlot = m_firstFreeEntity;
+        m_firstFreeEntity = slotIndex;
+        pSprite->m_handle = SpriteHandle();
+    }
+
+    if (pSprite->m_isDestroyPending) {
+        m_spritesToDestroy.removeAll(pSprite);
+        pSprite->m_isDestroyPending = false;
+    }
+}
+
+//! Change la catégorie d'un sprite de la scène, sans modifier son handle.
+//! \param pSprite   Sprite à reclasser.
+//! \param category  Nouvelle catégorie du sprite.
+void GameScene::changeSpriteCategory(StaticSprite* pSprite, StaticSprite::Category category) {
+    removeSpriteFromCategory(pSprite);
+    pSprite->m_category = category;
+    addSpriteToCategory(pSprite);
+}
+
+//! Range le sprite dans le tableau de sa catégorie.
+//! \param pSprite Sprite à ranger.
+void GameScene::addSpriteToCategory(StaticSprite* pSprite) {
+    QVector<StaticSprite*>& rSprites = m_spritesByCategory[pSprite->m_category];
+    pSprite->m_categoryIndex = rSprites.count();
+    rSprites.append(pSprite);
+}
+
+//! Retire le sprite du tableau de sa catégorie, en temps constant : le dernier
+//! sprite du tableau prend sa place.
+//! \param pSprite Sprite à retirer.
+void GameScene::removeSpriteFromCategory(StaticSprite* pSprite) {
+    int index = pSprite->m_categoryIndex;
+    if (index < 0)
+        return;
+
+    QVector<StaticSprite*>& rSprites = m_spritesByCategory[pSprite->m_category];
+    Q_ASSERT(rSprites[index] == pSprite);
+    StaticSprite* pLastSprite = rSprites.last();
+    rSprites[index] = pLastSprite;
+    pLastSprite->m_categoryIndex = index;
+    rSprites.removeLast();
+    pSprite->m_categoryIndex = -1;
 }
@@ -7,9 +7,14 @@
 #ifndef GAMESCENE_H
 #define GAMESCENE_H
 
+#include "camera.h"
 #include "gamecanvas.h"
+#include "spritehandle.h"
+#include "staticsprite.h"
+#include "tickregistry.h"
 
 #include <QGraphicsScene>
+#include <QVector>
 
 class Sprite;
 class QGraphicsSimpleTextItem;
@@ -22,10 +27,16 @@ class QPainter;
 //! La taille de l'espace de jeu (appelé une *scene*) peut être spécifié avec les méthodes setWidth() et setHeight().
 //!
 //! Cette classe met à disposition différentes méthodes pour simplifier le travail de développement d'un jeu :
-//! - Gestion de sprites (Sprite) avec la méthode addSpriteToScene()
+//! - Gestion de sprites (Sprite et StaticSprite) avec la méthode addSpriteToScene()
+//! - Destruction différée des sprites avec la méthode destroySpriteLater()
+//! - Registre des sprites par catégorie (briques, balles, plateaux, murs, interface) avec les méthodes
+//!   sprites(StaticSprite::Category) et spriteCount()
+//! - Table des entités, qui associe à chaque sprite un handle générationnel (SpriteHandle)
+//!   permettant de le retrouver avec sprite() et de détecter qu'il a été détruit
 //! - Détection de collisions avec la méthode collidingSprites()
 //! - Détection du sprite à une position donnée avec spriteAt()
 //! - Affichage de textes avec la méthode createText()
+//! - Caméra (camera()) qui détermine la partie de la scène affichée par GameView
 //!
 //! Cette classe ne gère pas la logique du jeu.
 //!
@@ -34,6 +45,12 @@ class QPainter;
 //! registerSpriteForTick().
 //!
 //! La méthode unregisterSpriteFromTick() permet de désabonner un sprite à la cadence.
+//! Une scène sans sprite cadencé, ni animation en cours, ni sprite à détruire est inactive
+//! (isIdle()) : GameCanvas peut alors suspendre la cadence. Le signal tickRequested() est
+//! émis lorsqu'un sprite s'abonne à la cadence d'une scène qui n'en avait aucun.
+//!
+//! Lorsque la caméra est activée, seuls les sprites proches de la zone qu'elle montre
+//! sont cadencés à chaque tick. Les autres le sont à fréquence réduite (voir TickRegistry).
 //!
 //! Les événements de clavier et de la souris qu'elle reçoit sont interceptés par GameCanvas (au moyen d'un filtre à événements) et
 //! retransmis à GameCore.
@@ -45,21 +62,27 @@ class GameScene : public QGraphicsScene
 public:
     ~GameScene();
 
-    void addSpriteToScene(Sprite* pSprite);
-    void addSpriteToScene(Sprite* pSprite, QPointF pos);
-    void addSpriteToScene(Sprite* pSprite, double posX, double posY);
-    void removeSpriteFromScene(Sprite* pSprite);
-
-    QList<Sprite*> collidingSprites(const Sprite* pSprite) const;
-    QList<Sprite*> collidingSprites(const QRectF& rRect) const;
-    QList<Sprite*> collidingSprites(const QPainterPath& rShape) const;
-    QList<Sprite*> sprites() const;
-    Sprite* spriteAt(const QPointF& rPosition) const;
+    void addSpriteToScene(StaticSprite* pSprite);
+    void addSpriteToScene(StaticSprite* pSprite, QPointF pos);
+    void addSpriteToScene(StaticSprite* pSprite, double posX, double posY);
+    void removeSpriteFromScene(StaticSprite* pSprite);
+    void destroySpriteLater(StaticSprite* pSprite);
+
+    QList<StaticSprite*> collidingSprites(const StaticSprite* pSprite) const;
+    QList<StaticSprite*> collidingSprites(const QRectF& rRect) const;
+    QList<StaticSprite*> collidingSprites(const QPainterPath& rShape) const;
+    QList<StaticSprite*> sprites() const;
+    const QVector<StaticSprite*>& sprites(StaticSprite::Category category) const;
+    int spriteCount(StaticSprite::Category category) const;
+    StaticSprite* sprite(const SpriteHandle& rHandle) const;
+    bool isAlive(const SpriteHandle& rHandle) const;
+    StaticSprite* spriteAt(const QPointF& rPosition) const;
 
     QGraphicsSimpleTextItem* createText(QPointF initialPosition, const QString& rText, int size = 10, QColor color=Qt::white);
 
     void setBackgroundImage(const QImage& rImage);
     void setBackgroundColor(QColor color);
+    qint64 backgroundImageSize() const;
 
     void setWidth(int sceneWidth);
     int width() const { return static_cast<int>(sceneRect().width()); }
@@ -68,15 +91,25 @@ public:
 
     void registerSpriteForTick(Sprite* pSprite);
     void unregisterSpriteFromTick(Sprite* pSprite);
+    bool isIdle() const;
 
     bool isInsideScene(const QPointF& rPosition) const;
     bool isInsideScene(const QRectF& rRect) const;
 
+    Camera& camera();
+    const Camera& camera() const;
+
     virtual void tick(long long elapsedTimeInMilliseconds);
+    void setTickProfile(SpriteTypeTickProfile* pProfile);
 
 signals:
-    void spriteAddedToScene(Sprite* pSprite);
-    void spriteRemovedFromScene(Sprite* pSprite);
+    void spriteAddedToScene(StaticSprite* pSprite);
+    void spriteRemovedFromScene(StaticSprite* pSprite);
+    void spriteDestroyed(StaticSprite* pSprite);
+    void tickRequested();
+
+private slots:
+    void onSceneRectChanged(const QRectF& rRect);
 
 protected:
     virtual void drawBackground(QPainter* pPainter, const QRectF& rRect);
@@ -92,13 +125,32 @@ private:
     explicit GameScene(const QRectF& rSceneRect, QObject* pParent = nullptr);
     explicit GameScene(qreal x, qreal y, qreal width, qreal height, QObject* pParent = nullptr);
 
+    // StaticSprite se retire lui-même du registre lors de sa destruction
+    // et y change de catégorie.
+    friend class StaticSprite;
+
     void init();
+    void destroyPendingSprites();
+    void registerSprite(StaticSprite* pSprite);
+    void unregisterSprite(StaticSprite* pSprite);
+    void changeSpriteCategory(StaticSprite* pSprite, StaticSprite::Category category);
+    void addSpriteToCategory(StaticSprite* pSprite);
+    void removeSpriteFromCategory(StaticSprite* pSprite);
+
+    //! Emplacement de la table des entités.
+    struct EntitySlot {
+        StaticSprite* pSprite;
+        quint32 generation;
+        int nextFreeSlot;
+    };
 
     QImage* m_pBackgroundImage;
-    QList<Sprite*> m_registeredForTickSpriteList;
-
-private slots:
-    void onSpriteDestroyed(QObject* pSprite);
+    TickRegistry m_tickRegistry;
+    Camera m_camera;
+    QVector<EntitySlot> m_entities;
+    int m_firstFreeEntity;
+    QVector<StaticSprite*> m_spritesByCategory[StaticSprite::CategoryCount];
+    QList<StaticSprite*> m_spritesToDestroy;
 };
 
 #endif // GAMESCENE_H
@@ -9,6 +9,10 @@
 #include <QDebug>
 #include <QMouseEvent>
 
+#include "frameprofiler.h"
+#include "gamescene.h"
+#include "utilities.h"
+
 //! Construit une fenêtre de visualisation de la scène de jeu.
 //! \param pParent  Widget parent.
 GameView::GameView(QWidget* pParent) : QGraphicsView(pParent) {
@@ -54,8 +58,55 @@ void GameView::resizeEvent(QResizeEvent* pEvent) {
     QGraphicsView::resizeEvent(pEvent);
     m_clippingRectUpToDate = false;
     if (m_fitToScreen) {
-        fitInView(sceneRect(), Qt::KeepAspectRatio);
+        fitVisibleSceneRect();
+    }
+}
+
+//! Adapte l'affichage à la caméra de la scène affichée, si elle a été déplacée ou si
+//! la scène affichée a changé. Ne fait rien si la partie visible de la scène est inchangée.
+void GameView::updateCamera() {
+    if (visibleSceneRect() == m_visibleRect)
+        return;
+
+    m_clippingRectUpToDate = false;
+    fitVisibleSceneRect();
+}
+
+//! \return la partie de la scène à afficher : la zone montrée par la caméra de la
+//! scène si elle est activée, sinon toute la surface de la scène.
+QRectF GameView::visibleSceneRect() const {
+    GameScene* pScene = dynamic_cast<GameScene*>(scene());
+    if (pScene && pScene->camera().isEnabled())
+        return pScene->camera().rect();
+    return sceneRect();
+}
+
+//! Adapte l'affichage pour que la partie visible de la scène remplisse la fenêtre.
+void GameView::fitVisibleSceneRect() {
+    m_visibleRect = visibleSceneRect();
+    if (m_fitToScreen)
+        fitInView(m_visibleRect, Qt::KeepAspectRatio);
+    else
+        centerOn(m_visibleRect.center());
+}
+
+//! Dessine la scène.
+//! A la fin du dessin, le signal framePainted() est émis.
+//! Lors du premier dessin, le temps écoulé depuis le démarrage de l'application
+//! (time-to-first-frame) est affiché dans la sortie de debug.
+//! \param pEvent   Evénement de dessin reçu.
+void GameView::paintEvent(QPaintEvent* pEvent) {
+    {
+        ProfileScope profileScope("GameView::paint");
+        QGraphicsView::paintEvent(pEvent);
+    }
+
+    if (!m_firstFramePainted && scene() != nullptr) {
+        m_firstFramePainted = true;
+        qDebug() << "Première image affichée" << BrickBreaker::elapsedSinceStartup() << "ms après le démarrage";
     }
+
+    emit framePainted();
 }
 
 //! Si la scène doit être clippée, dessine en avant-plan des rectangles permettant
@@ -68,10 +119,11 @@ void GameView::drawForeground(QPainter* pPainter, const QRectF& rRect) {
         return;
 
     if (!m_clippingRectUpToDate) {
-        m_clippingRect[0] = QRectF(rRect.left(), rRect.top(), rRect.width(), sceneRect().top() - rRect.top());
-        m_clippingRect[1] = QRectF(rRect.left(), sceneRect().top(), sceneRect().left() - rRect.left(), sceneRect().height());
-        m_clippingRect[2] = QRectF(sceneRect().right(), sceneRect().top(), rRect.right() - sceneRect().right(), sceneRect().height());
-        m_clippingRect[3] = QRectF(rRect.left(), sceneRect().bottom(), rRect.width(), rRect.bottom() - sceneRect().bottom());
+        const QRectF visibleRect = visibleSceneRect();
+        m_clippingRect[0] = QRectF(rRect.left(), rRect.top(), rRect.width(), visibleRect.top() - rRect.top());
+        m_clippingRect[1] = QRectF(rRect.left(), visibleRect.top(), visibleRect.left() - rRect.left(), visibleRect.height());
+        m_clippingRect[2] = QRectF(visibleRect.right(), visibleRect.top(), rRect.right() - visibleRect.right(), visibleRect.height());
+        m_clippingRect[3] = QRectF(rRect.left(), visibleRect.bottom(), rRect.width(), rRect.bottom() - visibleRect.bottom());
         m_clippingRectUpToDate = true;
     }
 
@@ -84,6 +136,7 @@ void GameView::init() {
     m_fitToScreen = true;
     m_clipScene = false;
     m_clippingRectUpToDate = false;
+    m_firstFramePainted = false;
 
     setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
 }
@@ -19,9 +19,14 @@
 //!   et peut être enclenchée avec setFitToScreenEnabled().
 //! - Possibilité de "clipper" l'affichage de la scène, afin que tout élment en dehors de la surface de la scène soit
 //!   caché. Cette possibilité est déclanchée par défaut et peut être enclenchée avec setClipSceneEnabled().
+//! - Suivi de la caméra (Camera) de la scène de jeu affichée : si elle est activée, seule la zone qu'elle montre
+//!   est affichée. updateCamera() doit être appelée après chaque déplacement de la caméra ou changement de scène.
+//! - Mesure du temps écoulé entre le démarrage de l'application et l'affichage de la première image.
+//! - Signal framePainted() émis à la fin du dessin de chaque image (voir InputLatencyMonitor).
 //!
 class GameView : public QGraphicsView
 {
+    Q_OBJECT
 public:
     GameView(QWidget* pParent = nullptr);
     GameView(QGraphicsScene* pScene, QWidget* pParent = nullptr);
@@ -32,18 +37,28 @@ public:
     void setClipSceneEnabled(bool clipSceneEnabled);
     bool isClipSceneEnabled() const;
 
+    void updateCamera();
+
+signals:
+    void framePainted();
+
 protected:
     virtual void resizeEvent(QResizeEvent* pEvent);
+    virtual void paintEvent(QPaintEvent* pEvent);
     virtual void drawForeground(QPainter* pPainter, const QRectF& rRect);
 
 private:
     void init();
+    QRectF visibleSceneRect() const;
+    void fitVisibleSceneRect();
 
     bool m_fitToScreen;
     bool m_clipScene;
 
     bool m_clippingRectUpToDate;
+    bool m_firstFramePainted;
     QRectF m_clippingRect[4];
+    QRectF m_visibleRect;
 };
 
 #endif // GAMEVIEW_H
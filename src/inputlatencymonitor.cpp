@@ -0,0 +1,102 @@
+/**
+  \file
+  \brief    Définition de la classe InputLatencyMonitor.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "inputlatencymonitor.h"
+
+#include <algorithm>
+
+#include <QDebug>
+
+// Initialisation des constantes.
+const qint64 NS_PER_MS = 1000000;
+const int LATENCY_SAMPLE_COUNT = 512;
+const qint64 STATISTICS_INTERVAL = 1000 * NS_PER_MS;   // Intervalle de calcul des statistiques.
+const qint64 REPORT_INTERVAL = 10000 * NS_PER_MS;      // Intervalle de signalement des statistiques.
+const qint64 NO_PENDING_INPUT = -1;
+
+//! Construit un moniteur sans mesure.
+InputLatencyMonitor::InputLatencyMonitor() {
+    m_pendingTimestamp = NO_PENDING_INPUT;
+
+    m_samples.resize(LATENCY_SAMPLE_COUNT);
+    m_sampleIndex = 0;
+    m_sampleCount = 0;
+
+    m_lastStatisticsTime = 0;
+    m_lastReportTime = 0;
+    m_latencyP50 = 0;
+    m_latencyP99 = 0;
+    m_latencyMax = 0;
+
+    m_clock.start();
+}
+
+//! \return l'heure actuelle (ns), avec laquelle les événements d'entrée sont horodatés.
+qint64 InputLatencyMonitor::timestamp() const {
+    return m_clock.nsecsElapsed();
+}
+
+//! Une entrée a été transmise au jeu : son effet sera visible à la prochaine image.
+//! \param eventTimestamp  Horodatage de l'événement (voir timestamp()).
+void InputLatencyMonitor::inputApplied(qint64 eventTimestamp) {
+    if (m_pendingTimestamp == NO_PENDING_INPUT || eventTimestamp < m_pendingTimestamp)
+        m_pendingTimestamp = eventTimestamp;
+}
+
+//! Une image vient d'être dessinée : si des entrées ont été transmises depuis l'image
+//! précédente, la latence de la plus ancienne est mesurée.
+void InputLatencyMonitor::framePresented() {
+    if (m_pendingTimestamp == NO_PENDING_INPUT)
+        return;
+
+    const qint64 now = m_clock.nsecsElapsed();
+    m_samples[m_sampleIndex] = now - m_pendingTimestamp;
+    m_sampleIndex = (m_sampleIndex + 1) % LATENCY_SAMPLE_COUNT;
+    m_sampleCount = qMin(m_sampleCount + 1, LATENCY_SAMPLE_COUNT);
+    m_pendingTimestamp = NO_PENDING_INPUT;
+
+    if (now - m_lastStatisticsTime < STATISTICS_INTERVAL)
+        return;
+
+    m_lastStatisticsTime = now;
+    updateStatistics();
+
+    if (now - m_lastReportTime >= REPORT_INTERVAL) {
+        m_lastReportTime = now;
+        qDebug() << "Latence des entrées (ms) : p50" << m_latencyP50 << "p99" << m_latencyP99
+                 << "max" << m_latencyMax << "sur" << m_sampleCount << "mesures";
+    }
+}
+
+//! \return la médiane des dernières latences mesurées, en ms.
+double InputLatencyMonitor::latencyP50() const {
+    return m_latencyP50;
+}
+
+//! \return le 99e centile des dernières latences mesurées, en ms.
+double InputLatencyMonitor::latencyP99() const {
+    return m_latencyP99;
+}
+
+//! \return la plus grande des dernières latences mesurées, en ms.
+double InputLatencyMonitor::latencyMax() const {
+    return m_latencyMax;
+}
+
+//! \return le nombre de latences conservées.
+int InputLatencyMonitor::sampleCount() const {
+    return m_sampleCount;
+}
+
+//! Calcule la médiane, le 99e centile et le maximum des latences conservées.
+void InputLatencyMonitor::updateStatistics() {
+    QVector<qint64> samples = m_samples.mid(0, m_sampleCount);
+    std::sort(samples.begin(), samples.end());
+
+    m_latencyP50 = double(samples[samples.count() / 2]) / NS_PER_MS;
+    m_latencyP99 = double(samples[(samples.count() * 99) / 100]) / NS_PER_MS;
+    m_latencyMax = double(samples.last()) / NS_PER_MS;
+}
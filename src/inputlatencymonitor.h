@@ -0,0 +1,57 @@
+/**
+  \file
+  \brief    Déclaration de la classe InputLatencyMonitor.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef INPUTLATENCYMONITOR_H
+#define INPUTLATENCYMONITOR_H
+
+#include <QElapsedTimer>
+#include <QVector>
+
+//! \brief Classe qui mesure la latence entre une entrée du joueur et l'image qui la montre.
+//!
+//! Chaque événement d'entrée est horodaté à sa réception par l'application (timestamp()).
+//! Lorsque l'événement est transmis au jeu, inputApplied() est appelée avec son horodatage.
+//! A la fin du dessin de l'image suivante (framePresented()), la latence est l'écart entre
+//! l'horodatage de la plus ancienne entrée transmise depuis l'image précédente et l'heure
+//! actuelle. Le délai du système avant la réception de l'événement et celui de l'écran
+//! après le dessin ne sont pas compris dans la mesure.
+//!
+//! Les mesures des dernières entrées sont conservées : la médiane, le 99e centile et le
+//! maximum sont recalculés une fois par seconde (latencyP50(), latencyP99(), latencyMax())
+//! et signalés dans la sortie de debug toutes les dix secondes.
+class InputLatencyMonitor
+{
+public:
+    InputLatencyMonitor();
+
+    qint64 timestamp() const;
+
+    void inputApplied(qint64 eventTimestamp);
+    void framePresented();
+
+    double latencyP50() const;
+    double latencyP99() const;
+    double latencyMax() const;
+    int sampleCount() const;
+
+private:
+    void updateStatistics();
+
+    QElapsedTimer m_clock;
+    qint64 m_pendingTimestamp;      // Horodatage de la plus ancienne entrée pas encore montrée, -1 si aucune.
+
+    QVector<qint64> m_samples;      // Tableau circulaire des dernières latences (ns).
+    int m_sampleIndex;
+    int m_sampleCount;
+
+    qint64 m_lastStatisticsTime;
+    qint64 m_lastReportTime;
+    double m_latencyP50;
+    double m_latencyP99;
+    double m_latencyMax;
+};
+
+#endif // INPUTLATENCYMONITOR_H
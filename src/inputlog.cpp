@@ -0,0 +1,407 @@
+/**
+  \file
+  \brief    Définition de la classe InputLog.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "inputlog.h"
+
+#include <cmath>
+#include <cstring>
+
+#include <QtEndian>
+
+//! Signature placée au début d'un journal des entrées.
+const QByteArray LOG_MAGIC("BBIR");
+//! Version du format du journal. La version 2 ajoute les empreintes de l'état du jeu ;
+//! les journaux de version 1 restent lisibles.
+const char LOG_VERSION = 2;
+//! Plus ancienne version du format lisible.
+const char MIN_LOG_VERSION = 1;
+//! Taille de l'en-tête : signature, version et graine.
+const int LOG_HEADER_SIZE = 4 + 1 + 8;
+//! Bit de l'octet de type indiquant une position de la souris entière.
+const quint8 RECORD_INTEGER_POSITION = 0x80;
+//! Plus grande coordonnée codée comme un entier.
+const double MAX_INTEGER_COORDINATE = 1e9;
+
+//! \return l'entier signé donné, codé de façon à ce que les petites valeurs négatives
+//! restent courtes une fois écrites en longueur variable (zigzag).
+static quint64 zigzagEncode(qint64 value) {
+    return (quint64(value) << 1) ^ quint64(value >> 63);
+}
+
+//! \return l'entier signé codé par zigzagEncode().
+static qint64 zigzagDecode(quint64 value) {
+    return qint64(value >> 1) ^ -qint64(value & 1);
+}
+
+//! \return vrai si les données commencent par un en-tête de journal d'une version lisible.
+static bool isValidHeader(const QByteArray& rData) {
+    if (rData.size() < LOG_HEADER_SIZE || !rData.startsWith(LOG_MAGIC))
+        return false;
+
+    const char version = rData.at(LOG_MAGIC.size());
+    return version >= MIN_LOG_VERSION && version <= LOG_VERSION;
+}
+
+//! \return vrai si la coordonnée donnée peut être codée exactement comme un entier.
+static bool isIntegerCoordinate(qreal coordinate) {
+    return std::floor(coordinate) == coordinate && std::abs(coordinate) <= MAX_INTEGER_COORDINATE;
+}
+
+//! Construit un journal fermé.
+InputLog::InputLog() {
+    m_readPosition = 0;
+    m_isRecording = false;
+    m_isReplaying = false;
+    m_seed = 0;
+    m_tickCount = 0;
+}
+
+//! Destructeur : les enregistrements en attente sont écrits.
+InputLog::~InputLog() {
+    close();
+}
+
+//! Crée un journal et commence son écriture.
+//! \param rFileName  Nom du fichier du journal.
+//! \param seed       Graine du jeu enregistré.
+//! \return faux si le fichier ne peut pas être créé (voir errorString()).
+bool InputLog::create(const QString& rFileName, quint64 seed) {
+    close();
+
+    m_file.setFileName(rFileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return setError(m_file.errorString());
+
+    m_seed = seed;
+    m_tickCount = 0;
+    m_buffer.clear();
+    m_buffer.append(LOG_MAGIC);
+    m_buffer.append(LOG_VERSION);
+    const quint64 littleEndianSeed = qToLittleEndian(seed);
+    m_buffer.append(reinterpret_cast<const char*>(&littleEndianSeed), sizeof(littleEndianSeed));
+    m_isRecording = true;
+    return true;
+}
+
+//! Ouvre un journal en vue de son rejeu. Le journal est lu en entier.
+//! \param rFileName  Nom du fichier du journal.
+//! \return faux si le fichier ne peut pas être lu ou n'est pas un journal (voir errorString()).
+bool InputLog::open(const QString& rFileName) {
+    close();
+
+    m_file.setFileName(rFileName);
+    if (!m_file.open(QIODevice::ReadOnly))
+        return setError(m_file.errorString());
+
+    m_buffer = m_file.readAll();
+    m_file.close();
+
+    if (!isValidHeader(m_buffer))
+        return setError(QString("%1 n'est pas un journal des entrées valide.").arg(rFileName));
+
+    quint64 littleEndianSeed;
+    std::memcpy(&littleEndianSeed, m_buffer.constData() + LOG_MAGIC.size() + 1, sizeof(littleEndianSeed));
+    m_seed = qFromLittleEndian(littleEndianSeed);
+    m_readPosition = LOG_HEADER_SIZE;
+    m_tickCount = 0;
+    m_isReplaying = true;
+    return true;
+}
+
+//! Ferme le journal. En écriture, les enregistrements en attente sont écrits.
+void InputLog::close() {
+    if (m_isRecording) {
+        flush();
+        m_file.close();
+    }
+
+    m_buffer.clear();
+    m_readPosition = 0;
+    m_isRecording = false;
+    m_isReplaying = false;
+}
+
+//! \return vrai si le journal est en cours d'écriture.
+bool InputLog::isRecording() const {
+    return m_isRecording;
+}
+
+//! \return vrai si le journal est en cours de rejeu.
+bool InputLog::isReplaying() const {
+    return m_isReplaying;
+}
+
+//! \return la graine du jeu enregistré.
+quint64 InputLog::seed() const {
+    return m_seed;
+}
+
+//! \return le nombre d'enregistrements de tick écrits ou lus.
+long long InputLog::tickCount() const {
+    return m_tickCount;
+}
+
+//! \return la description de la dernière erreur.
+QString InputLog::errorString() const {
+    return m_errorString;
+}
+
+//! Enregistre un tick. Les enregistrements du tick sont alors écrits dans le fichier : le
+//! journal reste complet même si le jeu s'arrête sans qu'il soit fermé.
+//! \param elapsedTime  Temps écoulé transmis au tick, en ms.
+void InputLog::writeTick(long long elapsedTime) {
+    if (!m_isRecording)
+        return;
+
+    writeType(RecordTick);
+    writeVarint(quint64(qMax(0LL, elapsedTime)));
+    m_tickCount++;
+    flush();
+}
+
+//! Enregistre l'appui sur une touche.
+//! \param key  Touche (voir les constantes Qt).
+void InputLog::writeKeyPressed(int key) {
+    if (!m_isRecording)
+        return;
+
+    writeType(RecordKeyPressed);
+    writeVarint(quint32(key));
+}
+
+//! Enregistre le relâchement d'une touche.
+//! \param key  Touche (voir les constantes Qt).
+void InputLog::writeKeyReleased(int key) {
+    if (!m_isRecording)
+        return;
+
+    writeType(RecordKeyReleased);
+    writeVarint(quint32(key));
+}
+
+//! Enregistre un déplacement de la souris.
+//! \param rPosition  Position de la souris, dans la scène.
+void InputLog::writeMouseMoved(const QPointF& rPosition) {
+    if (!m_isRecording)
+        return;
+
+    writePosition(RecordMouseMoved, rPosition);
+}
+
+//! Enregistre l'appui sur un bouton de la souris.
+//! \param rPosition  Position de la souris, dans la scène.
+//! \param buttons    Boutons de la souris pressés.
+void InputLog::writeMouseButtonPressed(const QPointF& rPosition, Qt::MouseButtons buttons) {
+    if (!m_isRecording)
+        return;
+
+    writePosition(RecordMouseButtonPressed, rPosition);
+    writeVarint(quint32(buttons));
+}
+
+//! Enregistre le relâchement d'un bouton de la souris.
+//! \param rPosition  Position de la souris, dans la scène.
+//! \param buttons    Boutons de la souris encore pressés.
+void InputLog::writeMouseButtonReleased(const QPointF& rPosition, Qt::MouseButtons buttons) {
+    if (!m_isRecording)
+        return;
+
+    writePosition(RecordMouseButtonReleased, rPosition);
+    writeVarint(quint32(buttons));
+}
+
+//! Enregistre un changement d'échelle du temps.
+//! \param timeScale  Nouvelle échelle du temps.
+void InputLog::writeTimeScale(double timeScale) {
+    if (!m_isRecording)
+        return;
+
+    writeType(RecordTimeScale);
+    writeDouble(timeScale);
+}
+
+//! Enregistre une empreinte de l'état du jeu, à comparer lors du rejeu.
+//! \param checksum  Empreinte de l'état du jeu après le tick qui vient d'être traité.
+void InputLog::writeChecksum(quint64 checksum) {
+    if (!m_isRecording)
+        return;
+
+    writeType(RecordChecksum);
+    writeVarint(checksum);
+}
+
+//! Lit l'enregistrement suivant du journal en cours de rejeu.
+//! \param rRecord  Reçoit l'enregistrement lu.
+//! \return faux à la fin du journal ou si l'enregistrement est invalide (voir errorString()).
+bool InputLog::read(Record& rRecord) {
+    if (!m_isReplaying || m_readPosition >= m_buffer.size())
+        return false;
+
+    const quint8 typeByte = quint8(m_buffer.at(m_readPosition++));
+    const bool isIntegerPosition = (typeByte & RECORD_INTEGER_POSITION) != 0;
+    const quint8 type = typeByte & ~RECORD_INTEGER_POSITION;
+    if (type >= RecordTypeCount)
+        return setError(QString("Type d'enregistrement inconnu : %1.").arg(type));
+
+    rRecord.type = RecordType(type);
+    quint64 value = 0;
+    bool success = true;
+    switch (rRecord.type) {
+    case RecordTick:
+        success = readVarint(value);
+        rRecord.elapsedTime = (long long)value;
+        m_tickCount++;
+        break;
+    case RecordKeyPressed:
+    case RecordKeyReleased:
+        success = readVarint(value);
+        rRecord.key = int(value);
+        break;
+    case RecordMouseMoved:
+        success = readPosition(isIntegerPosition, rRecord.position);
+        break;
+    case RecordMouseButtonPressed:
+    case RecordMouseButtonReleased:
+        success = readPosition(isIntegerPosition, rRecord.position) && readVarint(value);
+        rRecord.buttons = Qt::MouseButtons(int(value));
+        break;
+    case RecordTimeScale:
+        success = readDouble(rRecord.timeScale);
+        break;
+    case RecordChecksum:
+        success = readVarint(rRecord.checksum);
+        break;
+    default:
+        break;
+    }
+
+    if (!success)
+        return setError("Journal des entrées tronqué.");
+
+    return true;
+}
+
+//! Lit la graine d'un journal, sans le rejouer.
+//! \param rFileName  Nom du fichier du journal.
+//! \param rSeed      Reçoit la graine.
+//! \return faux si le fichier ne peut pas être lu ou n'est pas un journal.
+bool InputLog::readSeed(const QString& rFileName, quint64& rSeed) {
+    QFile file(rFileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+
+    const QByteArray header = file.read(LOG_HEADER_SIZE);
+    if (!isValidHeader(header))
+        return false;
+
+    quint64 littleEndianSeed;
+    std::memcpy(&littleEndianSeed, header.constData() + LOG_MAGIC.size() + 1, sizeof(littleEndianSeed));
+    rSeed = qFromLittleEndian(littleEndianSeed);
+    return true;
+}
+
+//! Ecrit l'octet de type d'un enregistrement.
+void InputLog::writeType(RecordType type, quint8 flags) {
+    m_buffer.append(char(quint8(type) | flags));
+}
+
+//! Ecrit un entier de longueur variable (7 bits par octet, le bit de poids fort
+//! indiquant qu'un octet suit).
+void InputLog::writeVarint(quint64 value) {
+    do {
+        quint8 byte = value & 0x7F;
+        value >>= 7;
+        if (value != 0)
+            byte |= 0x80;
+        m_buffer.append(char(byte));
+    } while (value != 0);
+}
+
+//! Ecrit un nombre en double précision (8 octets, petit boutiste).
+void InputLog::writeDouble(double value) {
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits = qToLittleEndian(bits);
+    m_buffer.append(reinterpret_cast<const char*>(&bits), sizeof(bits));
+}
+
+//! Ecrit l'octet de type d'un enregistrement, suivi d'une position de la souris.
+void InputLog::writePosition(RecordType type, const QPointF& rPosition) {
+    if (isIntegerCoordinate(rPosition.x()) && isIntegerCoordinate(rPosition.y())) {
+        writeType(type, RECORD_INTEGER_POSITION);
+        writeVarint(zigzagEncode(qint64(rPosition.x())));
+        writeVarint(zigzagEncode(qint64(rPosition.y())));
+    } else {
+        writeType(type);
+        writeDouble(rPosition.x());
+        writeDouble(rPosition.y());
+    }
+}
+
+//! Ecrit les enregistrements en attente dans le fichier.
+void InputLog::flush() {
+    if (m_buffer.isEmpty())
+        return;
+
+    m_file.write(m_buffer);
+    m_file.flush();
+    m_buffer.clear();
+}
+
+//! Lit un entier de longueur variable (voir writeVarint()).
+//! \return faux si la fin du journal est atteinte ou si l'entier est invalide.
+bool InputLog::readVarint(quint64& rValue) {
+    rValue = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        if (m_readPosition >= m_buffer.size())
+            return false;
+
+        const quint8 byte = quint8(m_buffer.at(m_readPosition++));
+        rValue |= quint64(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+//! Lit un nombre en double précision (voir writeDouble()).
+//! \return faux si la fin du journal est atteinte.
+bool InputLog::readDouble(double& rValue) {
+    quint64 bits;
+    if (m_readPosition + int(sizeof(bits)) > m_buffer.size())
+        return false;
+
+    std::memcpy(&bits, m_buffer.constData() + m_readPosition, sizeof(bits));
+    m_readPosition += sizeof(bits);
+    bits = qFromLittleEndian(bits);
+    std::memcpy(&rValue, &bits, sizeof(rValue));
+    return true;
+}
+
+//! Lit une position de la souris (voir writePosition()).
+//! \return faux si la fin du journal est atteinte.
+bool InputLog::readPosition(bool isInteger, QPointF& rPosition) {
+    if (isInteger) {
+        quint64 x, y;
+        if (!readVarint(x) || !readVarint(y))
+            return false;
+        rPosition = QPointF(zigzagDecode(x), zigzagDecode(y));
+        return true;
+    }
+
+    double x, y;
+    if (!readDouble(x) || !readDouble(y))
+        return false;
+    rPosition = QPointF(x, y);
+    return true;
+}
+
+//! Mémorise la description d'une erreur.
+//! \return toujours faux, afin de pouvoir écrire `return setError(...)`.
+bool InputLog::setError(const QString& rErrorString) {
+    m_errorString = rErrorString;
+    return false;
+}
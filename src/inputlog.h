@@ -0,0 +1,115 @@
+/**
+  \file
+  \brief    Déclaration de la classe InputLog.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef INPUTLOG_H
+#define INPUTLOG_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QPointF>
+#include <QString>
+
+//! \brief Classe qui enregistre et relit un journal des entrées transmises à GameCore.
+//!
+//! Le journal permet de rejouer exactement une session de jeu (option `--replay`) : il
+//! contient la graine du jeu, dont dépendent les niveaux (voir GameCore::createBricks()),
+//! puis, dans l'ordre où GameCanvas les a traités, les entrées transmises à GameCore
+//! (touches, déplacements et boutons de la souris), les changements d'échelle du temps
+//! demandés par le joueur et un enregistrement par tick, qui contient le temps écoulé
+//! transmis à ce tick. Le numéro d'un tick est le nombre d'enregistrements de tick qui le
+//! précèdent.
+//!
+//! Des empreintes de l'état du jeu (voir GameCore::stateChecksum()) sont enregistrées
+//! régulièrement, après le traitement d'un tick : le rejeu les compare à l'état rejoué et
+//! signale les divergences.
+//!
+//! Format binaire : la signature `BBIR`, un octet de version, la graine (8 octets, petit
+//! boutiste), puis les enregistrements. Un enregistrement commence par un octet de type
+//! (RecordType), suivi de ses valeurs. Les nombres sont codés en entiers de longueur
+//! variable (7 bits par octet), comme les niveaux binaires (voir LevelReader). Les
+//! positions de la souris entières, les plus fréquentes, sont codées de la même façon
+//! (bit RECORD_INTEGER_POSITION de l'octet de type) ; les autres sont codées en double
+//! précision, afin que le rejeu soit exact.
+//!
+//! Le journal est écrit avec create() et les méthodes write...(), qui ne font rien si
+//! aucun journal n'est en cours d'écriture. Il est relu avec open() et read().
+class InputLog
+{
+public:
+    //! Types d'enregistrements.
+    enum RecordType {
+        RecordTick,                 //!< Tick traité : elapsedTime.
+        RecordKeyPressed,           //!< Touche pressée : key.
+        RecordKeyReleased,          //!< Touche relâchée : key.
+        RecordMouseMoved,           //!< Souris déplacée : position.
+        RecordMouseButtonPressed,   //!< Bouton de la souris pressé : position, buttons.
+        RecordMouseButtonReleased,  //!< Bouton de la souris relâché : position, buttons.
+        RecordTimeScale,            //!< Echelle du temps changée : timeScale.
+        RecordChecksum,             //!< Empreinte de l'état du jeu après le tick précédent : checksum.
+        RecordTypeCount
+    };
+
+    //! Enregistrement lu. Seules les valeurs de son type sont significatives.
+    struct Record
+    {
+        RecordType type = RecordTick;
+        long long elapsedTime = 0;  //!< Temps écoulé transmis au tick, en ms.
+        int key = 0;                //!< Touche (voir les constantes Qt).
+        QPointF position;           //!< Position de la souris, dans la scène.
+        Qt::MouseButtons buttons;   //!< Boutons de la souris.
+        double timeScale = 1.0;     //!< Echelle du temps.
+        quint64 checksum = 0;       //!< Empreinte de l'état du jeu.
+    };
+
+    InputLog();
+    ~InputLog();
+
+    bool create(const QString& rFileName, quint64 seed);
+    bool open(const QString& rFileName);
+    void close();
+
+    bool isRecording() const;
+    bool isReplaying() const;
+    quint64 seed() const;
+    long long tickCount() const;
+    QString errorString() const;
+
+    void writeTick(long long elapsedTime);
+    void writeKeyPressed(int key);
+    void writeKeyReleased(int key);
+    void writeMouseMoved(const QPointF& rPosition);
+    void writeMouseButtonPressed(const QPointF& rPosition, Qt::MouseButtons buttons);
+    void writeMouseButtonReleased(const QPointF& rPosition, Qt::MouseButtons buttons);
+    void writeTimeScale(double timeScale);
+    void writeChecksum(quint64 checksum);
+
+    bool read(Record& rRecord);
+
+    static bool readSeed(const QString& rFileName, quint64& rSeed);
+
+private:
+    void writeType(RecordType type, quint8 flags = 0);
+    void writeVarint(quint64 value);
+    void writeDouble(double value);
+    void writePosition(RecordType type, const QPointF& rPosition);
+    void flush();
+
+    bool readVarint(quint64& rValue);
+    bool readDouble(double& rValue);
+    bool readPosition(bool isInteger, QPointF& rPosition);
+    bool setError(const QString& rErrorString);
+
+    QFile m_file;
+    QByteArray m_buffer;        // Enregistrements du tick à écrire, ou journal entier en rejeu.
+    int m_readPosition;
+    bool m_isRecording;
+    bool m_isReplaying;
+    quint64 m_seed;
+    long long m_tickCount;      // Nombre de ticks écrits ou lus.
+    QString m_errorString;
+};
+
+#endif // INPUTLOG_H
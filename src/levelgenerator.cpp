@@ -0,0 +1,78 @@
+/**
+  \file
+  \brief    Définition de la classe LevelGenerator.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "levelgenerator.h"
+
+//! Construit un générateur de niveau.
+//! \param rParameters  Paramètres du niveau.
+//! \param seed         Graine du générateur pseudo-aléatoire.
+LevelGenerator::LevelGenerator(const Parameters& rParameters, quint64 seed) {
+    m_parameters = rParameters;
+    m_parameters.columnCount = qMax(0, m_parameters.columnCount);
+    m_parameters.rowCount = qMax(0, m_parameters.rowCount);
+    m_parameters.maxHitPoints = qMax(1, m_parameters.maxHitPoints);
+    m_seed = seed;
+    m_brickCount = 0;
+}
+
+//! Génère le niveau et transmet ses briques au gestionnaire donné.
+//! Les cases consécutives identiques (type et points de vie) sont regroupées en
+//! une seule séquence.
+//! \param pHandler  Gestionnaire qui reçoit les briques.
+void LevelGenerator::generate(LevelReader::Handler* pHandler) {
+    // Le générateur est réinitialisé à chaque génération : le niveau ne dépend que
+    // de la graine et des paramètres.
+    RandomGenerator random(m_seed);
+    m_brickCount = 0;
+
+    pHandler->beginLevel(m_parameters.columnCount, m_parameters.rowCount);
+
+    for (int row = 0; row < m_parameters.rowCount; ++row) {
+        int runColumn = 0;
+        int runCount = 0;
+        LevelReader::BrickType runType = LevelReader::BrickNone;
+        int runHitPoints = 0;
+
+        for (int column = 0; column <= m_parameters.columnCount; ++column) {
+            LevelReader::BrickType type = LevelReader::BrickNone;
+            int hitPoints = 0;
+
+            if (column < m_parameters.columnCount && random.uniform() < m_parameters.density) {
+                if (random.uniform() < m_parameters.unbreakableRatio) {
+                    type = LevelReader::BrickGray;
+                    hitPoints = 1;
+                } else {
+                    // Toutes les couleurs sauf le gris, réservé aux briques incassables.
+                    int colorIndex = int(random.bounded(LevelReader::BrickColorCount - 1));
+                    type = LevelReader::BrickType(LevelReader::BrickBlue + colorIndex);
+                    if (type >= LevelReader::BrickGray)
+                        type = LevelReader::BrickType(type + 1);
+                    hitPoints = 1 + int(random.bounded(quint32(m_parameters.maxHitPoints)));
+                }
+            }
+
+            // La séquence en cours se termine : elle est transmise.
+            if (column == m_parameters.columnCount || type != runType || hitPoints != runHitPoints) {
+                if (runType != LevelReader::BrickNone && runCount > 0) {
+                    pHandler->addBricks(row, runColumn, runType, runCount, runHitPoints);
+                    m_brickCount += runCount;
+                }
+                runColumn = column;
+                runCount = 0;
+                runType = type;
+                runHitPoints = hitPoints;
+            }
+            runCount++;
+        }
+    }
+
+    pHandler->endLevel();
+}
+
+//! \return le nombre de briques générées par le dernier appel à generate().
+int LevelGenerator::brickCount() const {
+    return m_brickCount;
+}
@@ -0,0 +1,46 @@
+/**
+  \file
+  \brief    Déclaration de la classe LevelGenerator.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef LEVELGENERATOR_H
+#define LEVELGENERATOR_H
+
+#include "levelreader.h"
+#include "randomgenerator.h"
+
+//! \brief Classe qui génère un niveau de façon procédurale.
+//!
+//! Le niveau est déterminé par ses paramètres (LevelGenerator::Parameters) et par une
+//! graine : pour une même graine et les mêmes paramètres, le niveau généré est toujours
+//! identique. Cela permet de produire des niveaux de test reproductibles, de n'importe
+//! quelle taille.
+//!
+//! Comme LevelReader, le générateur transmet les briques au fur et à mesure, par
+//! séquences, à un LevelReader::Handler : aucune grille n'est construite en mémoire.
+class LevelGenerator
+{
+public:
+    //! Paramètres d'un niveau généré.
+    struct Parameters
+    {
+        int columnCount = 12;           //!< Nombre de colonnes.
+        int rowCount = 3;               //!< Nombre de rangées.
+        double density = 1.0;           //!< Proportion de cases occupées par une brique (0 à 1).
+        double unbreakableRatio = 0.125; //!< Proportion de briques incassables (0 à 1).
+        int maxHitPoints = 1;           //!< Points de vie maximum d'une brique cassable (1 ou plus).
+    };
+
+    LevelGenerator(const Parameters& rParameters, quint64 seed);
+
+    void generate(LevelReader::Handler* pHandler);
+    int brickCount() const;
+
+private:
+    Parameters m_parameters;
+    quint64 m_seed;
+    int m_brickCount;
+};
+
+#endif // LEVELGENERATOR_H
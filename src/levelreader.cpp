@@ -0,0 +1,362 @@
+/**
+  \file
+  \brief    Définition de la classe LevelReader.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "levelreader.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+
+const char LevelReader::BINARY_SUFFIX[] = "bbl";
+
+//! Signature placée au début d'un niveau binaire.
+const QByteArray BINARY_MAGIC("BBLV");
+//! Version du format binaire.
+const char BINARY_VERSION = 1;
+//! Octet qui termine une rangée dans le format binaire.
+const quint8 BINARY_END_OF_ROW = 0xFF;
+//! Taille des blocs lus dans le fichier.
+const int READ_CHUNK_SIZE = 64 * 1024;
+//! Nombre maximal de colonnes ou de rangées d'un niveau.
+const int MAX_LEVEL_SIZE = 10000000;
+
+//! \return le type de case correspondant au caractère donné (format texte), ou
+//! BrickTypeCount si le caractère n'est pas reconnu.
+static LevelReader::BrickType brickTypeFromChar(char character) {
+    switch (character) {
+    case '.': return LevelReader::BrickNone;
+    case 'b': return LevelReader::BrickBlue;
+    case 'c': return LevelReader::BrickCyan;
+    case 'x': return LevelReader::BrickGray;
+    case 'g': return LevelReader::BrickGreen;
+    case 'o': return LevelReader::BrickOrange;
+    case 'p': return LevelReader::BrickPink;
+    case 'r': return LevelReader::BrickRed;
+    case 'y': return LevelReader::BrickYellow;
+    case '?': return LevelReader::BrickRandom;
+    default:  return LevelReader::BrickTypeCount;
+    }
+}
+
+//! Ecrit un entier de longueur variable (7 bits par octet, le bit de poids fort
+//! indiquant qu'un octet suit).
+static void writeVarint(QIODevice* pDevice, quint32 value) {
+    char bytes[5];
+    int byteCount = 0;
+    do {
+        quint8 byte = value & 0x7F;
+        value >>= 7;
+        if (value != 0)
+            byte |= 0x80;
+        bytes[byteCount++] = char(byte);
+    } while (value != 0);
+    pDevice->write(bytes, byteCount);
+}
+
+//! \brief Gestionnaire qui écrit les briques reçues au format binaire.
+//! Utilisé par LevelReader::convertToBinary().
+class BinaryLevelWriter : public LevelReader::Handler
+{
+public:
+    explicit BinaryLevelWriter(QIODevice* pDevice) : m_pDevice(pDevice), m_rowCount(0), m_row(0), m_column(0) { }
+
+    void beginLevel(int columnCount, int rowCount) {
+        m_pDevice->write(BINARY_MAGIC);
+        m_pDevice->write(&BINARY_VERSION, 1);
+        writeVarint(m_pDevice, quint32(columnCount));
+        writeVarint(m_pDevice, quint32(rowCount));
+        m_rowCount = rowCount;
+    }
+
+    void addBricks(int row, int column, LevelReader::BrickType type, int count, int hitPoints) {
+        // Le format binaire ne mémorise pas les points de vie.
+        Q_UNUSED(hitPoints)
+
+        while (m_row < row)
+            endRow();
+
+        if (column > m_column)
+            writeRun(LevelReader::BrickNone, column - m_column);
+        writeRun(type, count);
+        m_column = column + count;
+    }
+
+    void endLevel() {
+        while (m_row < m_rowCount)
+            endRow();
+    }
+
+private:
+    void writeRun(LevelReader::BrickType type, int count) {
+        char typeByte = char(type);
+        m_pDevice->write(&typeByte, 1);
+        writeVarint(m_pDevice, quint32(count));
+    }
+
+    void endRow() {
+        char endOfRow = char(BINARY_END_OF_ROW);
+        m_pDevice->write(&endOfRow, 1);
+        m_row++;
+        m_column = 0;
+    }
+
+    QIODevice* m_pDevice;
+    int m_rowCount;
+    int m_row;
+    int m_column;
+};
+
+//! Construit un lecteur de niveau.
+//! \param pHandler  Gestionnaire qui recevra les briques lues.
+LevelReader::LevelReader(Handler* pHandler) {
+    m_pHandler = pHandler;
+    m_pDevice = nullptr;
+    m_bufferSize = 0;
+    m_bufferPosition = 0;
+    m_brickCount = 0;
+}
+
+//! Lit le niveau contenu dans le fichier donné.
+//! \param rFileName  Chemin du fichier de niveau.
+//! \return vrai si le niveau a pu être lu. Sinon, errorString() décrit l'erreur.
+bool LevelReader::read(const QString& rFileName) {
+    QFile file(rFileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return setError(QString("Impossible d'ouvrir le niveau %1 : %2").arg(rFileName, file.errorString()));
+
+    return read(&file);
+}
+
+//! Lit le niveau fourni par le périphérique donné, qui doit être ouvert en lecture.
+//! Les niveaux texte sont parcourus deux fois (dimensions, puis briques) : le
+//! périphérique doit alors permettre de revenir en arrière (fichier ou QBuffer).
+//! \param pDevice  Périphérique à lire.
+//! \return vrai si le niveau a pu être lu. Sinon, errorString() décrit l'erreur.
+bool LevelReader::read(QIODevice* pDevice) {
+    m_pDevice = pDevice;
+    m_buffer.resize(READ_CHUNK_SIZE);
+    m_bufferSize = 0;
+    m_bufferPosition = 0;
+    m_brickCount = 0;
+    m_errorString.clear();
+
+    bool success = (pDevice->peek(BINARY_MAGIC.size()) == BINARY_MAGIC) ? readBinary() : readText();
+
+    m_pDevice = nullptr;
+    m_buffer.clear();
+    return success;
+}
+
+//! \return la description de la dernière erreur de lecture.
+QString LevelReader::errorString() const {
+    return m_errorString;
+}
+
+//! \return le nombre de briques lues (cases vides exclues).
+int LevelReader::brickCount() const {
+    return m_brickCount;
+}
+
+//! Convertit un niveau (en principe texte) au format binaire.
+//! \param rTextFileName    Chemin du niveau à convertir.
+//! \param rBinaryFileName  Chemin du niveau binaire à écrire.
+//! \return vrai si la conversion a réussi.
+bool LevelReader::convertToBinary(const QString& rTextFileName, const QString& rBinaryFileName) {
+    QSaveFile binaryFile(rBinaryFileName);
+    if (!binaryFile.open(QIODevice::WriteOnly)) {
+        qWarning() << "Impossible d'écrire le niveau" << rBinaryFileName << ":" << binaryFile.errorString();
+        return false;
+    }
+
+    BinaryLevelWriter writer(&binaryFile);
+    LevelReader reader(&writer);
+    if (!reader.read(rTextFileName)) {
+        qWarning() << reader.errorString();
+        binaryFile.cancelWriting();
+        return false;
+    }
+
+    if (!binaryFile.commit()) {
+        qWarning() << "Impossible d'écrire le niveau" << rBinaryFileName << ":" << binaryFile.errorString();
+        return false;
+    }
+
+    qDebug() << reader.brickCount() << "briques écrites dans le niveau" << rBinaryFileName;
+    return true;
+}
+
+//! Lit un niveau au format binaire.
+bool LevelReader::readBinary() {
+    char byte;
+    for (int i = 0; i < BINARY_MAGIC.size(); ++i)
+        nextByte(byte);
+
+    if (!nextByte(byte) || byte != BINARY_VERSION)
+        return setError("Version de niveau binaire non supportée");
+
+    quint32 columnCount, rowCount;
+    if (!readVarint(columnCount) || !readVarint(rowCount) || columnCount > quint32(MAX_LEVEL_SIZE) || rowCount > quint32(MAX_LEVEL_SIZE))
+        return setError("En-tête de niveau binaire invalide");
+
+    m_pHandler->beginLevel(int(columnCount), int(rowCount));
+
+    for (int row = 0; row < int(rowCount); ++row) {
+        quint32 column = 0;
+        forever {
+            if (!nextByte(byte))
+                return setError(QString("Fin de fichier inattendue à la rangée %1").arg(row));
+            if (quint8(byte) == BINARY_END_OF_ROW)
+                break;
+
+            quint32 count;
+            if (quint8(byte) >= BrickTypeCount || !readVarint(count) || count > columnCount - column)
+                return setError(QString("Séquence invalide à la rangée %1").arg(row));
+
+            if (byte != BrickNone && count > 0) {
+                m_pHandler->addBricks(row, int(column), BrickType(byte), int(count), 1);
+                m_brickCount += int(count);
+            }
+            column += count;
+        }
+    }
+
+    m_pHandler->endLevel();
+    return true;
+}
+
+//! Lit un niveau au format texte : un premier parcours détermine les dimensions du
+//! niveau, un second transmet les briques.
+bool LevelReader::readText() {
+    if (m_pDevice->isSequential())
+        return setError("Un niveau texte doit être lu depuis un fichier");
+
+    qint64 startPosition = m_pDevice->pos();
+    int columnCount = 0;
+    int rowCount = 0;
+    if (!parseText(false, columnCount, rowCount))
+        return false;
+
+    m_pDevice->seek(startPosition);
+    m_bufferSize = 0;
+    m_bufferPosition = 0;
+
+    m_pHandler->beginLevel(columnCount, rowCount);
+    if (!parseText(true, columnCount, rowCount))
+        return false;
+
+    m_pHandler->endLevel();
+    return true;
+}
+
+//! Parcourt un niveau au format texte.
+//! \param emitBricks     Si vrai, les briques sont transmises au gestionnaire.
+//! \param rColumnCount   Reçoit le nombre de colonnes du niveau.
+//! \param rRowCount      Reçoit le nombre de rangées du niveau.
+//! \return vrai si le niveau est valide.
+bool LevelReader::parseText(bool emitBricks, int& rColumnCount, int& rRowCount) {
+    int line = 1;
+    int row = 0;
+    int column = 0;
+    int repeatCount = 0;
+    bool isComment = false;
+    bool rowHasCells = false;
+    rColumnCount = 0;
+
+    char character;
+    bool endOfFile = false;
+    while (!endOfFile) {
+        endOfFile = !nextByte(character);
+        if (endOfFile)
+            character = '\n';
+
+        if (character == '\n') {
+            if (repeatCount != 0)
+                return setError(QString("Nombre sans type de case à la ligne %1").arg(line));
+            if (rowHasCells)
+                row++;
+            rColumnCount = qMax(rColumnCount, column);
+            column = 0;
+            isComment = false;
+            rowHasCells = false;
+            line++;
+            continue;
+        }
+
+        if (isComment || character == ' ' || character == '\t' || character == '\r')
+            continue;
+
+        if (character == '#') {
+            isComment = true;
+            continue;
+        }
+
+        if (character >= '0' && character <= '9') {
+            repeatCount = repeatCount * 10 + (character - '0');
+            if (repeatCount > MAX_LEVEL_SIZE)
+                return setError(QString("Nombre trop grand à la ligne %1").arg(line));
+            continue;
+        }
+
+        BrickType type = brickTypeFromChar(character);
+        if (type == BrickTypeCount)
+            return setError(QString("Caractère '%1' inconnu à la ligne %2").arg(QChar(character)).arg(line));
+
+        int count = (repeatCount != 0) ? repeatCount : 1;
+        if (count > MAX_LEVEL_SIZE - column || row >= MAX_LEVEL_SIZE)
+            return setError(QString("Niveau trop grand à la ligne %1").arg(line));
+
+        if (emitBricks && type != BrickNone) {
+            m_pHandler->addBricks(row, column, type, count, 1);
+            m_brickCount += count;
+        }
+        column += count;
+        repeatCount = 0;
+        rowHasCells = true;
+    }
+
+    rRowCount = row;
+    return true;
+}
+
+//! Lit l'octet suivant, en remplissant le tampon de lecture au besoin.
+//! \param rByte  Reçoit l'octet lu.
+//! \return faux si la fin du fichier est atteinte.
+bool LevelReader::nextByte(char& rByte) {
+    if (m_bufferPosition >= m_bufferSize) {
+        qint64 readSize = m_pDevice->read(m_buffer.data(), m_buffer.size());
+        if (readSize <= 0)
+            return false;
+        m_bufferSize = int(readSize);
+        m_bufferPosition = 0;
+    }
+
+    rByte = m_buffer.at(m_bufferPosition++);
+    return true;
+}
+
+//! Lit un entier de longueur variable (voir writeVarint()).
+//! \param rValue  Reçoit l'entier lu.
+//! \return faux si la fin du fichier est atteinte ou si l'entier est invalide.
+bool LevelReader::readVarint(quint32& rValue) {
+    rValue = 0;
+    for (int shift = 0; shift < 32; shift += 7) {
+        char byte;
+        if (!nextByte(byte))
+            return false;
+
+        rValue |= quint32(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+//! Mémorise la description d'une erreur de lecture.
+//! \return toujours faux, afin de pouvoir écrire `return setError(...)`.
+bool LevelReader::setError(const QString& rErrorString) {
+    m_errorString = rErrorString;
+    return false;
+}
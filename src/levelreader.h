@@ -0,0 +1,113 @@
+/**
+  \file
+  \brief    Déclaration de la classe LevelReader.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef LEVELREADER_H
+#define LEVELREADER_H
+
+#include <QByteArray>
+#include <QString>
+
+class QIODevice;
+
+//! \brief Classe qui lit un fichier de niveau (disposition des briques).
+//!
+//! Un niveau est une grille de briques, décrite ligne par ligne par des séquences
+//! (run-length encoding) : une séquence est un nombre de cases consécutives d'un même type.
+//!
+//! Deux formats sont reconnus :
+//!
+//! - Le format texte (extension `.txt`), éditable à la main. Chaque ligne du fichier
+//!   correspond à une rangée de briques, chaque caractère à une case :
+//!   `.` case vide, `b` bleue, `c` cyan, `x` grise (incassable), `g` verte, `o` orange,
+//!   `p` rose, `r` rouge, `y` jaune et `?` couleur aléatoire. Un nombre devant un
+//!   caractère le répète (`12r` : douze briques rouges). Le texte qui suit `#` est un
+//!   commentaire, les espaces et les lignes vides sont ignorés.
+//!
+//! - Le format binaire (extension `.bbl`), compact. Il commence par la signature `BBLV`,
+//!   un octet de version, puis le nombre de colonnes et de rangées. Chaque rangée est une
+//!   suite de séquences (un octet de type, suivi du nombre de cases) terminée par l'octet
+//!   0xFF. Les nombres sont codés en entiers de longueur variable (7 bits par octet).
+//!   Un niveau texte peut être converti au format binaire avec convertToBinary().
+//!
+//! La lecture se fait en continu, par blocs, sans construire la grille en mémoire ni
+//! créer d'objet temporaire par brique : chaque séquence de briques lue est directement
+//! transmise au gestionnaire (LevelReader::Handler) donné à la construction, qui les
+//! range là où il le souhaite (par exemple dans une scène). Des niveaux de plusieurs
+//! centaines de milliers de briques peuvent ainsi être lus rapidement.
+//!
+//! Le format est reconnu d'après la signature du fichier, et non d'après son extension.
+class LevelReader
+{
+public:
+    //! Types de cases. L'ordre des couleurs est celui de GameCore::m_pBrickColors.
+    enum BrickType {
+        BrickNone,
+        BrickBlue,
+        BrickCyan,
+        BrickGray,
+        BrickGreen,
+        BrickOrange,
+        BrickPink,
+        BrickRed,
+        BrickYellow,
+        BrickRandom,
+        BrickTypeCount
+    };
+
+    //! Nombre de couleurs de briques (types BrickBlue à BrickYellow).
+    enum { BrickColorCount = BrickYellow };
+
+    //! Extension des niveaux au format binaire.
+    static const char BINARY_SUFFIX[];
+
+    //! \brief Gestionnaire qui reçoit les briques lues.
+    class Handler
+    {
+    public:
+        virtual ~Handler() { }
+
+        //! Appelée avant toute brique, avec les dimensions du niveau (en cases).
+        virtual void beginLevel(int columnCount, int rowCount) = 0;
+
+        //! Appelée pour chaque séquence de briques : count briques du type donné, ayant
+        //! chacune hitPoints points de vie, à partir de la case (row, column).
+        //! Les cases vides ne sont pas transmises. Les niveaux lus depuis un fichier
+        //! n'ont que des briques à un point de vie (voir LevelGenerator).
+        virtual void addBricks(int row, int column, BrickType type, int count, int hitPoints) = 0;
+
+        //! Appelée une fois toutes les briques lues.
+        virtual void endLevel() { }
+    };
+
+    explicit LevelReader(Handler* pHandler);
+
+    bool read(const QString& rFileName);
+    bool read(QIODevice* pDevice);
+
+    QString errorString() const;
+    int brickCount() const;
+
+    static bool convertToBinary(const QString& rTextFileName, const QString& rBinaryFileName);
+
+private:
+    bool readBinary();
+    bool readText();
+    bool parseText(bool emitBricks, int& rColumnCount, int& rRowCount);
+
+    bool nextByte(char& rByte);
+    bool readVarint(quint32& rValue);
+    bool setError(const QString& rErrorString);
+
+    Handler* m_pHandler;
+    QIODevice* m_pDevice;
+    QByteArray m_buffer;
+    int m_bufferSize;
+    int m_bufferPosition;
+    int m_brickCount;
+    QString m_errorString;
+};
+
+#endif // LEVELREADER_H
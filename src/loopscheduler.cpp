@@ -0,0 +1,213 @@
+/**
+  \file
+  \brief    Définition de la classe LoopScheduler.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "loopscheduler.h"
+
+#include <algorithm>
+
+#include <QtGlobal>
+
+// Initialisation des constantes.
+const qint64 NS_PER_MS = 1000000;
+const qint64 TIMER_TOLERANCE_NS = 500000;    // Avance tolérée au réveil en mode ModeTimer.
+const qint64 BUSY_SLACK_NS = 2 * NS_PER_MS;  // Avance du réveil sur l'échéance en mode ModeBusy.
+const qint64 METRICS_WINDOW_NS = 1000 * NS_PER_MS;
+const int JITTER_SAMPLE_COUNT = 256;
+const double LOAD_SMOOTHING = 0.1;           // Poids d'une nouvelle mesure dans la charge moyenne.
+const double BUSY_LOAD_THRESHOLD = 0.5;      // Charge au-delà de laquelle le mode ModeBusy est choisi...
+const double TIMER_LOAD_THRESHOLD = 0.3;     // ... et en deçà de laquelle le mode ModeTimer est rétabli.
+
+//! Construit un ordonnanceur arrêté, d'intervalle 10 ms, en mode ModeAuto.
+//! \param pParent  Objet parent.
+LoopScheduler::LoopScheduler(QObject* pParent) : QObject(pParent) {
+    m_active = false;
+    m_intervalNs = 10 * NS_PER_MS;
+    m_nextDeadlineNs = 0;
+    m_mode = ModeAuto;
+    m_activeMode = ModeTimer;
+
+    m_jitterSamples.resize(JITTER_SAMPLE_COUNT);
+    m_jitterSampleIndex = 0;
+    m_jitterSampleCount = 0;
+
+    m_windowStartNs = 0;
+    m_windowTickCount = 0;
+    m_achievedRate = 0;
+    m_jitterP99 = 0;
+    m_load = 0;
+    m_missedTickCount = 0;
+
+    m_timer.setSingleShot(true);
+    m_timer.setTimerType(Qt::PreciseTimer); // Important pour avoir un précision suffisante sous Windows
+    connect(&m_timer, &QTimer::timeout, this, &LoopScheduler::onTimeout);
+
+    m_clock.start();
+}
+
+//! Change l'intervalle entre deux ticks. Prend effet dès l'échéance suivante.
+//! \param intervalInMilliseconds  Intervalle, en millisecondes (au moins 1).
+void LoopScheduler::setInterval(int intervalInMilliseconds) {
+    m_intervalNs = qMax(1, intervalInMilliseconds) * NS_PER_MS;
+}
+
+//! \return l'intervalle entre deux ticks, en millisecondes.
+int LoopScheduler::interval() const {
+    return int(m_intervalNs / NS_PER_MS);
+}
+
+//! Change la façon d'attendre l'échéance.
+//! \param mode  ModeTimer ou ModeBusy impose le mode, ModeAuto le choisit selon la charge.
+void LoopScheduler::setMode(Mode mode) {
+    m_mode = mode;
+    m_activeMode = (mode == ModeAuto) ? ModeTimer : mode;
+}
+
+//! \return le mode demandé.
+LoopScheduler::Mode LoopScheduler::mode() const {
+    return m_mode;
+}
+
+//! \return le mode utilisé actuellement (ModeTimer ou ModeBusy).
+LoopScheduler::Mode LoopScheduler::activeMode() const {
+    return m_activeMode;
+}
+
+//! Démarre la cadence : le premier tick a lieu après un intervalle.
+//! Les mesures sont remises à zéro.
+void LoopScheduler::start() {
+    const qint64 now = m_clock.nsecsElapsed();
+    m_active = true;
+    m_nextDeadlineNs = now + m_intervalNs;
+
+    m_jitterSampleIndex = 0;
+    m_jitterSampleCount = 0;
+    m_windowStartNs = now;
+    m_windowTickCount = 0;
+
+    scheduleWakeUp(now);
+}
+
+//! Arrête la cadence. Peut être appelée durant le traitement d'un tick.
+void LoopScheduler::stop() {
+    m_active = false;
+    m_timer.stop();
+}
+
+//! \return vrai si la cadence est démarrée.
+bool LoopScheduler::isActive() const {
+    return m_active;
+}
+
+//! \return la fréquence obtenue (en Hz) durant la dernière seconde écoulée.
+double LoopScheduler::achievedRate() const {
+    return m_achievedRate;
+}
+
+//! \return le 99e centile de la gigue de réveil (en ms) des derniers ticks.
+double LoopScheduler::jitterP99() const {
+    return m_jitterP99;
+}
+
+//! \return la charge moyenne : part de l'intervalle occupée par le traitement d'un tick.
+double LoopScheduler::load() const {
+    return m_load;
+}
+
+//! \return le nombre d'échéances manquées depuis la création de l'ordonnanceur.
+long long LoopScheduler::missedTickCount() const {
+    return m_missedTickCount;
+}
+
+//! \return le nom du mode donné, pour l'affichage.
+QString LoopScheduler::modeName(Mode mode) {
+    switch (mode) {
+    case ModeTimer: return "timer";
+    case ModeBusy:  return "busy";
+    default:        return "auto";
+    }
+}
+
+//! Réveil : si l'échéance n'est pas encore atteinte, l'attente reprend. Sinon, le tick
+//! est émis et l'échéance suivante est calculée à partir de l'échéance atteinte.
+void LoopScheduler::onTimeout() {
+    if (!m_active)
+        return;
+
+    const qint64 now = m_clock.nsecsElapsed();
+    const qint64 tolerance = (m_activeMode == ModeTimer) ? TIMER_TOLERANCE_NS : 0;
+    if (m_nextDeadlineNs - now > tolerance) {
+        scheduleWakeUp(now);
+        return;
+    }
+
+    m_jitterSamples[m_jitterSampleIndex] = qAbs(now - m_nextDeadlineNs);
+    m_jitterSampleIndex = (m_jitterSampleIndex + 1) % JITTER_SAMPLE_COUNT;
+    m_jitterSampleCount = qMin(m_jitterSampleCount + 1, JITTER_SAMPLE_COUNT);
+
+    emit tick();
+
+    const qint64 tickEnd = m_clock.nsecsElapsed();
+    m_load += LOAD_SMOOTHING * (double(tickEnd - now) / m_intervalNs - m_load);
+
+    // Echéance suivante. Les échéances déjà dépassées sont abandonnées.
+    m_nextDeadlineNs += m_intervalNs;
+    if (m_nextDeadlineNs <= tickEnd) {
+        const qint64 missed = (tickEnd - m_nextDeadlineNs) / m_intervalNs + 1;
+        m_missedTickCount += missed;
+        m_nextDeadlineNs += missed * m_intervalNs;
+    }
+
+    m_windowTickCount++;
+    if (tickEnd - m_windowStartNs >= METRICS_WINDOW_NS)
+        updateMetrics(tickEnd);
+
+    // Le tick a pu arrêter la cadence.
+    if (m_active)
+        scheduleWakeUp(tickEnd);
+}
+
+//! Programme le prochain réveil selon le mode actif.
+//! \param now  Heure actuelle de l'horloge interne (ns).
+void LoopScheduler::scheduleWakeUp(qint64 now) {
+    qint64 wait = m_nextDeadlineNs - now;
+    if (m_activeMode == ModeBusy)
+        wait -= BUSY_SLACK_NS;
+
+    // Un intervalle nul laisse la boucle d'événements traiter les événements en attente
+    // avant de vérifier à nouveau l'échéance.
+    m_timer.start(int(qMax<qint64>(0, wait / NS_PER_MS)));
+}
+
+//! Calcule les mesures de la fenêtre écoulée et en commence une nouvelle.
+//! \param now  Heure actuelle de l'horloge interne (ns).
+void LoopScheduler::updateMetrics(qint64 now) {
+    m_achievedRate = m_windowTickCount * double(METRICS_WINDOW_NS) / (now - m_windowStartNs);
+    m_windowStartNs = now;
+    m_windowTickCount = 0;
+
+    if (m_jitterSampleCount > 0) {
+        QVector<qint64> samples = m_jitterSamples.mid(0, m_jitterSampleCount);
+        const int p99Index = (samples.count() * 99) / 100;
+        std::nth_element(samples.begin(), samples.begin() + p99Index, samples.end());
+        m_jitterP99 = double(samples[p99Index]) / NS_PER_MS;
+    }
+
+    updateActiveMode();
+}
+
+//! En mode ModeAuto, choisit le mode actif d'après la charge mesurée.
+//! Les seuils de charge sont distincts pour éviter d'osciller entre les deux modes.
+void LoopScheduler::updateActiveMode() {
+    if (m_mode != ModeAuto)
+        return;
+
+    if (m_activeMode == ModeTimer) {
+        if (m_load > BUSY_LOAD_THRESHOLD)
+            m_activeMode = ModeBusy;
+    } else if (m_load < TIMER_LOAD_THRESHOLD) {
+        m_activeMode = ModeTimer;
+    }
+}
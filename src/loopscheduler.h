@@ -0,0 +1,101 @@
+/**
+  \file
+  \brief    Déclaration de la classe LoopScheduler.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef LOOPSCHEDULER_H
+#define LOOPSCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+#include <QVector>
+
+//! \brief Classe qui génère la cadence du jeu (le tick) à intervalle régulier.
+//!
+//! Les échéances sont absolues : l'échéance suivante est l'échéance précédente plus
+//! l'intervalle, et non l'heure de fin du traitement plus l'intervalle. Le temps de
+//! traitement d'un tick ne s'ajoute donc pas à la période et la fréquence ne dérive pas.
+//! Si le traitement a pris plus d'une période, les échéances manquées sont abandonnées
+//! (et comptées, voir missedTickCount()) plutôt que rattrapées en rafale.
+//!
+//! Deux façons d'attendre l'échéance sont disponibles (voir Mode) :
+//! - ModeTimer : un QTimer précis réveille la boucle à l'échéance. Economique, mais le
+//!   réveil peut être en retard d'une à plusieurs millisecondes selon le système.
+//! - ModeBusy : le QTimer réveille la boucle un peu avant l'échéance, puis l'échéance
+//!   est guettée avec un QTimer d'intervalle nul. La boucle d'événements continue donc
+//!   de traiter les événements (clavier, souris, affichage) durant l'attente.
+//!
+//! En mode ModeAuto (par défaut), le mode est choisi une fois par seconde d'après la
+//! charge (part de la période occupée par le traitement du tick) :
+//! lorsque la charge est élevée, il reste peu de temps d'attente et un réveil en retard
+//! ferait manquer l'échéance, le mode ModeBusy est alors utilisé.
+//!
+//! Mesures disponibles : fréquence obtenue (achievedRate()), 99e centile de la gigue de
+//! réveil (jitterP99(), écart entre l'échéance et le début du tick), charge (load()) et
+//! nombre de ticks manqués.
+class LoopScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    //! Façon d'attendre l'échéance.
+    enum Mode {
+        ModeAuto,
+        ModeTimer,
+        ModeBusy
+    };
+
+    explicit LoopScheduler(QObject* pParent = nullptr);
+
+    void setInterval(int intervalInMilliseconds);
+    int interval() const;
+
+    void setMode(Mode mode);
+    Mode mode() const;
+    Mode activeMode() const;
+
+    void start();
+    void stop();
+    bool isActive() const;
+
+    double achievedRate() const;
+    double jitterP99() const;
+    double load() const;
+    long long missedTickCount() const;
+
+    static QString modeName(Mode mode);
+
+signals:
+    void tick();
+
+private slots:
+    void onTimeout();
+
+private:
+    void scheduleWakeUp(qint64 now);
+    void updateMetrics(qint64 now);
+    void updateActiveMode();
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    bool m_active;
+    qint64 m_intervalNs;
+    qint64 m_nextDeadlineNs;
+
+    Mode m_mode;
+    Mode m_activeMode;
+
+    QVector<qint64> m_jitterSamples;    // Tableau circulaire des dernières gigues (ns).
+    int m_jitterSampleIndex;
+    int m_jitterSampleCount;
+
+    qint64 m_windowStartNs;
+    int m_windowTickCount;
+    double m_achievedRate;
+    double m_jitterP99;
+    double m_load;
+    long long m_missedTickCount;
+};
+
+#endif // LOOPSCHEDULER_H
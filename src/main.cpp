@@ -206,9 +206,20 @@
  *
  */
 
+#include "assetbundle.h"
+#include "assetloader.h"
+#include "gamecanvas.h"
+#include "gameoptions.h"
+#include "gameview.h"
+#include "levelreader.h"
 #include "mainfrm.h"
+#include "resources.h"
+#include "tracewriter.h"
+#include "utilities.h"
 
 #include <QApplication>
+#include <QByteArray>
+#include <QFileInfo>
 
 /**
  * @brief main
@@ -218,8 +229,50 @@
  */
 int main(int argc, char *argv[])
 {
+    // Démarre la mesure du temps nécessaire à l'affichage de la première image.
+    BrickBreaker::elapsedSinceStartup();
+
+    // Déclaré avant l'application pour n'être détruit qu'après elle, et donc après le chargeur
+    // d'images, dont les threads peuvent encore ajouter des événements à la trace.
+    TraceWriter traceWriter;
+
+    // Sans fenêtre, la plateforme graphique "offscreen" évite de dépendre d'un écran. Les
+    // options ne sont lues qu'une fois l'application construite : celle-ci est cherchée ici.
+    for (int i = 1; i < argc; ++i) {
+        if (QByteArray(argv[i]) == "--headless" && qgetenv("QT_QPA_PLATFORM").isEmpty())
+            qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication a(argc, argv);
 
+    GameOptions& rOptions = GameOptions::instance();
+    rOptions.process(a);
+
+    // Le répertoire res peut être imposé (sinon, voir BrickBreaker::resourcesPath()).
+    if (!rOptions.resourcesPath().isEmpty())
+        BrickBreaker::setResourcesPath(rOptions.resourcesPath());
+
+    // Production hors ligne du paquet d'images pré-décodées (voir AssetBundle).
+    if (rOptions.packAssets())
+        return AssetBundle::pack(BrickBreaker::imagesPath(), AssetLoader::bundleFileName()) ? 0 : 1;
+
+    // Conversion hors ligne d'un niveau texte au format binaire (voir LevelReader).
+    if (!rOptions.convertLevelFileName().isEmpty()) {
+        QFileInfo levelFile(rOptions.convertLevelFileName());
+        QString binaryFileName = levelFile.path() + "/" + levelFile.completeBaseName() + "." + LevelReader::BINARY_SUFFIX;
+        return LevelReader::convertToBinary(levelFile.filePath(), binaryFileName) ? 0 : 1;
+    }
+
+    if (!rOptions.traceFileName().isEmpty())
+        traceWriter.open(rOptions.traceFileName());
+
+    // Simulation sans fenêtre, aussi rapide que possible (voir GameCanvas::runHeadless()).
+    if (rOptions.headless()) {
+        GameView view;
+        GameCanvas canvas(&view);
+        return canvas.runHeadless(rOptions.headlessTickCount());
+    }
+
     MainFrm w;
     w.show();
 
@@ -0,0 +1,198 @@
+/**
+  \file
+  \brief    Définition de la classe MemoryMonitor.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "memorymonitor.h"
+
+#include <algorithm>
+
+#include <QGraphicsItem>
+
+#include "assetloader.h"
+#include "gamescene.h"
+#include "staticsprite.h"
+
+// Initialisation des constantes.
+const qint64 OTHER_ITEM_SIZE = 400;     // Taille estimée d'un item qui n'est pas un sprite (texte, rectangle...).
+const qint64 KIBIBYTE = 1024;
+const qint64 MEBIBYTE = 1024 * KIBIBYTE;
+
+//! \return la taille donnée, en Ko ou en Mo.
+//! \param bytes  Taille en octets.
+static QString formattedSize(qint64 bytes) {
+    if (bytes >= MEBIBYTE)
+        return QString("%1 Mo").arg(double(bytes) / MEBIBYTE, 0, 'f', 1);
+
+    return QString("%1 Ko").arg(double(bytes) / KIBIBYTE, 0, 'f', 1);
+}
+
+//! Construit un moniteur sans relevé.
+MemoryMonitor::MemoryMonitor() {
+    m_pixmapBytes = 0;
+    m_bundleBytes = 0;
+    m_totalBytes = 0;
+    m_peakTotalBytes = 0;
+    m_spriteCount = 0;
+    m_peakSpriteCount = 0;
+    m_peakSceneCount = 0;
+}
+
+//! Fait un relevé des scènes données et du cache d'images. Les pics sont mis à jour.
+//! \param rScenes  Scènes existantes, affichées ou non.
+void MemoryMonitor::update(const QList<GameScene*>& rScenes) {
+    for (ClassUsage& rClassUsage : m_classUsages) {
+        rClassUsage.count = 0;
+        rClassUsage.bytes = 0;
+    }
+
+    QVector<SceneUsage> sceneUsages;
+    qint64 sceneBytes = 0;
+    m_spriteCount = 0;
+
+    for (const GameScene* pScene : rScenes) {
+        SceneUsage sceneUsage;
+        sceneUsage.pScene = pScene;
+        sceneUsage.name = pScene->objectName();
+        sceneUsage.bytes = pScene->backgroundImageSize();
+
+        const QList<QGraphicsItem*> items = pScene->items();
+        sceneUsage.itemCount = items.count();
+        for (const QGraphicsItem* pItem : items) {
+            if (!StaticSprite::isSpriteItem(pItem)) {
+                sceneUsage.bytes += OTHER_ITEM_SIZE;
+                continue;
+            }
+
+            const StaticSprite* pSprite = static_cast<const StaticSprite*>(pItem);
+            const qint64 spriteSize = pSprite->estimatedSize();
+            ClassUsage& rClassUsage = m_classUsages[pSprite->spriteClassName()];
+            rClassUsage.count++;
+            rClassUsage.bytes += spriteSize;
+            sceneUsage.spriteCount++;
+            sceneUsage.bytes += spriteSize;
+        }
+
+        // Le pic d'une scène est conservé tant que la scène existe.
+        for (const SceneUsage& rPreviousUsage : m_sceneUsages) {
+            if (rPreviousUsage.pScene == pScene)
+                sceneUsage.peakBytes = rPreviousUsage.peakBytes;
+        }
+        sceneUsage.peakBytes = qMax(sceneUsage.peakBytes, sceneUsage.bytes);
+
+        m_spriteCount += sceneUsage.spriteCount;
+        sceneBytes += sceneUsage.bytes;
+        sceneUsages.append(sceneUsage);
+    }
+    m_sceneUsages = sceneUsages;
+
+    for (ClassUsage& rClassUsage : m_classUsages) {
+        rClassUsage.peakCount = qMax(rClassUsage.peakCount, rClassUsage.count);
+        rClassUsage.peakBytes = qMax(rClassUsage.peakBytes, rClassUsage.bytes);
+    }
+
+    AssetLoader* pAssetLoader = AssetLoader::instance();
+    m_assetUsages = pAssetLoader->pixmapSizes();
+    m_pixmapBytes = 0;
+    for (qint64 pixmapSize : m_assetUsages)
+        m_pixmapBytes += pixmapSize;
+    m_bundleBytes = pAssetLoader->bundleSize();
+
+    m_totalBytes = sceneBytes + m_pixmapBytes;
+    m_peakTotalBytes = qMax(m_peakTotalBytes, m_totalBytes);
+    m_peakSpriteCount = qMax(m_peakSpriteCount, m_spriteCount);
+    m_peakSceneCount = qMax(m_peakSceneCount, m_sceneUsages.count());
+}
+
+//! \return la taille totale estimée des scènes et des images du cache, en octets.
+//! Le paquet d'images, projeté depuis son fichier, n'est pas compté.
+qint64 MemoryMonitor::totalBytes() const {
+    return m_totalBytes;
+}
+
+//! \return la plus grande taille totale relevée, en octets.
+qint64 MemoryMonitor::peakTotalBytes() const {
+    return m_peakTotalBytes;
+}
+
+//! \return la taille des images du cache, en octets.
+qint64 MemoryMonitor::pixmapBytes() const {
+    return m_pixmapBytes;
+}
+
+//! \return le nombre de sprites de toutes les scènes.
+int MemoryMonitor::spriteCount() const {
+    return m_spriteCount;
+}
+
+//! \return le plus grand nombre de sprites relevé.
+int MemoryMonitor::peakSpriteCount() const {
+    return m_peakSpriteCount;
+}
+
+//! \return le relevé de chaque classe de sprite, par nom de classe.
+const QMap<QString, MemoryMonitor::ClassUsage>& MemoryMonitor::classUsages() const {
+    return m_classUsages;
+}
+
+//! \return la taille de chaque image du cache, par nom d'image.
+const QMap<QString, qint64>& MemoryMonitor::assetUsages() const {
+    return m_assetUsages;
+}
+
+//! \return le relevé de chaque scène.
+const QVector<MemoryMonitor::SceneUsage>& MemoryMonitor::sceneUsages() const {
+    return m_sceneUsages;
+}
+
+//! \return un résumé du dernier relevé : totaux, puis les classes de sprites les plus
+//! volumineuses et les scènes.
+//! \param maxLineCount  Nombre maximal de lignes.
+QStringList MemoryMonitor::summary(int maxLineCount) const {
+    QStringList lines;
+    lines << QString("Mémoire : %1 (pic %2), images %3")
+             .arg(formattedSize(m_totalBytes), formattedSize(m_peakTotalBytes), formattedSize(m_pixmapBytes));
+    lines << QString("%1 scènes (pic %2), %3 sprites (pic %4)")
+             .arg(m_sceneUsages.count()).arg(m_peakSceneCount).arg(m_spriteCount).arg(m_peakSpriteCount);
+
+    QStringList classNames = m_classUsages.keys();
+    std::sort(classNames.begin(), classNames.end(), [this](const QString& rName1, const QString& rName2) {
+        return m_classUsages[rName1].bytes > m_classUsages[rName2].bytes;
+    });
+    for (const QString& rClassName : classNames) {
+        const ClassUsage& rClassUsage = m_classUsages[rClassName];
+        if (rClassUsage.count > 0)
+            lines << QString("%1 : %2 (pic %3), %4").arg(rClassName).arg(rClassUsage.count)
+                     .arg(rClassUsage.peakCount).arg(formattedSize(rClassUsage.bytes));
+    }
+
+    for (const SceneUsage& rSceneUsage : m_sceneUsages)
+        lines << QString("Scène %1 : %2 sprites, %3 (pic %4)").arg(rSceneUsage.name).arg(rSceneUsage.spriteCount)
+                 .arg(formattedSize(rSceneUsage.bytes), formattedSize(rSceneUsage.peakBytes));
+
+    return lines.mid(0, maxLineCount);
+}
+
+//! \return le détail du dernier relevé, sur plusieurs lignes.
+QString MemoryMonitor::report() const {
+    QStringList lines;
+    lines << QString("Mémoire estimée : %1 (pic %2), paquet d'images projeté : %3")
+             .arg(formattedSize(m_totalBytes), formattedSize(m_peakTotalBytes), formattedSize(m_bundleBytes));
+
+    lines << QString("Sprites : %1 (pic %2)").arg(m_spriteCount).arg(m_peakSpriteCount);
+    for (auto it = m_classUsages.constBegin(); it != m_classUsages.constEnd(); ++it)
+        lines << QString("  %1 : %2 (pic %3), %4 (pic %5)").arg(it.key()).arg(it.value().count).arg(it.value().peakCount)
+                 .arg(formattedSize(it.value().bytes), formattedSize(it.value().peakBytes));
+
+    lines << QString("Images : %1").arg(formattedSize(m_pixmapBytes));
+    for (auto it = m_assetUsages.constBegin(); it != m_assetUsages.constEnd(); ++it)
+        lines << QString("  %1 : %2").arg(it.key(), formattedSize(it.value()));
+
+    lines << QString("Scènes : %1 (pic %2)").arg(m_sceneUsages.count()).arg(m_peakSceneCount);
+    for (const SceneUsage& rSceneUsage : m_sceneUsages)
+        lines << QString("  %1 : %2 sprites, %3 items, %4 (pic %5)").arg(rSceneUsage.name).arg(rSceneUsage.spriteCount)
+                 .arg(rSceneUsage.itemCount).arg(formattedSize(rSceneUsage.bytes), formattedSize(rSceneUsage.peakBytes));
+
+    return lines.join('\n');
+}
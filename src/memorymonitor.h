@@ -0,0 +1,89 @@
+/**
+  \file
+  \brief    Déclaration de la classe MemoryMonitor.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef MEMORYMONITOR_H
+#define MEMORYMONITOR_H
+
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class GameScene;
+
+//! \brief Classe qui estime la mémoire occupée par les scènes, les sprites et les images.
+//!
+//! La méthode update() fait un relevé des scènes données et du cache d'images
+//! (AssetLoader) :
+//! - pour chaque classe de sprite (StaticSprite::spriteClassName()) : nombre de sprites
+//!   vivants et taille estimée (StaticSprite::estimatedSize()) ;
+//! - pour chaque image du cache : taille de ses pixels ;
+//! - pour chaque scène : nombre de sprites et d'items, taille des sprites, des autres
+//!   items et de l'image de fond.
+//!
+//! Les valeurs les plus élevées relevées depuis la création du moniteur (pics) sont
+//! conservées, ce qui permet par exemple de voir la mémoire augmenter d'une partie à
+//! l'autre.
+//!
+//! Les tailles sont des estimations : les données privées de Qt sont comptées avec une
+//! taille moyenne, et les images partagées par plusieurs sprites ne sont comptées qu'une
+//! fois, dans le cache d'images.
+class MemoryMonitor
+{
+public:
+    //! Relevé d'une classe de sprite.
+    struct ClassUsage
+    {
+        int count = 0;          //!< Nombre de sprites vivants.
+        qint64 bytes = 0;       //!< Taille estimée de ces sprites, en octets.
+        int peakCount = 0;      //!< Plus grand nombre de sprites relevé.
+        qint64 peakBytes = 0;   //!< Plus grande taille relevée.
+    };
+
+    //! Relevé d'une scène.
+    struct SceneUsage
+    {
+        const GameScene* pScene = nullptr;
+        QString name;           //!< Nom de la scène (QObject::objectName()).
+        int spriteCount = 0;    //!< Nombre de sprites.
+        int itemCount = 0;      //!< Nombre total d'items, sprites compris.
+        qint64 bytes = 0;       //!< Taille estimée des items et de l'image de fond, en octets.
+        qint64 peakBytes = 0;   //!< Plus grande taille relevée.
+    };
+
+    MemoryMonitor();
+
+    void update(const QList<GameScene*>& rScenes);
+
+    qint64 totalBytes() const;
+    qint64 peakTotalBytes() const;
+    qint64 pixmapBytes() const;
+    int spriteCount() const;
+    int peakSpriteCount() const;
+
+    const QMap<QString, ClassUsage>& classUsages() const;
+    const QMap<QString, qint64>& assetUsages() const;
+    const QVector<SceneUsage>& sceneUsages() const;
+
+    QStringList summary(int maxLineCount) const;
+    QString report() const;
+
+private:
+    QMap<QString, ClassUsage> m_classUsages;
+    QMap<QString, qint64> m_assetUsages;
+    QVector<SceneUsage> m_sceneUsages;
+
+    qint64 m_pixmapBytes;
+    qint64 m_bundleBytes;
+    qint64 m_totalBytes;
+    qint64 m_peakTotalBytes;
+    int m_spriteCount;
+    int m_peakSpriteCount;
+    int m_peakSceneCount;
+};
+
+#endif // MEMORYMONITOR_H
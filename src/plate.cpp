@@ -6,8 +6,8 @@
 */
 #include "plate.h"
 
+#include "assetloader.h"
 #include "gamescene.h"
-#include "resources.h"
 #include "sprite.h"
 
 #include <QDebug>
@@ -18,8 +18,8 @@ const int PLATE_X = 100;
 
 //! Construit et initialise un plateau.
 //! \param pParent  Objet propiétaire de cet objet.
-Plate::Plate(QGraphicsItem* pParent) : Sprite(BrickBreaker::imagesPath() + "plate.png", pParent) {
-    this->setData(0, "plate");
+Plate::Plate(QGraphicsItem* pParent) : Sprite(AssetLoader::instance()->pixmap("plate.png"), pParent) {
+    this->setCategory(CategoryPlate);
     m_velocity = QPointF(0,0);
 }
 
@@ -66,3 +66,7 @@ void Plate::onMouseMoved(QPointF newMousePosition) {
     this->setPos(positionX - this->width() / 2.0, m_pParentScene->height() - PLATE_X);
 }
 
+//! \return la taille estimée du plateau en mémoire, en octets.
+qint64 Plate::estimatedSize() const {
+    return Sprite::estimatedSize() + qint64(sizeof(Plate) - sizeof(Sprite));
+}
@@ -18,6 +18,7 @@ public:
     Plate(QGraphicsItem* pParent = nullptr);
 
     void tick(long long elapsedTimeInMilliseconds);
+    virtual qint64 estimatedSize() const;
 
 public slots:
     void onMouseMoved(QPointF newMousePosition);
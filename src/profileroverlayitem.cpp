@@ -0,0 +1,108 @@
+/**
+  \file
+  \brief    Définition de la classe ProfilerOverlayItem.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "profileroverlayitem.h"
+
+#include <QPainter>
+#include <QStringList>
+
+#include "frameprofiler.h"
+#include "memorymonitor.h"
+
+// Initialisation des constantes.
+const int OVERLAY_WIDTH = 380;
+const int LINE_HEIGHT = 16;
+const int HEADER_LINES = 2;
+const int MAX_BARS = 12;
+const int MAX_MEMORY_LINES = 8;
+const int LABEL_WIDTH = 170;
+const int BAR_WIDTH = 150;
+const int MARGIN = 6;
+
+//! Construit l'item, caché, avec un budget d'image de 10 ms.
+//! \param pParent  Item parent.
+ProfilerOverlayItem::ProfilerOverlayItem(QGraphicsItem* pParent) : QGraphicsItem(pParent) {
+    m_frameBudget = 10;
+    m_pMemoryMonitor = nullptr;
+    setFlag(QGraphicsItem::ItemIgnoresTransformations);
+    hide();
+}
+
+//! Affiche ou cache l'item, et active ou désactive le profileur en conséquence.
+//! \param visible  Indique si l'item doit être affiché.
+void ProfilerOverlayItem::setOverlayVisible(bool visible) {
+    setVisible(visible);
+    FrameProfiler::instance().setEnabled(visible);
+}
+
+//! Change le budget d'une image, qui donne l'échelle des barres.
+//! \param frameBudgetInMilliseconds  Durée souhaitée d'une image, en millisecondes.
+void ProfilerOverlayItem::setFrameBudget(double frameBudgetInMilliseconds) {
+    m_frameBudget = qMax(1.0, frameBudgetInMilliseconds);
+}
+
+//! \return le budget d'une image, en millisecondes.
+double ProfilerOverlayItem::frameBudget() const {
+    return m_frameBudget;
+}
+
+//! Définit le moniteur dont le dernier relevé est affiché sous les barres.
+//! \param pMemoryMonitor  Moniteur de la mémoire, ou nullptr pour ne pas afficher de relevé.
+void ProfilerOverlayItem::setMemoryMonitor(const MemoryMonitor* pMemoryMonitor) {
+    m_pMemoryMonitor = pMemoryMonitor;
+}
+
+//! \return le rectangle dans lequel l'item se dessine.
+QRectF ProfilerOverlayItem::boundingRect() const {
+    return QRectF(0, 0, OVERLAY_WIDTH, 2 * MARGIN + (HEADER_LINES + MAX_BARS + MAX_MEMORY_LINES) * LINE_HEIGHT);
+}
+
+//! Dessine les centiles de la durée des images et une barre par marqueur.
+void ProfilerOverlayItem::paint(QPainter* pPainter, const QStyleOptionGraphicsItem* pOption, QWidget* pWidget) {
+    Q_UNUSED(pOption)
+    Q_UNUSED(pWidget)
+
+    const FrameProfiler& rProfiler = FrameProfiler::instance();
+    const QVector<FrameProfiler::Stage>& rStages = rProfiler.stages();
+    const int barCount = qMin(rStages.count(), MAX_BARS);
+    const QStringList memoryLines = m_pMemoryMonitor ? m_pMemoryMonitor->summary(MAX_MEMORY_LINES) : QStringList();
+
+    pPainter->fillRect(QRectF(0, 0, OVERLAY_WIDTH, 2 * MARGIN + (HEADER_LINES + barCount + memoryLines.count()) * LINE_HEIGHT),
+                       QColor(0, 0, 0, 180));
+    pPainter->setPen(Qt::white);
+
+    int y = MARGIN;
+    pPainter->drawText(QRectF(MARGIN, y, OVERLAY_WIDTH, LINE_HEIGHT), Qt::AlignLeft | Qt::AlignVCenter,
+                       QString("Frame p50/p95/p99 : %1 / %2 / %3 ms")
+                       .arg(rProfiler.frameTimePercentile(50), 0, 'f', 2)
+                       .arg(rProfiler.frameTimePercentile(95), 0, 'f', 2)
+                       .arg(rProfiler.frameTimePercentile(99), 0, 'f', 2));
+    y += LINE_HEIGHT;
+    pPainter->drawText(QRectF(MARGIN, y, OVERLAY_WIDTH, LINE_HEIGHT), Qt::AlignLeft | Qt::AlignVCenter,
+                       QString("%1 frames, budget %2 ms, %3 events dropped")
+                       .arg(rProfiler.frameTimeCount())
+                       .arg(m_frameBudget, 0, 'f', 1)
+                       .arg(rProfiler.droppedEventCount()));
+    y += LINE_HEIGHT;
+
+    for (int i = 0; i < barCount; ++i) {
+        const FrameProfiler::Stage& rStage = rStages[i];
+        const double ratio = rStage.averageTime / m_frameBudget;
+
+        pPainter->setPen(Qt::white);
+        pPainter->drawText(QRectF(MARGIN, y, LABEL_WIDTH, LINE_HEIGHT), Qt::AlignLeft | Qt::AlignVCenter,
+                           QString("%1 %2").arg(rStage.name).arg(rStage.averageTime, 0, 'f', 2));
+        pPainter->fillRect(QRectF(MARGIN + LABEL_WIDTH, y + 3, BAR_WIDTH * qMin(1.0, ratio), LINE_HEIGHT - 6),
+                           ratio > 1.0 ? Qt::red : Qt::green);
+        y += LINE_HEIGHT;
+    }
+
+    pPainter->setPen(Qt::white);
+    for (const QString& rLine : memoryLines) {
+        pPainter->drawText(QRectF(MARGIN, y, OVERLAY_WIDTH, LINE_HEIGHT), Qt::AlignLeft | Qt::AlignVCenter, rLine);
+        y += LINE_HEIGHT;
+    }
+}
@@ -0,0 +1,47 @@
+/**
+  \file
+  \brief    Déclaration de la classe ProfilerOverlayItem.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef PROFILEROVERLAYITEM_H
+#define PROFILEROVERLAYITEM_H
+
+#include <QGraphicsItem>
+
+class MemoryMonitor;
+
+//! \brief Item qui affiche les mesures du FrameProfiler par-dessus la scène.
+//!
+//! L'item affiche la médiane et les 95e et 99e centiles de la durée des dernières images,
+//! puis une barre par marqueur, proportionnelle à sa durée moyenne par image. L'échelle des
+//! barres est donnée par le budget d'une image (setFrameBudget()) : une barre qui dépasse
+//! le budget est affichée en rouge.
+//!
+//! L'item ignore les transformations de la vue : il garde la même taille quelle que soit
+//! l'échelle d'affichage de la scène. Le profileur est activé tant que l'item est visible
+//! (voir setOverlayVisible()).
+//!
+//! Si un MemoryMonitor est défini (setMemoryMonitor()), le résumé de son dernier relevé est
+//! affiché sous les barres.
+class ProfilerOverlayItem : public QGraphicsItem
+{
+public:
+    ProfilerOverlayItem(QGraphicsItem* pParent = nullptr);
+
+    void setOverlayVisible(bool visible);
+
+    void setFrameBudget(double frameBudgetInMilliseconds);
+    double frameBudget() const;
+
+    void setMemoryMonitor(const MemoryMonitor* pMemoryMonitor);
+
+    virtual QRectF boundingRect() const;
+    virtual void paint(QPainter* pPainter, const QStyleOptionGraphicsItem* pOption, QWidget* pWidget = nullptr);
+
+private:
+    double m_frameBudget;
+    const MemoryMonitor* m_pMemoryMonitor;
+};
+
+#endif // PROFILEROVERLAYITEM_H
@@ -0,0 +1,70 @@
+/**
+  \file
+  \brief    Définition de la classe RandomGenerator.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "randomgenerator.h"
+
+//! \return la valeur donnée, décalée circulairement de k bits vers la gauche.
+static inline quint32 rotateLeft(quint32 value, int k) {
+    return (value << k) | (value >> (32 - k));
+}
+
+//! Construit un générateur initialisé avec la graine donnée.
+//! \param seed  Graine du générateur.
+RandomGenerator::RandomGenerator(quint64 seed) {
+    this->seed(seed);
+}
+
+//! Réinitialise le générateur avec la graine donnée.
+//! \param seed  Graine du générateur.
+void RandomGenerator::seed(quint64 seed) {
+    // splitmix64 : répartit les bits de la graine sur tout l'état, qui ne doit pas être nul.
+    for (int i = 0; i < 4; i += 2) {
+        quint64 z = (seed += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        z = z ^ (z >> 31);
+        m_state[i] = quint32(z);
+        m_state[i + 1] = quint32(z >> 32);
+    }
+}
+
+//! \return le prochain nombre pseudo-aléatoire (32 bits).
+quint32 RandomGenerator::next() {
+    const quint32 result = rotateLeft(m_state[1] * 5, 7) * 9;
+    const quint32 t = m_state[1] << 9;
+
+    m_state[2] ^= m_state[0];
+    m_state[3] ^= m_state[1];
+    m_state[1] ^= m_state[2];
+    m_state[0] ^= m_state[3];
+    m_state[2] ^= t;
+    m_state[3] = rotateLeft(m_state[3], 11);
+
+    return result;
+}
+
+//! \return un nombre pseudo-aléatoire compris entre 0 (inclus) et bound (exclu),
+//! sans biais (méthode de Lemire).
+//! \param bound  Borne supérieure (exclue), qui doit être strictement positive.
+quint32 RandomGenerator::bounded(quint32 bound) {
+    Q_ASSERT(bound > 0);
+
+    quint64 product = quint64(next()) * bound;
+    quint32 low = quint32(product);
+    if (low < bound) {
+        const quint32 threshold = (0u - bound) % bound;
+        while (low < threshold) {
+            product = quint64(next()) * bound;
+            low = quint32(product);
+        }
+    }
+    return quint32(product >> 32);
+}
+
+//! \return un nombre pseudo-aléatoire compris entre 0 (inclus) et 1 (exclu).
+double RandomGenerator::uniform() {
+    return next() * (1.0 / 4294967296.0);
+}
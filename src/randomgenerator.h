@@ -0,0 +1,41 @@
+/**
+  \file
+  \brief    Déclaration de la classe RandomGenerator.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef RANDOMGENERATOR_H
+#define RANDOMGENERATOR_H
+
+#include <QtGlobal>
+
+//! \brief Générateur pseudo-aléatoire rapide et reproductible (xoshiro128**).
+//!
+//! Pour une même graine, la suite de nombres produite est toujours la même, quelle que
+//! soit la plateforme ou la bibliothèque standard utilisée, contrairement à std::rand().
+//! L'état interne (128 bits) est initialisé à partir de la graine avec splitmix64.
+//!
+//! La classe respecte les exigences de UniformRandomBitGenerator et peut donc être
+//! utilisée avec les distributions de `<random>`.
+class RandomGenerator
+{
+public:
+    typedef quint32 result_type;
+
+    explicit RandomGenerator(quint64 seed = 0);
+
+    void seed(quint64 seed);
+
+    quint32 next();
+    quint32 bounded(quint32 bound);
+    double uniform();
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+    result_type operator()() { return next(); }
+
+private:
+    quint32 m_state[4];
+};
+
+#endif // RANDOMGENERATOR_H
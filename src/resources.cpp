@@ -10,8 +10,58 @@
 #include <QCoreApplication>
 #include <QDir>
 #include <QDebug>
+#include <QHash>
+#include <QVector>
 
 namespace BrickBreaker {
+
+//! Chemins des ressources, résolus une seule fois puis conservés.
+//! Ces données ne doivent être utilisées que depuis le thread principal.
+struct ResourceLocator
+{
+    QString resourcesPath;
+    QString imagesPath;
+    QHash<QString, ImageId> imageIds;
+    QVector<QString> imageNames;
+    QVector<QString> imagePaths;
+};
+
+//! \return l'instance unique du localisateur de ressources.
+static ResourceLocator& locator() {
+    static ResourceLocator s_locator;
+    return s_locator;
+}
+
+//! Calcule le chemin absolu du répertoire res à partir de l'emplacement de l'exécutable.
+//! Voir resourcesPath().
+static QString defaultResourcesPath() {
+    QDir resourceDir = QDir(qApp->applicationDirPath());
+    #ifndef DEPLOY
+        #ifdef Q_OS_MAC
+            resourceDir.cdUp(); // Quitte MacOS
+            resourceDir.cdUp(); // Quitte Contents
+            resourceDir.cdUp(); // Quitte GameFramwork.app
+        #endif
+        resourceDir.cdUp(); // Quitte 'debug...' !! ATTENTION : selon la version de QtCreator, cette ligne doit être supprimée.
+        resourceDir.cdUp(); // Quitte 'build...'
+    #endif
+    resourceDir.cd("res");
+    return resourceDir.absolutePath();
+}
+
+//! Impose le répertoire res (par exemple depuis l'option de ligne de commande
+//! `--res-dir`). Cette fonction doit être appelée avant le premier accès aux ressources,
+//! car les chemins déjà construits par imagePath() ne sont pas recalculés.
+//! \param rPath  Chemin du répertoire res.
+void setResourcesPath(const QString& rPath) {
+    ResourceLocator& rLocator = locator();
+    rLocator.resourcesPath = QDir(rPath).absolutePath() + QDir::separator();
+    rLocator.imagesPath = rLocator.resourcesPath + QString("images") + QDir::separator();
+    rLocator.imagePaths.clear();
+    for (const QString& rImageName : rLocator.imageNames)
+        rLocator.imagePaths.append(rLocator.imagesPath + rImageName);
+}
+
 /**
 Cette fonction retourne le chemin absolu du répertoire res.
 Si la pseudo-constante DEPLOY est définie, elle se base sur la structure
@@ -68,33 +118,77 @@ Voici un exemple d'utilisation possible :
 Cette commande génère les fichiers MakeFile, nécessaires pour l'étape de compilation, en s'assurant
 que la compilation se fasse en mode *Release* et que le pseudo-constante `DEPLOY` soit définie.
 
+Le répertoire peut aussi être imposé avec la variable d'environnement `CASSEBRIQUE_RES_DIR`
+ou avec setResourcesPath().
+
+Le chemin n'est calculé qu'au premier appel, puis conservé.
+
 
 \return une chaîne de caractères contenant le chemin absolu du répertoire res.
 */
     QString resourcesPath() {
-        QDir resourceDir = QDir(qApp->applicationDirPath());
-        #ifndef DEPLOY
-            #ifdef Q_OS_MAC
-                resourceDir.cdUp(); // Quitte MacOS
-                resourceDir.cdUp(); // Quitte Contents
-                resourceDir.cdUp(); // Quitte GameFramwork.app
-            #endif
-            resourceDir.cdUp(); // Quitte 'debug...' !! ATTENTION : selon la version de QtCreator, cette ligne doit être supprimée.
-            resourceDir.cdUp(); // Quitte 'build...'
-        #endif
-        resourceDir.cd("res");
-        return resourceDir.absolutePath() + QDir::separator();
+        if (locator().resourcesPath.isEmpty()) {
+            QString path = QString::fromLocal8Bit(qgetenv(RESOURCES_PATH_ENV));
+            setResourcesPath(path.isEmpty() ? defaultResourcesPath() : path);
+        }
+        return locator().resourcesPath;
     }
 
 /**
  * \return une chaîne de caractères contenant le chemin absolu du répertoire des images.
  */
     QString imagesPath() {
-        return resourcesPath() + QDir::separator() + QString("images") + QDir::separator();
+        resourcesPath();
+        return locator().imagesPath;
     }
 
 
     QString imagesPath(QString subFolder) {
-        return imagesPath() + QDir::separator() + subFolder + QDir::separator();
+        return imagesPath() + subFolder + QDir::separator();
+    }
+
+/**
+ * Attribue un identifiant à l'image donnée. Une même image reçoit toujours le même
+ * identifiant, et son chemin complet n'est construit qu'une seule fois.
+ * \param rImageName  Chemin de l'image, relatif au répertoire des images.
+ * \return l'identifiant de l'image.
+ */
+    ImageId imageId(const QString& rImageName) {
+        ResourceLocator& rLocator = locator();
+        auto it = rLocator.imageIds.constFind(rImageName);
+        if (it != rLocator.imageIds.constEnd())
+            return it.value();
+
+        // Le répertoire des images est résolu en premier : au premier accès aux ressources,
+        // setResourcesPath() reconstruit la liste des chemins à partir des noms d'images.
+        const QString path = imagesPath() + rImageName;
+
+        ImageId id = rLocator.imageNames.count();
+        rLocator.imageIds.insert(rImageName, id);
+        rLocator.imageNames.append(rImageName);
+        rLocator.imagePaths.append(path);
+        return id;
+    }
+
+/**
+ * \return le chemin, relatif au répertoire des images, de l'image d'identifiant donné.
+ */
+    QString imageName(ImageId id) {
+        return locator().imageNames.value(id);
+    }
+
+/**
+ * \return le chemin absolu de l'image d'identifiant donné.
+ */
+    QString imagePath(ImageId id) {
+        return locator().imagePaths.value(id);
+    }
+
+/**
+ * \return le chemin absolu de l'image donnée.
+ * \param rImageName  Chemin de l'image, relatif au répertoire des images.
+ */
+    QString imagePath(const QString& rImageName) {
+        return imagePath(imageId(rImageName));
     }
 }
@@ -14,8 +14,20 @@
 //! Espace de noms contenant les fonctions utilitaires pour les ressources.
 //!
 namespace BrickBreaker {
+    //! Identifiant d'une image, attribué par imageId().
+    typedef int ImageId;
+
+    //! Nom de la variable d'environnement permettant d'imposer le répertoire res.
+    const char RESOURCES_PATH_ENV[] = "CASSEBRIQUE_RES_DIR";
+
+    void setResourcesPath(const QString& rPath);
     QString resourcesPath();
     QString imagesPath();
     QString imagesPath(QString subFolder);
+
+    ImageId imageId(const QString& rImageName);
+    QString imageName(ImageId id);
+    QString imagePath(ImageId id);
+    QString imagePath(const QString& rImageName);
 }
 #endif // RESOURCES_H
@@ -15,12 +15,13 @@
 int Sprite::s_spriteCount = 0;
 
 const int NO_CURRENT_FRAME = -1;
+const qint64 OBJECT_PRIVATE_SIZE = 300; // Taille estimée des données privées du QObject et du QTimer d'un sprite.
 
 //! Construit un sprite et l'initialise.
 //! Le sprite n'a pas d'apparence particulière et n'affichera rien
 //! tant qu'une image ne lui sera pas fournie avec addAnimationFrame().
 //! \param pParent  Pointeur sur le parent (afin d'obtenir une destruction automatique de cet objet).
-Sprite::Sprite(QGraphicsItem* pParent) : QGraphicsPixmapItem(pParent) {
+Sprite::Sprite(QGraphicsItem* pParent) : StaticSprite(pParent) {
     init();
 }
 
@@ -28,7 +29,7 @@ Sprite::Sprite(QGraphicsItem* pParent) : QGraphicsPixmapItem(pParent) {
 //! Le sprite utilisera l'image fournie pour son apparence.
 //! \param rPixmap   Image à utiliser pour l'apparence du sprite.
 //! \param pParent   Pointeur sur le parent (afin d'obtenir une destruction automatique de cet objet).
-Sprite::Sprite(const QPixmap& rPixmap, QGraphicsItem* pParent) : QGraphicsPixmapItem(pParent) {
+Sprite::Sprite(const QPixmap& rPixmap, QGraphicsItem* pParent) : StaticSprite(pParent) {
     init();
     addAnimationFrame(rPixmap);
 }
@@ -39,6 +40,9 @@ Sprite::~Sprite() {
     s_spriteCount--;
     displaySpriteCount();
 #endif
+    if (m_pParentScene != nullptr)
+        m_pParentScene->unregisterSpriteFromTick(this);
+
     if (m_pTickHandler != nullptr) {
         delete m_pTickHandler;
         m_pTickHandler = nullptr;
@@ -171,27 +175,6 @@ bool Sprite::isEmitSignalEndOfAnimationEnabled() const {
     return m_emitSignalEOA;
 }
 
-//! Mémorise la scène à laquelle appartient ce sprite.
-//! \param pScene  Scène à laquelle appartient ce sprite.
-void Sprite::setParentScene(GameScene* pScene) {
-    m_pParentScene = pScene;
-}
-
-#if defined(DEBUG_BBOX) || defined(DEBUG_SHAPE)
-//! Dessine le sprite, avec sa boundingbox qui l'entoure.
-void Sprite::paint(QPainter* pPainter, const QStyleOptionGraphicsItem* pOption, QWidget* pWidget) {
-    QGraphicsPixmapItem::paint(pPainter, pOption, pWidget);
-#ifdef DEBUG_BBOX
-    pPainter->setPen(Qt::white);
-    pPainter->drawRect(this->boundingRect());
-#endif
-#ifdef DEBUG_SHAPE
-    pPainter->setPen(Qt::red);
-    pPainter->drawPath(this->shape());
-#endif
-}
-#endif
-
 //! Enregistre ce sprite auprès de la scène afin qu'il soit informé de la
 //! cadence et que la fonction tick() soit appelée en cadence.
 void Sprite::registerForTick() {
@@ -239,73 +222,33 @@ void Sprite::removeTickHandler() {
     }
 }
 
-//! \return un pointeur sur la scène à laquelle appartient ce sprite.
-GameScene* Sprite::parentScene() const {
-    return m_pParentScene;
+//! \return le nom de la classe du sprite, tiré de ses méta-données : les classes dérivées
+//! qui déclarent la macro Q_OBJECT n'ont pas à surcharger cette méthode.
+const char* Sprite::spriteClassName() const {
+    return metaObject()->className();
 }
 
-//! Affiche dans la sortie de debug le nombre de sprites existants.
-void Sprite::displaySpriteCount() {
-    qDebug() << "Nombre de sprites : " << s_spriteCount;
+//! \return la taille estimée du sprite en mémoire, en octets, listes d'animation comprises.
+//! Les images des animations sont partagées avec le cache d'images et ne sont pas comptées.
+qint64 Sprite::estimatedSize() const {
+    qint64 size = StaticSprite::estimatedSize() + qint64(sizeof(Sprite) - sizeof(StaticSprite)) + OBJECT_PRIVATE_SIZE;
+    for (const QList<QPixmap>& rAnimation : m_animationList)
+        size += sizeof(rAnimation) + rAnimation.count() * sizeof(QPixmap);
+    return size;
 }
 
-//! Construit la liste de tous les sprites en collision avec ce sprite.
-//! Si la scène contient de nombreux sprites, cette méthode peut prendre du temps.
-//! \return une liste de sprites en collision. Si aucun autre sprite ne collisionne
-//! avec ce sprite, la liste retournée est vide.
-QList<Sprite*> Sprite::collidingSprites() const {
-    QList<Sprite*> collidingSpriteList;
-
-    if (m_pParentScene != nullptr) {
-        collidingSpriteList = m_pParentScene->collidingSprites(this);
-    } else {
-        qDebug() << "Le sprite ne fait pas partie d'une scène.";
-    }
-    return collidingSpriteList;
-}
-
-//! Construit la liste de tous les sprites en collision avec le rectangle donné
-//! en paramètre, sauf ce sprite-même.
-//! Si la scène contient de nombreux sprites, cette méthode peut prendre du temps.
-//! \param rRect Rectangle avec lequel il faut tester les collisions.
-//! \return une liste de sprites en collision.
-QList<Sprite*> Sprite::collidingSprites(const QRectF& rRect) const {
-    QList<Sprite*> collidingSpriteList;
-
-    if (m_pParentScene != nullptr) {
-        collidingSpriteList = m_pParentScene->collidingSprites(rRect);
-
-        // Ce sprite lui-même collisionne avec le rectangle donné. Il faut donc l'ignorer.
-        collidingSpriteList.removeAll(const_cast<Sprite*>(this));
-    } else {
-        qDebug() << "Le sprite ne fait pas partie d'une scène.";
-    }
-    return collidingSpriteList;
-}
-
-//! Construit la liste de tous les sprites en collision avec la forme donnée
-//! en paramètre, sauf ce sprite-même.
-//! Si la scène contient de nombreux sprites, cette méthode peut prendre du temps.
-//! \param rShape Forme avec laquelle il faut tester les collisions.
-//! \return une liste de sprites en collision.
-QList<Sprite*> Sprite::collidingSprites(const QPainterPath& rShape) const {
-    QList<Sprite*> collidingSpriteList;
-
-    if (m_pParentScene != nullptr) {
-        collidingSpriteList = m_pParentScene->collidingSprites(rShape);
-
-        // Ce sprite lui-même collisionne avec le rectangle donné. Il faut donc l'ignorer.
-        collidingSpriteList.removeAll(const_cast<Sprite*>(this));
-    } else {
-        qDebug() << "Le sprite ne fait pas partie d'une scène.";
-    }
-    return collidingSpriteList;
+//! Affiche dans la sortie de debug le nombre de sprites existants.
+void Sprite::displaySpriteCount() {
+    qDebug() << "Nombre de sprites : " << s_spriteCount
+             << "(taille d'une instance : Sprite =" << sizeof(Sprite) << "octets, StaticSprite ="
+             << sizeof(StaticSprite) << "octets, sans les données privées de Qt)";
 }
 
 //! Initialise le sprite.
 void Sprite::init() {
     m_pTickHandler = nullptr;
-    m_pParentScene = nullptr;
+    m_tickIndex = -1;
+    m_deferredTickTime = 0;
     m_emitSignalEOA = false;
     m_frameDuration = 0;
     m_currentAnimationFrame = NO_CURRENT_FRAME;
@@ -7,20 +7,18 @@
 #ifndef SPRITE_H
 #define SPRITE_H
 
-// décommenter pour rendre la boundingbox de tous les sprites visible.
-//#define DEBUG_BBOX
-// décommenter pour rendre la shape de tous les sprites visible.
-//#define DEBUG_SHAPE
 // décommenter pour afficher dans la sortie de debug le nombre de sprites existants
 //#define DEBUG_SPRITE_COUNT
 
-#include <QGraphicsPixmapItem>
 #include <QObject>
 #include <QPixmap>
 #include <QTimer>
 
+#include "staticsprite.h"
+
 class GameScene;
 class SpriteTickHandler;
+class TickRegistry;
 
 //! \brief Classe qui représente un élément d'animation graphique 2D.
 //!
@@ -52,7 +50,10 @@ class SpriteTickHandler;
 //! Il est également possible de demander au sprite d'émettre un signal chaque fois que l'animation est terminée, avec la méthode setEmitSignalEndOfAnimationEnabled(). Cela permet par exemple de connecter ce signal au slot deleteLater() du même objet, afin de
 //! détruire automatiquement le sprite dès que l'animation est terminée (par exemple pour afficher une explosion).
 //!
-//! Comme la classe Sprite spécialise la classe QGraphicsPixmapItem, qui elle-même spécialise la class QGraphicsItem, toutes les méthodes de QGraphicsItem sont accessibles au sprite.
+//! Comme la classe Sprite spécialise la classe StaticSprite, qui elle-même spécialise les classes QGraphicsPixmapItem et QGraphicsItem, toutes les méthodes de QGraphicsItem sont accessibles au sprite.
+//!
+//! Pour les éléments qui ne bougent pas et ne sont pas animés (briques, murs, icônes), préférer StaticSprite,
+//! qui n'est pas un QObject et ne possède pas de timer : il est nettement plus léger.
 //!
 //! \section sprite_on_scene Intéger un sprite à une scène
 //! Lorsqu'un sprite est créé, il faut le placer sur une scène pour qu'il apparaisse, au
@@ -64,8 +65,7 @@ class SpriteTickHandler;
 //! Dès qu'un sprite est abonné à la cadence, sa méthode virtuelle tick() est
 //! automatiquement appelée.
 //!
-//! Attention : si le sprite est détruit, il faut s'assurer au préalable de le
-//! désabonner avec GameScene::unregisterSpriteFromTick().
+//! Lorsque le sprite est détruit, il est automatiquement désabonné de la cadence.
 //!
 //! \section tick_handler Le gestionnaire de cadence
 //!
@@ -87,7 +87,7 @@ class SpriteTickHandler;
 //! Une dernière solution est  de spécialiser la classe Sprite afin de surcharger
 //! la méthode tick().
 //!
-class Sprite : public QObject, public QGraphicsPixmapItem
+class Sprite : public QObject, public StaticSprite
 {
     Q_OBJECT
     Q_PROPERTY(qreal opacity READ opacity WRITE setOpacity NOTIFY opacityChanged FINAL)
@@ -126,20 +126,12 @@ public:
     void setEmitSignalEndOfAnimationEnabled(bool enabled);
     bool isEmitSignalEndOfAnimationEnabled() const;
 
-    QRectF globalBoundingBox() const { return mapRectToScene(boundingRect());  }
-    QPainterPath globalShape() const { return mapToScene(shape()); }
-    int width() const { return static_cast<int>(globalBoundingBox().width()); }
-    int height() const { return static_cast<int>(globalBoundingBox().height()); }
-    int left() const { return static_cast<int>(globalBoundingBox().left()); }
-    int top() const { return static_cast<int>(globalBoundingBox().top()); }
-    int right() const { return static_cast<int>(globalBoundingBox().right()); }
-    int bottom() const { return static_cast<int>(globalBoundingBox().bottom()); }
-
-    void setParentScene(GameScene* pScene);
-
     enum { SpriteItemType = UserType + 1 };
     virtual int type() const { return SpriteItemType; }
 
+    virtual const char* spriteClassName() const;
+    virtual qint64 estimatedSize() const;
+
     virtual void tick(long long elapsedTimeInMilliseconds);
     void registerForTick();
     void unregisterFromTick();
@@ -148,12 +140,6 @@ public:
     SpriteTickHandler* tickHandler() const;
     void removeTickHandler();
 
-    GameScene* parentScene() const;
-
-#if defined(DEBUG_BBOX) || defined(DEBUG_SHAPE)
-    virtual void paint(QPainter* pPainter, const QStyleOptionGraphicsItem* pOption, QWidget* pWidget = 0);
-#endif
-
 signals:
     void animationFinished();
     void opacityChanged();
@@ -165,19 +151,17 @@ signals:
     void rotationChanged();
     void scaleChanged();
 
-protected:
-    QList<Sprite*> collidingSprites() const;
-    QList<Sprite*> collidingSprites(const QRectF& rRect) const;
-    QList<Sprite*> collidingSprites(const QPainterPath& rShape) const;
-    GameScene* m_pParentScene;
-
 private:
+    friend class TickRegistry;
+
     static int s_spriteCount;
     static void displaySpriteCount();
 
     void init();
 
     SpriteTickHandler* m_pTickHandler;
+    int m_tickIndex; // Position dans la liste de cadence de la scène (TickRegistry), -1 si non cadencé.
+    long long m_deferredTickTime; // Temps accumulé hors de la zone active de la caméra (TickRegistry).
 
     QTimer m_animationTimer;
 
@@ -0,0 +1,32 @@
+/**
+  \file
+  \brief    Déclaration de la structure SpriteHandle.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef SPRITEHANDLE_H
+#define SPRITEHANDLE_H
+
+#include <QtGlobal>
+
+//! \brief Référence générationnelle vers un sprite d'une scène.
+//!
+//! Un handle est composé de l'indice d'un emplacement de la table des entités de
+//! GameScene et de la génération de cet emplacement au moment où le sprite y a été
+//! rangé. Lorsque le sprite est détruit ou retiré de la scène, la génération de
+//! l'emplacement est incrémentée : un handle qui y fait encore référence est alors
+//! périmé, ce que GameScene::sprite() détecte en comparant les générations.
+//!
+//! Contrairement à un pointeur brut, un handle périmé peut donc être testé sans
+//! risque et sans connexion au signal QObject::destroyed().
+struct SpriteHandle
+{
+    int index = -1;
+    quint32 generation = 0;
+
+    bool isNull() const { return index < 0; }
+    bool operator==(const SpriteHandle& rOther) const { return index == rOther.index && generation == rOther.generation; }
+    bool operator!=(const SpriteHandle& rOther) const { return !(*this == rOther); }
+};
+
+#endif // SPRITEHANDLE_H
@@ -0,0 +1,159 @@
+/**
+  \file
+  \brief    Définition de la classe StaticSprite.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "staticsprite.h"
+
+#include <QDebug>
+#include <QPainter>
+
+#include "gamescene.h"
+#include "sprite.h"
+
+// Initialisation des constantes.
+const qint64 ITEM_PRIVATE_SIZE = 400; // Taille estimée des données privées d'un QGraphicsPixmapItem.
+
+//! Construit un sprite statique sans image.
+//! \param pParent  Pointeur sur le parent (afin d'obtenir une destruction automatique de cet objet).
+StaticSprite::StaticSprite(QGraphicsItem* pParent) : QGraphicsPixmapItem(pParent) {
+    init();
+}
+
+//! Construit un sprite statique qui utilisera l'image fournie pour son apparence.
+//! \param rPixmap   Image à utiliser pour l'apparence du sprite.
+//! \param pParent   Pointeur sur le parent (afin d'obtenir une destruction automatique de cet objet).
+StaticSprite::StaticSprite(const QPixmap& rPixmap, QGraphicsItem* pParent) : QGraphicsPixmapItem(rPixmap, pParent) {
+    init();
+}
+
+//! Destructeur : retire le sprite du registre de sa scène.
+StaticSprite::~StaticSprite() {
+    if (m_pParentScene != nullptr)
+        m_pParentScene->unregisterSprite(this);
+}
+
+//! Mémorise la scène à laquelle appartient ce sprite.
+//! \param pScene  Scène à laquelle appartient ce sprite.
+void StaticSprite::setParentScene(GameScene* pScene) {
+    m_pParentScene = pScene;
+}
+
+//! \return un pointeur sur la scène à laquelle appartient ce sprite.
+GameScene* StaticSprite::parentScene() const {
+    return m_pParentScene;
+}
+
+//! \return vrai si la destruction du sprite a été planifiée (GameScene::destroySpriteLater()).
+bool StaticSprite::isDestroyPending() const {
+    return m_isDestroyPending;
+}
+
+//! Change la catégorie du sprite.
+//! Si le sprite fait déjà partie d'une scène, il y est reclassé.
+//! \param category  Nouvelle catégorie du sprite.
+void StaticSprite::setCategory(Category category) {
+    if (category == m_category)
+        return;
+
+    if (m_pParentScene != nullptr)
+        m_pParentScene->changeSpriteCategory(this, category);
+    else
+        m_category = category;
+}
+
+//! Indique si l'élément graphique donné est un sprite (Sprite ou StaticSprite).
+//! \param pItem  Elément graphique à tester.
+//! \return vrai si l'élément peut être converti en StaticSprite.
+bool StaticSprite::isSpriteItem(const QGraphicsItem* pItem) {
+    return pItem->type() == Sprite::SpriteItemType || pItem->type() == StaticSpriteItemType;
+}
+
+//! \return le nom de la classe du sprite, utilisé pour les relevés de mémoire (voir MemoryMonitor).
+//! Les classes dérivées de StaticSprite qui ne sont pas des QObject doivent la surcharger.
+const char* StaticSprite::spriteClassName() const {
+    return "StaticSprite";
+}
+
+//! \return la taille estimée du sprite en mémoire, en octets, données privées de Qt comprises.
+//! L'image n'est pas comptée : elle est partagée avec le cache d'images (voir AssetLoader).
+qint64 StaticSprite::estimatedSize() const {
+    return sizeof(StaticSprite) + ITEM_PRIVATE_SIZE;
+}
+
+#if defined(DEBUG_BBOX) || defined(DEBUG_SHAPE)
+//! Dessine le sprite, avec sa boundingbox qui l'entoure.
+void StaticSprite::paint(QPainter* pPainter, const QStyleOptionGraphicsItem* pOption, QWidget* pWidget) {
+    QGraphicsPixmapItem::paint(pPainter, pOption, pWidget);
+#ifdef DEBUG_BBOX
+    pPainter->setPen(Qt::white);
+    pPainter->drawRect(this->boundingRect());
+#endif
+#ifdef DEBUG_SHAPE
+    pPainter->setPen(Qt::red);
+    pPainter->drawPath(this->shape());
+#endif
+}
+#endif
+
+//! Construit la liste de tous les sprites en collision avec ce sprite.
+//! Si la scène contient de nombreux sprites, cette méthode peut prendre du temps.
+//! \return une liste de sprites en collision. Si aucun autre sprite ne collisionne
+//! avec ce sprite, la liste retournée est vide.
+QList<StaticSprite*> StaticSprite::collidingSprites() const {
+    QList<StaticSprite*> collidingSpriteList;
+
+    if (m_pParentScene != nullptr) {
+        collidingSpriteList = m_pParentScene->collidingSprites(this);
+    } else {
+        qDebug() << "Le sprite ne fait pas partie d'une scène.";
+    }
+    return collidingSpriteList;
+}
+
+//! Construit la liste de tous les sprites en collision avec le rectangle donné
+//! en paramètre, sauf ce sprite-même.
+//! Si la scène contient de nombreux sprites, cette méthode peut prendre du temps.
+//! \param rRect Rectangle avec lequel il faut tester les collisions.
+//! \return une liste de sprites en collision.
+QList<StaticSprite*> StaticSprite::collidingSprites(const QRectF& rRect) const {
+    QList<StaticSprite*> collidingSpriteList;
+
+    if (m_pParentScene != nullptr) {
+        collidingSpriteList = m_pParentScene->collidingSprites(rRect);
+
+        // Ce sprite lui-même collisionne avec le rectangle donné. Il faut donc l'ignorer.
+        collidingSpriteList.removeAll(const_cast<StaticSprite*>(this));
+    } else {
+        qDebug() << "Le sprite ne fait pas partie d'une scène.";
+    }
+    return collidingSpriteList;
+}
+
+//! Construit la liste de tous les sprites en collision avec la forme donnée
+//! en paramètre, sauf ce sprite-même.
+//! Si la scène contient de nombreux sprites, cette méthode peut prendre du temps.
+//! \param rShape Forme avec laquelle il faut tester les collisions.
+//! \return une liste de sprites en collision.
+QList<StaticSprite*> StaticSprite::collidingSprites(const QPainterPath& rShape) const {
+    QList<StaticSprite*> collidingSpriteList;
+
+    if (m_pParentScene != nullptr) {
+        collidingSpriteList = m_pParentScene->collidingSprites(rShape);
+
+        // Ce sprite lui-même collisionne avec le rectangle donné. Il faut donc l'ignorer.
+        collidingSpriteList.removeAll(const_cast<StaticSprite*>(this));
+    } else {
+        qDebug() << "Le sprite ne fait pas partie d'une scène.";
+    }
+    return collidingSpriteList;
+}
+
+//! Initialise le sprite.
+void StaticSprite::init() {
+    m_pParentScene = nullptr;
+    m_category = CategoryOther;
+    m_categoryIndex = -1;
+    m_isDestroyPending = false;
+}
@@ -0,0 +1,110 @@
+/**
+  \file
+  \brief    Déclaration de la classe StaticSprite.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef STATICSPRITE_H
+#define STATICSPRITE_H
+
+// décommenter pour rendre la boundingbox de tous les sprites visible.
+//#define DEBUG_BBOX
+// décommenter pour rendre la shape de tous les sprites visible.
+//#define DEBUG_SHAPE
+
+#include <QGraphicsPixmapItem>
+#include <QPixmap>
+
+#include "spritehandle.h"
+
+class GameScene;
+
+//! \brief Classe qui représente un élément graphique 2D léger, sans animation ni cadence.
+//!
+//! Contrairement à Sprite, un StaticSprite n'est pas un QObject : il ne possède
+//! ni signaux, ni propriétés animables, ni timer d'animation. Il est destiné aux
+//! éléments nombreux ou immobiles du jeu (briques, murs, icônes de l'interface).
+//!
+//! Il participe néanmoins aux requêtes de collision (GameScene::collidingSprites())
+//! et à l'affichage, exactement comme un Sprite.
+//!
+//! Sprite spécialise cette classe : toutes les méthodes de géométrie (width(),
+//! height(), left(), right(), top(), bottom(), globalBoundingBox(), globalShape())
+//! sont donc communes aux deux types.
+//!
+//! Un StaticSprite ne pouvant pas être détruit avec deleteLater(), sa destruction
+//! différée se fait au moyen de GameScene::destroySpriteLater().
+//!
+//! Chaque sprite appartient à une catégorie (setCategory()). La scène range ses sprites
+//! par catégorie dans des tableaux contigus (GameScene::sprites(Category)), ce qui permet
+//! de parcourir par exemple toutes les briques sans passer par l'index de QGraphicsScene.
+//! Les briques incassables sont rangées avec les murs (CategoryWall).
+//!
+//! Tant qu'il fait partie d'une scène, un sprite possède également un handle (handle()),
+//! qui permet de le retrouver avec GameScene::sprite() tout en détectant qu'il a été détruit.
+class StaticSprite : public QGraphicsPixmapItem
+{
+public:
+    enum Category {
+        CategoryOther,
+        CategoryBrick,
+        CategoryBall,
+        CategoryPlate,
+        CategoryWall,
+        CategoryUI,
+        CategoryCount
+    };
+
+    StaticSprite(QGraphicsItem* pParent = nullptr);
+    StaticSprite(const QPixmap& rPixmap, QGraphicsItem* pParent = nullptr);
+    virtual ~StaticSprite();
+
+    QRectF globalBoundingBox() const { return mapRectToScene(boundingRect());  }
+    QPainterPath globalShape() const { return mapToScene(shape()); }
+    int width() const { return static_cast<int>(globalBoundingBox().width()); }
+    int height() const { return static_cast<int>(globalBoundingBox().height()); }
+    int left() const { return static_cast<int>(globalBoundingBox().left()); }
+    int top() const { return static_cast<int>(globalBoundingBox().top()); }
+    int right() const { return static_cast<int>(globalBoundingBox().right()); }
+    int bottom() const { return static_cast<int>(globalBoundingBox().bottom()); }
+
+    void setParentScene(GameScene* pScene);
+    GameScene* parentScene() const;
+    bool isDestroyPending() const;
+
+    void setCategory(Category category);
+    Category category() const { return m_category; }
+
+    SpriteHandle handle() const { return m_handle; }
+
+    enum { StaticSpriteItemType = UserType + 2 };
+    virtual int type() const { return StaticSpriteItemType; }
+
+    static bool isSpriteItem(const QGraphicsItem* pItem);
+
+    virtual const char* spriteClassName() const;
+    virtual qint64 estimatedSize() const;
+
+#if defined(DEBUG_BBOX) || defined(DEBUG_SHAPE)
+    virtual void paint(QPainter* pPainter, const QStyleOptionGraphicsItem* pOption, QWidget* pWidget = 0);
+#endif
+
+protected:
+    QList<StaticSprite*> collidingSprites() const;
+    QList<StaticSprite*> collidingSprites(const QRectF& rRect) const;
+    QList<StaticSprite*> collidingSprites(const QPainterPath& rShape) const;
+
+    GameScene* m_pParentScene;
+
+private:
+    friend class GameScene;
+
+    void init();
+
+    Category m_category;
+    SpriteHandle m_handle;
+    int m_categoryIndex; // Position dans le tableau de sa catégorie (GameScene), -1 si hors scène.
+    bool m_isDestroyPending;
+};
+
+#endif // STATICSPRITE_H
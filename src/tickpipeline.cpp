@@ -0,0 +1,213 @@
+/**
+  \file
+  \brief    Définition de la classe TickPipeline.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "tickpipeline.h"
+
+#include <QDebug>
+#include <QStringList>
+
+#include "frameprofiler.h"
+
+// Initialisation des constantes.
+const qint64 NS_PER_MS = 1000000;
+const int MAX_SKIPPED_FRAMES = 3;           // Nombre maximal de ticks sautés de suite par une étape non critique.
+const qint64 OVERRUN_LOG_INTERVAL = 1000;   // Intervalle minimal (en ms) entre deux signalements de dépassement.
+
+// Budgets par défaut (en ms), prévus pour un tick de 10 ms.
+const double DEFAULT_BUDGETS[TickPipeline::StageCount] = {
+    0.5,    // StageInput
+    4.0,    // StagePhysics
+    1.5,    // StageGameplay
+    1.0,    // StageAnimation
+    1.0     // StageHud
+};
+
+// Noms des étapes dans les mesures du FrameProfiler (chaînes statiques).
+const char* const PROFILE_STAGE_NAMES[TickPipeline::StageCount] = {
+    "Stage input",
+    "Stage physics",
+    "Stage gameplay",
+    "Stage animation",
+    "Stage hud"
+};
+
+//! Construit un découpage en étapes avec les budgets par défaut.
+TickPipeline::TickPipeline() {
+    for (int i = 0; i < StageCount; ++i)
+        setBudget(Stage(i), DEFAULT_BUDGETS[i]);
+
+    m_isSkippingEnabled = true;
+    m_profileNextFrame = false;
+    m_profileCurrentFrame = false;
+    m_logTimer.start();
+}
+
+//! Change le budget de temps d'une étape.
+//! \param stage                 Etape concernée.
+//! \param budgetInMilliseconds  Durée maximale souhaitée de l'étape, en millisecondes.
+void TickPipeline::setBudget(Stage stage, double budgetInMilliseconds) {
+    m_stages[stage].budgetNs = qint64(budgetInMilliseconds * NS_PER_MS);
+}
+
+//! \return le budget de temps de l'étape donnée, en millisecondes.
+double TickPipeline::budget(Stage stage) const {
+    return double(m_stages[stage].budgetNs) / NS_PER_MS;
+}
+
+//! Active ou désactive le saut des étapes non critiques. Lorsqu'il est désactivé, toutes
+//! les étapes sont traitées à chaque tick, quelle que soit leur durée.
+//! \param isEnabled  Vrai pour que les étapes non critiques puissent être sautées.
+void TickPipeline::setSkippingEnabled(bool isEnabled) {
+    m_isSkippingEnabled = isEnabled;
+}
+
+//! Commence le traitement d'un tick.
+//! \param elapsedTimeInMilliseconds  Temps écoulé depuis le tick précédent.
+void TickPipeline::beginFrame(long long elapsedTimeInMilliseconds) {
+    m_frameTimer.start();
+
+    for (StageState& rStage : m_stages)
+        rStage.pendingTime += elapsedTimeInMilliseconds;
+
+    m_profileCurrentFrame = m_profileNextFrame;
+    m_profileNextFrame = false;
+}
+
+//! Commence une étape. Une étape non critique est sautée si le tick a déjà consommé
+//! le budget des étapes critiques, sauf si elle a été sautée trop de fois de suite ou si
+//! les sauts sont désactivés (voir setSkippingEnabled()).
+//! \param stage  Etape à commencer.
+//! \return vrai si l'étape doit être traitée, faux si elle est sautée pour ce tick
+//! (endStage() ne doit alors pas être appelée).
+bool TickPipeline::beginStage(Stage stage) {
+    StageState& rStage = m_stages[stage];
+
+    if (m_isSkippingEnabled && !isCritical(stage) && rStage.consecutiveSkips < MAX_SKIPPED_FRAMES) {
+        qint64 criticalBudgetNs = 0;
+        for (int i = 0; i < StageCount; ++i) {
+            if (isCritical(Stage(i)))
+                criticalBudgetNs += m_stages[i].budgetNs;
+        }
+
+        if (m_frameTimer.nsecsElapsed() > criticalBudgetNs) {
+            rStage.consecutiveSkips++;
+            rStage.skippedCount++;
+            return false;
+        }
+    }
+
+    m_stageTimer.start();
+    return true;
+}
+
+//! Termine une étape et vérifie qu'elle a respecté son budget.
+//! \param stage  Etape terminée.
+void TickPipeline::endStage(Stage stage) {
+    StageState& rStage = m_stages[stage];
+    rStage.lastDurationNs = m_stageTimer.nsecsElapsed();
+
+    FrameProfiler& rProfiler = FrameProfiler::instance();
+    if (rProfiler.isEnabled())
+        rProfiler.record(PROFILE_STAGE_NAMES[stage], rProfiler.now() - rStage.lastDurationNs, rStage.lastDurationNs);
+    rStage.pendingTime = 0;
+    rStage.consecutiveSkips = 0;
+
+    if (rStage.lastDurationNs > rStage.budgetNs) {
+        rStage.overrunCount++;
+        rStage.worstOverrunNs = qMax(rStage.worstOverrunNs, rStage.lastDurationNs);
+
+        // La répartition par type de sprite est mesurée au tick suivant.
+        if (stage == StagePhysics)
+            m_profileNextFrame = true;
+    }
+}
+
+//! Termine le traitement d'un tick. Les dépassements sont signalés au plus une fois
+//! par seconde.
+void TickPipeline::endFrame() {
+    if (m_logTimer.elapsed() < OVERRUN_LOG_INTERVAL)
+        return;
+
+    for (const StageState& rStage : m_stages) {
+        if (rStage.overrunCount > 0) {
+            logOverruns();
+            break;
+        }
+    }
+    m_logTimer.start();
+}
+
+//! \return le temps écoulé (en ms) depuis le dernier traitement de l'étape donnée, à
+//! transmettre à l'étape. Pour une étape qui n'a pas été sautée, c'est le temps écoulé
+//! depuis le tick précédent.
+long long TickPipeline::stageTime(Stage stage) const {
+    return m_stages[stage].pendingTime;
+}
+
+//! \return la durée (en ms) du dernier traitement de l'étape donnée.
+double TickPipeline::lastDuration(Stage stage) const {
+    return double(m_stages[stage].lastDurationNs) / NS_PER_MS;
+}
+
+//! \return le nombre total de ticks durant lesquels l'étape donnée a été sautée.
+int TickPipeline::skippedCount(Stage stage) const {
+    return m_stages[stage].skippedCount;
+}
+
+//! \return la répartition par type de sprite à remplir durant l'étape physique (voir
+//! GameScene::setTickProfile()), ou nullptr si elle n'est pas mesurée durant ce tick.
+SpriteTypeTickProfile* TickPipeline::spriteTypeProfile() {
+    return m_profileCurrentFrame ? &m_spriteTypeProfile : nullptr;
+}
+
+//! \return le nom de l'étape donnée, pour l'affichage.
+QString TickPipeline::stageName(Stage stage) {
+    switch (stage) {
+    case StageInput:     return "input";
+    case StagePhysics:   return "physics";
+    case StageGameplay:  return "gameplay";
+    case StageAnimation: return "animation";
+    case StageHud:       return "hud";
+    default:             return "?";
+    }
+}
+
+//! \return vrai si l'étape donnée doit être traitée à chaque tick.
+bool TickPipeline::isCritical(Stage stage) {
+    return stage != StageAnimation && stage != StageHud;
+}
+
+//! Signale les dépassements depuis le dernier signalement, puis remet les compteurs à zéro.
+void TickPipeline::logOverruns() {
+    QStringList overruns;
+    for (int i = 0; i < StageCount; ++i) {
+        StageState& rStage = m_stages[i];
+        if (rStage.overrunCount == 0)
+            continue;
+
+        overruns << QString("%1 %2x (pire %3 ms / %4 ms)")
+                    .arg(stageName(Stage(i)))
+                    .arg(rStage.overrunCount)
+                    .arg(double(rStage.worstOverrunNs) / NS_PER_MS, 0, 'f', 2)
+                    .arg(budget(Stage(i)), 0, 'f', 2);
+        rStage.overrunCount = 0;
+        rStage.worstOverrunNs = 0;
+    }
+    qWarning().noquote() << "Dépassement de budget :" << overruns.join(", ");
+
+    if (m_spriteTypeProfile.isEmpty())
+        return;
+
+    QStringList spriteTypes;
+    for (auto it = m_spriteTypeProfile.constBegin(); it != m_spriteTypeProfile.constEnd(); ++it) {
+        spriteTypes << QString("%1 %2 ms (%3 ticks)")
+                       .arg(it.key())
+                       .arg(double(it.value().nanoseconds) / NS_PER_MS, 0, 'f', 2)
+                       .arg(it.value().tickCount);
+    }
+    qWarning().noquote() << "  physics par type de sprite :" << spriteTypes.join(", ");
+    m_spriteTypeProfile.clear();
+}
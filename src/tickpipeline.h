@@ -0,0 +1,93 @@
+/**
+  \file
+  \brief    Déclaration de la classe TickPipeline.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef TICKPIPELINE_H
+#define TICKPIPELINE_H
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include "tickregistry.h"
+
+//! \brief Classe qui découpe le traitement d'un tick en étapes et surveille leur durée.
+//!
+//! Un tick est traité en étapes successives (voir Stage) : entrées, physique (cadence des
+//! sprites), logique de jeu, animation (caméra) et affichage des informations (HUD).
+//! Chaque étape dispose d'un budget de temps (setBudget()). GameCanvas::onTick() encadre
+//! chaque étape par beginStage() et endStage(), et l'ensemble par beginFrame() et endFrame().
+//!
+//! Dépassements : une étape qui dépasse son budget est comptée. Les dépassements sont
+//! signalés au plus une fois par seconde dans la sortie de debug, avec la durée de la
+//! pire occurrence de chaque étape. Lorsque l'étape physique dépasse son budget, le temps
+//! de cadence des sprites est mesuré par type de sprite durant le tick suivant (voir
+//! spriteTypeProfile()), et cette répartition est ajoutée au signalement.
+//!
+//! Etapes non critiques (animation et HUD) : si, au moment de les commencer, le tick a
+//! déjà consommé le budget total des étapes critiques, elles sont sautées. Elles ne le
+//! sont jamais plus de MAX_SKIPPED_FRAMES ticks de suite : leur traitement est ainsi
+//! étalé sur plusieurs ticks. Une étape sautée reçoit, lorsqu'elle est à nouveau
+//! traitée, tout le temps écoulé depuis son dernier traitement (stageTime()).
+//! Ces sauts dépendent de la durée réelle des étapes : ils peuvent être désactivés
+//! (setSkippingEnabled()), afin qu'un tick enregistré soit rejoué à l'identique.
+class TickPipeline
+{
+public:
+    //! Etapes du traitement d'un tick, dans l'ordre de leur traitement.
+    enum Stage {
+        StageInput,
+        StagePhysics,
+        StageGameplay,
+        StageAnimation,
+        StageHud,
+        StageCount
+    };
+
+    TickPipeline();
+
+    void setBudget(Stage stage, double budgetInMilliseconds);
+    double budget(Stage stage) const;
+    void setSkippingEnabled(bool isEnabled);
+
+    void beginFrame(long long elapsedTimeInMilliseconds);
+    bool beginStage(Stage stage);
+    void endStage(Stage stage);
+    void endFrame();
+
+    long long stageTime(Stage stage) const;
+    double lastDuration(Stage stage) const;
+    int skippedCount(Stage stage) const;
+
+    SpriteTypeTickProfile* spriteTypeProfile();
+
+    static QString stageName(Stage stage);
+    static bool isCritical(Stage stage);
+
+private:
+    void logOverruns();
+
+    //! Mesures d'une étape.
+    struct StageState
+    {
+        qint64 budgetNs = 0;        //!< Budget de l'étape.
+        long long pendingTime = 0;  //!< Temps écoulé depuis le dernier traitement (ms).
+        qint64 lastDurationNs = 0;  //!< Durée du dernier traitement.
+        int consecutiveSkips = 0;   //!< Nombre de ticks sautés de suite.
+        int skippedCount = 0;       //!< Nombre total de ticks sautés.
+        int overrunCount = 0;       //!< Dépassements depuis le dernier signalement.
+        qint64 worstOverrunNs = 0;  //!< Pire durée depuis le dernier signalement.
+    };
+
+    StageState m_stages[StageCount];
+    QElapsedTimer m_frameTimer;
+    QElapsedTimer m_stageTimer;
+    QElapsedTimer m_logTimer;
+    bool m_isSkippingEnabled;
+    bool m_profileNextFrame;
+    bool m_profileCurrentFrame;
+    SpriteTypeTickProfile m_spriteTypeProfile;
+};
+
+#endif // TICKPIPELINE_H
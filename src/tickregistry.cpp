@@ -0,0 +1,203 @@
+/**
+  \file
+  \brief    Définition de la classe TickRegistry.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "tickregistry.h"
+
+#include "frameprofiler.h"
+#include "sprite.h"
+
+//! Indice mémorisé par un sprite qui n'est pas abonné à la cadence.
+const int NO_TICK_INDEX = -1;
+//! Intervalle minimal (en ms) entre deux cadences d'un sprite hors de la zone active.
+const long long OFFSCREEN_TICK_INTERVAL = 100;
+//! Durée maximale (en ms) d'un pas de cadence, comme les pas de simulation de GameCanvas.
+const long long MAX_TICK_STEP = 20;
+
+//! Construit une liste de cadence vide.
+TickRegistry::TickRegistry() {
+    m_count = 0;
+    m_isTicking = false;
+    m_hasEmptySlots = false;
+    m_pTypeProfile = nullptr;
+}
+
+//! Destructeur : les sprites encore enregistrés sont désabonnés.
+TickRegistry::~TickRegistry() {
+    clear();
+}
+
+//! Abonne le sprite donné à la cadence.
+//! Si le sprite est déjà abonné, rien ne se passe.
+//! \param pSprite  Sprite à abonner.
+void TickRegistry::add(Sprite* pSprite) {
+    Q_ASSERT(pSprite != nullptr);
+
+    if (pSprite->m_tickIndex != NO_TICK_INDEX)
+        return;
+
+    pSprite->m_tickIndex = m_sprites.count();
+    m_sprites.append(pSprite);
+    m_count++;
+}
+
+//! Désabonne le sprite donné de la cadence.
+//! Hors d'un parcours, le dernier sprite du tableau prend la place du sprite retiré.
+//! Pendant un parcours, l'emplacement est vidé et sera supprimé à la fin de tick().
+//! \param pSprite  Sprite à désabonner.
+void TickRegistry::remove(Sprite* pSprite) {
+    Q_ASSERT(pSprite != nullptr);
+
+    int index = pSprite->m_tickIndex;
+    if (index == NO_TICK_INDEX)
+        return;
+
+    Q_ASSERT(m_sprites[index] == pSprite);
+    pSprite->m_tickIndex = NO_TICK_INDEX;
+    m_count--;
+
+    if (m_isTicking || m_hasEmptySlots) {
+        m_sprites[index] = nullptr;
+        m_hasEmptySlots = true;
+        return;
+    }
+
+    Sprite* pLastSprite = m_sprites.last();
+    m_sprites[index] = pLastSprite;
+    pLastSprite->m_tickIndex = index;
+    m_sprites.removeLast();
+}
+
+//! \return vrai si le sprite donné est abonné à la cadence.
+bool TickRegistry::contains(const Sprite* pSprite) const {
+    return pSprite->m_tickIndex != NO_TICK_INDEX;
+}
+
+//! \return le nombre de sprites abonnés à la cadence.
+int TickRegistry::count() const {
+    return m_count;
+}
+
+//! Désabonne tous les sprites.
+void TickRegistry::clear() {
+    for (Sprite* pSprite : m_sprites) {
+        if (pSprite)
+            pSprite->m_tickIndex = NO_TICK_INDEX;
+    }
+    m_sprites.clear();
+    m_count = 0;
+    m_hasEmptySlots = false;
+}
+
+//! Cadence : appelle Sprite::tick() pour chaque sprite abonné.
+//! Les sprites ajoutés durant le parcours ne sont pas cadencés avant le tick suivant,
+//! ceux qui sont retirés durant le parcours ne sont plus cadencés.
+//! \param elapsedTimeInMilliseconds  Temps écoulé depuis le tick précédent.
+void TickRegistry::tick(long long elapsedTimeInMilliseconds) {
+    m_isTicking = true;
+
+    const int spriteCount = m_sprites.count();
+    for (int i = 0; i < spriteCount; ++i) {
+        Sprite* pSprite = m_sprites[i];
+        if (pSprite)
+            tickSprite(pSprite, elapsedTimeInMilliseconds);
+    }
+
+    m_isTicking = false;
+
+    if (m_hasEmptySlots)
+        compact();
+}
+
+//! Cadence avec zone active : les sprites qui touchent la zone donnée, ainsi que les balles,
+//! sont cadencés normalement. Les autres accumulent le temps écoulé et ne sont cadencés
+//! qu'une fois OFFSCREEN_TICK_INTERVAL atteint : le temps accumulé leur est alors transmis
+//! en pas d'au plus MAX_TICK_STEP ms, afin que leurs collisions restent détectées.
+//! \param elapsedTimeInMilliseconds  Temps écoulé depuis le tick précédent.
+//! \param rActiveRect                Zone active, en coordonnées de la scène.
+void TickRegistry::tick(long long elapsedTimeInMilliseconds, const QRectF& rActiveRect) {
+    m_isTicking = true;
+
+    const int spriteCount = m_sprites.count();
+    for (int i = 0; i < spriteCount; ++i) {
+        Sprite* pSprite = m_sprites[i];
+        if (!pSprite)
+            continue;
+
+        // Une balle est toujours cadencée normalement : un pas trop long lui ferait
+        // traverser une brique sans la toucher.
+        const bool isDeferrable = pSprite->category() != StaticSprite::CategoryBall
+                                  && !pSprite->globalBoundingBox().intersects(rActiveRect);
+
+        const long long tickTime = pSprite->m_deferredTickTime + elapsedTimeInMilliseconds;
+        if (isDeferrable && tickTime < OFFSCREEN_TICK_INTERVAL) {
+            pSprite->m_deferredTickTime = tickTime;
+            continue;
+        }
+
+        pSprite->m_deferredTickTime = 0;
+
+        // Le temps accumulé est découpé en pas de durée limitée. Le découpage s'arrête si le
+        // sprite se désabonne de la cadence durant l'un des pas.
+        const long long stepCount = qMax(1LL, (tickTime + MAX_TICK_STEP - 1) / MAX_TICK_STEP);
+        for (long long step = 0; step < stepCount && m_sprites[i] == pSprite; ++step) {
+            const long long stepStart = tickTime * step / stepCount;
+            tickSprite(pSprite, tickTime * (step + 1) / stepCount - stepStart);
+        }
+    }
+
+    m_isTicking = false;
+
+    if (m_hasEmptySlots)
+        compact();
+}
+
+//! Définit la répartition par type de sprite dans laquelle la durée de la cadence de
+//! chaque sprite est cumulée.
+//! \param pProfile  Répartition à compléter, ou nullptr pour ne pas mesurer la cadence.
+void TickRegistry::setTypeProfile(SpriteTypeTickProfile* pProfile) {
+    m_pTypeProfile = pProfile;
+}
+
+//! Cadence un sprite. Si une répartition est définie, ou si le FrameProfiler est activé,
+//! la durée de sa cadence y est enregistrée sous le nom de sa classe.
+//! \param pSprite                    Sprite à cadencer.
+//! \param elapsedTimeInMilliseconds  Temps à transmettre au sprite.
+void TickRegistry::tickSprite(Sprite* pSprite, long long elapsedTimeInMilliseconds) {
+    FrameProfiler& rProfiler = FrameProfiler::instance();
+    if (!m_pTypeProfile && !rProfiler.isEnabled()) {
+        pSprite->tick(elapsedTimeInMilliseconds);
+        return;
+    }
+
+    const char* typeName = pSprite->metaObject()->className();
+    const qint64 tickStart = rProfiler.now();
+    pSprite->tick(elapsedTimeInMilliseconds);
+    const qint64 tickDuration = rProfiler.now() - tickStart;
+
+    if (rProfiler.isEnabled())
+        rProfiler.record(typeName, tickStart, tickDuration);
+
+    if (m_pTypeProfile) {
+        SpriteTypeTickTime& rTime = (*m_pTypeProfile)[typeName];
+        rTime.nanoseconds += tickDuration;
+        rTime.tickCount++;
+    }
+}
+
+//! Supprime les emplacements vidés durant le parcours, en conservant
+//! l'ordre des sprites, et met à jour l'indice mémorisé par chaque sprite.
+void TickRegistry::compact() {
+    int destination = 0;
+    for (int source = 0; source < m_sprites.count(); ++source) {
+        Sprite* pSprite = m_sprites[source];
+        if (pSprite) {
+            pSprite->m_tickIndex = destination;
+            m_sprites[destination++] = pSprite;
+        }
+    }
+    m_sprites.resize(destination);
+    m_hasEmptySlots = false;
+}
@@ -0,0 +1,73 @@
+/**
+  \file
+  \brief    Déclaration de la classe TickRegistry.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef TICKREGISTRY_H
+#define TICKREGISTRY_H
+
+#include <QHash>
+#include <QRectF>
+#include <QVector>
+
+class Sprite;
+
+//! Temps de cadence cumulé des sprites d'un même type (voir TickRegistry::setTypeProfile()).
+struct SpriteTypeTickTime
+{
+    qint64 nanoseconds = 0; //!< Durée cumulée des appels à Sprite::tick().
+    int tickCount = 0;      //!< Nombre d'appels à Sprite::tick().
+};
+
+//! Temps de cadence par type de sprite, indexé par nom de classe (QMetaObject::className()).
+typedef QHash<const char*, SpriteTypeTickTime> SpriteTypeTickProfile;
+
+//! \brief Liste des sprites abonnés à la cadence.
+//!
+//! Chaque sprite enregistré mémorise sa position dans le tableau (Sprite::m_tickIndex),
+//! ce qui permet un ajout (add()) et un retrait (remove()) en temps constant :
+//! le retrait remplace l'emplacement libéré par le dernier sprite du tableau.
+//!
+//! Pendant le parcours effectué par tick(), un retrait ne déplace aucun sprite : l'emplacement
+//! est simplement vidé, et le tableau est compacté une fois le parcours terminé. Un sprite
+//! ajouté pendant le parcours ne reçoit la cadence qu'à partir du tick suivant.
+//! Il n'est donc plus nécessaire de copier la liste à chaque tick.
+//!
+//! tick() peut recevoir une zone active (la zone montrée par la caméra) : les sprites en
+//! dehors de cette zone, sauf les balles, ne sont cadencés que toutes les
+//! OFFSCREEN_TICK_INTERVAL ms environ, avec le temps accumulé depuis leur dernière cadence
+//! (Sprite::m_deferredTickTime), découpé en pas courts.
+//!
+//! Si une répartition est fournie avec setTypeProfile(), la durée de la cadence de chaque
+//! sprite y est cumulée selon son type. Cette mesure a un coût, elle n'est donc faite
+//! que sur demande (voir TickPipeline).
+class TickRegistry
+{
+public:
+    TickRegistry();
+    ~TickRegistry();
+
+    void add(Sprite* pSprite);
+    void remove(Sprite* pSprite);
+    bool contains(const Sprite* pSprite) const;
+    int count() const;
+    void clear();
+
+    void tick(long long elapsedTimeInMilliseconds);
+    void tick(long long elapsedTimeInMilliseconds, const QRectF& rActiveRect);
+
+    void setTypeProfile(SpriteTypeTickProfile* pProfile);
+
+private:
+    void tickSprite(Sprite* pSprite, long long elapsedTimeInMilliseconds);
+    void compact();
+
+    QVector<Sprite*> m_sprites;
+    int m_count;
+    bool m_isTicking;
+    bool m_hasEmptySlots;
+    SpriteTypeTickProfile* m_pTypeProfile;
+};
+
+#endif // TICKREGISTRY_H
@@ -0,0 +1,214 @@
+/**
+  \file
+  \brief    Définition de la classe TraceWriter.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#include "tracewriter.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+
+#include "frameprofiler.h"
+
+// Initialisation des constantes.
+const int MAX_PENDING_EVENTS = 16384;   // Taille maximale de la file d'attente.
+const double NS_PER_US = 1000.0;        // Les horodatages de la trace sont en microsecondes.
+
+QAtomicPointer<TraceWriter> TraceWriter::s_pInstance;
+
+// Identifiant, dans la trace, du thread courant (0 tant qu'il n'a produit aucun événement).
+static thread_local int s_traceThreadId = 0;
+
+//! Remplace les caractères qui ne peuvent pas figurer tels quels dans une chaîne JSON.
+//! \param rText  Texte à protéger.
+//! \return le texte protégé, encodé en UTF-8.
+static QByteArray jsonEscaped(const QString& rText) {
+    QByteArray escaped;
+    for (char c : rText.toUtf8()) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+            escaped += c;
+        } else if (static_cast<unsigned char>(c) >= 0x20) {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+//! Construit un écrivain fermé.
+//! \param pParent  Objet parent.
+TraceWriter::TraceWriter(QObject* pParent) : QThread(pParent) {
+    m_isFirstEvent = true;
+    m_isStopping = false;
+    m_droppedEventCount = 0;
+    m_nextThreadId = 1;
+}
+
+//! Destructeur : les événements en attente sont écrits et le fichier est fermé.
+TraceWriter::~TraceWriter() {
+    close();
+}
+
+//! \return l'écrivain de la trace en cours, ou nullptr si aucune trace n'est écrite.
+TraceWriter* TraceWriter::instance() {
+    return s_pInstance.loadAcquire();
+}
+
+//! Crée le fichier de la trace et démarre le thread d'écriture. L'écrivain devient
+//! l'instance retournée par instance() et reçoit les événements du FrameProfiler.
+//! \param rFileName  Nom du fichier à créer.
+//! \return faux si le fichier n'a pas pu être créé.
+bool TraceWriter::open(const QString& rFileName) {
+    m_file.setFileName(rFileName);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "Impossible de créer la trace" << rFileName << ":" << m_file.errorString();
+        return false;
+    }
+
+    m_file.write("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    m_isFirstEvent = true;
+    m_isStopping = false;
+    start(QThread::LowPriority);
+
+    s_pInstance.storeRelease(this);
+    FrameProfiler::instance().setTraceWriter(this);
+    qDebug() << "Trace écrite dans" << rFileName;
+    return true;
+}
+
+//! Arrête le thread d'écriture après qu'il a écrit les événements en attente, puis ferme
+//! le fichier.
+void TraceWriter::close() {
+    if (!m_file.isOpen())
+        return;
+
+    FrameProfiler::instance().setTraceWriter(nullptr);
+    s_pInstance.testAndSetOrdered(this, nullptr);
+
+    m_mutex.lock();
+    m_isStopping = true;
+    m_eventsAvailable.wakeOne();
+    m_mutex.unlock();
+    wait();
+
+    m_file.write("\n]}\n");
+    m_file.close();
+
+    if (m_droppedEventCount > 0)
+        qWarning() << "Trace :" << m_droppedEventCount << "événements perdus (file d'attente pleine)";
+}
+
+//! Ajoute un événement qui a une durée.
+//! \param name      Nom de l'événement (chaîne statique).
+//! \param category  Catégorie de l'événement (chaîne statique).
+//! \param start     Début de l'événement, en ns (voir FrameProfiler::now()).
+//! \param duration  Durée de l'événement, en ns.
+//! \param rDetail   Information complémentaire, affichée avec l'événement.
+void TraceWriter::addCompleteEvent(const char* name, const char* category, qint64 start, qint64 duration,
+                                   const QString& rDetail) {
+    Event event = { name, category, 'X', 0, start, duration, rDetail };
+    addEvent(event);
+}
+
+//! Ajoute un événement instantané.
+//! \param name       Nom de l'événement (chaîne statique).
+//! \param category   Catégorie de l'événement (chaîne statique).
+//! \param timestamp  Heure de l'événement, en ns (voir FrameProfiler::now()).
+//! \param rDetail    Information complémentaire, affichée avec l'événement.
+void TraceWriter::addInstantEvent(const char* name, const char* category, qint64 timestamp,
+                                  const QString& rDetail) {
+    Event event = { name, category, 'i', 0, timestamp, 0, rDetail };
+    addEvent(event);
+}
+
+//! \return le nombre d'événements perdus parce que la file d'attente était pleine.
+long long TraceWriter::droppedEventCount() const {
+    QMutexLocker locker(&m_mutex);
+    return m_droppedEventCount;
+}
+
+//! Place un événement dans la file d'attente. Le premier événement d'un thread est
+//! précédé du nom de ce thread.
+//! \param rEvent  Evénement à ajouter ; son identifiant de thread est complété.
+void TraceWriter::addEvent(Event& rEvent) {
+    QMutexLocker locker(&m_mutex);
+    if (m_isStopping)
+        return;
+
+    if (s_traceThreadId == 0) {
+        s_traceThreadId = m_nextThreadId++;
+
+        QString threadName = QThread::currentThread()->objectName();
+        if (QCoreApplication::instance() && QThread::currentThread() == QCoreApplication::instance()->thread())
+            threadName = "Thread principal";
+        else if (threadName.isEmpty())
+            threadName = QString("Thread %1").arg(s_traceThreadId);
+
+        Event threadNameEvent = { "thread_name", "", 'M', s_traceThreadId, 0, 0, threadName };
+        m_pendingEvents.append(threadNameEvent);
+    }
+
+    if (m_pendingEvents.count() >= MAX_PENDING_EVENTS) {
+        m_droppedEventCount++;
+        return;
+    }
+
+    rEvent.threadId = s_traceThreadId;
+    m_pendingEvents.append(rEvent);
+    m_eventsAvailable.wakeOne();
+}
+
+//! Boucle du thread d'écriture : attend des événements, les retire de la file d'attente
+//! par lots et les écrit, jusqu'à l'arrêt demandé par close().
+void TraceWriter::run() {
+    QVector<Event> events;
+
+    forever {
+        m_mutex.lock();
+        while (m_pendingEvents.isEmpty() && !m_isStopping)
+            m_eventsAvailable.wait(&m_mutex);
+
+        const bool isStopping = m_isStopping;
+        events.swap(m_pendingEvents);
+        m_mutex.unlock();
+
+        for (const Event& rEvent : events)
+            writeEvent(rEvent);
+        events.clear();
+
+        if (isStopping)
+            break;
+    }
+
+    m_file.flush();
+}
+
+//! Ecrit un événement dans le fichier, sur une ligne.
+//! \param rEvent  Evénement à écrire.
+void TraceWriter::writeEvent(const Event& rEvent) {
+    QByteArray line = m_isFirstEvent ? "{" : ",\n{";
+    m_isFirstEvent = false;
+
+    line += "\"name\":\"" + QByteArray(rEvent.name) + "\",\"ph\":\"" + rEvent.phase
+            + "\",\"pid\":1,\"tid\":" + QByteArray::number(rEvent.threadId);
+
+    if (rEvent.phase == 'M') {
+        line += ",\"args\":{\"name\":\"" + jsonEscaped(rEvent.detail) + "\"}}";
+        m_file.write(line);
+        return;
+    }
+
+    line += ",\"cat\":\"" + QByteArray(rEvent.category) + "\",\"ts\":"
+            + QByteArray::number(rEvent.start / NS_PER_US, 'f', 3);
+    if (rEvent.phase == 'X')
+        line += ",\"dur\":" + QByteArray::number(rEvent.duration / NS_PER_US, 'f', 3);
+    else
+        line += ",\"s\":\"g\"";
+
+    if (!rEvent.detail.isEmpty())
+        line += ",\"args\":{\"detail\":\"" + jsonEscaped(rEvent.detail) + "\"}";
+
+    line += "}";
+    m_file.write(line);
+}
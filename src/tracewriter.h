@@ -0,0 +1,90 @@
+/**
+  \file
+  \brief    Déclaration de la classe TraceWriter.
+  \author   CHENGAE
+  \date     Décembre 2021
+*/
+#ifndef TRACEWRITER_H
+#define TRACEWRITER_H
+
+#include <QAtomicPointer>
+#include <QFile>
+#include <QMutex>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+//! \brief Classe qui écrit une trace de l'exécution du jeu au format « Chrome trace event ».
+//!
+//! Le fichier produit (option `--trace <fichier>`) peut être ouvert dans Perfetto
+//! (https://ui.perfetto.dev) ou dans `chrome://tracing`, afin de retrouver les images
+//! dont une étape du tick ou le dessin de la scène a été anormalement long.
+//!
+//! La trace contient :
+//! - les événements du FrameProfiler : chaque image, les étapes du tick (TickPipeline),
+//!   les marqueurs ProfileScope (GameScene::tick, dessin de GameView...) et la cadence de
+//!   chaque type de sprite. Ils sont transmis par FrameProfiler::beginFrame() ;
+//! - le décodage des images (AssetLoader), sur les threads où il est fait ;
+//! - les changements de scène (GameCanvas::setCurrentScene()).
+//!
+//! Les événements peuvent être ajoutés depuis n'importe quel thread. Ils sont placés dans
+//! une file d'attente bornée, puis écrits sur le disque par le thread de l'écrivain. Si
+//! le disque ne suit pas et que la file est pleine, les événements sont perdus (et
+//! comptés) plutôt que de ralentir le jeu.
+//!
+//! Les horodatages sont ceux de FrameProfiler::now(), en nanosecondes.
+//!
+//! L'écrivain ouvert est accessible avec instance(), qui retourne nullptr si aucune trace
+//! n'est écrite.
+class TraceWriter : public QThread
+{
+public:
+    explicit TraceWriter(QObject* pParent = nullptr);
+    ~TraceWriter();
+
+    static TraceWriter* instance();
+
+    bool open(const QString& rFileName);
+    void close();
+
+    void addCompleteEvent(const char* name, const char* category, qint64 start, qint64 duration,
+                          const QString& rDetail = QString());
+    void addInstantEvent(const char* name, const char* category, qint64 timestamp,
+                         const QString& rDetail = QString());
+
+    long long droppedEventCount() const;
+
+protected:
+    void run();
+
+private:
+    //! Evénement en attente d'écriture.
+    struct Event
+    {
+        const char* name;       // Nom de l'événement (chaîne statique).
+        const char* category;   // Catégorie de l'événement (chaîne statique).
+        char phase;             // 'X' : durée, 'i' : instantané, 'M' : nom d'un thread.
+        int threadId;
+        qint64 start;           // ns
+        qint64 duration;        // ns
+        QString detail;         // Information complémentaire (nom d'une image...), facultative.
+    };
+
+    void addEvent(Event& rEvent);
+    void writeEvent(const Event& rEvent);
+
+    static QAtomicPointer<TraceWriter> s_pInstance;
+
+    QFile m_file;
+    bool m_isFirstEvent;
+
+    mutable QMutex m_mutex;
+    QWaitCondition m_eventsAvailable;
+    QVector<Event> m_pendingEvents;     // Protégé par m_mutex.
+    bool m_isStopping;                  // Protégé par m_mutex.
+    long long m_droppedEventCount;      // Protégé par m_mutex.
+    int m_nextThreadId;                 // Protégé par m_mutex.
+};
+
+#endif // TRACEWRITER_H
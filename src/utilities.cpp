@@ -8,6 +8,7 @@
 
 #include <QApplication>
 #include <QDesktopWidget>
+#include <QElapsedTimer>
 #include <QScreen>
 
 namespace BrickBreaker {
@@ -36,4 +37,13 @@ namespace BrickBreaker {
     void showMouseCursor() {
         qApp->restoreOverrideCursor();
     }
+
+    //! \return le temps écoulé, en millisecondes, depuis le premier appel de cette
+    //! fonction, qui est fait au démarrage de l'application (main()).
+    qint64 elapsedSinceStartup() {
+        static QElapsedTimer s_startupTimer;
+        if (!s_startupTimer.isValid())
+            s_startupTimer.start();
+        return s_startupTimer.elapsed();
+    }
 }
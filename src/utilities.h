@@ -9,6 +9,7 @@
 #define UTILITIES_H
 
 #include <QSize>
+#include <QtGlobal>
 
 //!
 //! Espace de noms contenant les fonctions utilitaires.
@@ -20,5 +21,7 @@ namespace BrickBreaker {
     void hideMouseCursor();
     void showMouseCursor();
 
+    qint64 elapsedSinceStartup();
+
 }
 #endif // UTILITIES_H